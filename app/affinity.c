@@ -0,0 +1,98 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include "affinity.h"
+
+int cpuListParse(const char *list, int *cpus, int max) {
+    int count = 0;
+    const char *p = list;
+    while(*p) {
+        char *end;
+        long first = strtol(p, &end, 10);
+        if(end == p || first < 0 || first >= CPU_SETSIZE) return -1;
+        long last = first;
+        if(*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if(end == p || last < first || last >= CPU_SETSIZE) return -1;
+        }
+        for(long cpu = first; cpu <= last; cpu++) {
+            if(count == max) return -1;
+            cpus[count++] = cpu;
+        }
+        if(*end == ',') end++;
+        else if(*end != '\0') return -1;
+        p = end;
+    }
+    return count;
+}
+
+int cpuNode(int cpu) {
+    // /sys/devices/system/cpu/cpuN tem um link "nodeM" para o nó da CPU
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR *dir = opendir(path);
+    if(dir == NULL) return 0;
+    int node = 0;
+    struct dirent *entry;
+    while((entry = readdir(dir)) != NULL) {
+        if(strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+int placeWriters(const int *cpus, int count, int policy, int *writerCpus) {
+    if(count == 1) {
+        writerCpus[0] = cpus[0];
+        return 1;
+    }
+    int placed = 0;
+    if(policy == PLACEMENT_LOCAL) {
+        int loopNode = cpuNode(cpus[0]);
+        for(int i = 1; i < count; i++)
+            if(cpuNode(cpus[i]) == loopNode) writerCpus[placed++] = cpus[i];
+        if(placed > 0) return placed;
+        // nenhuma outra CPU no nó do laço: usa as que foram dadas
+    }
+    else {
+        // rodada r: a r-ésima CPU de cada nó, para que escritoras vizinhas caiam em nós diferentes
+        int nodes[AFFINITY_MAX_CPUS];
+        for(int i = 1; i < count; i++) nodes[i] = cpuNode(cpus[i]);
+        for(int round = 0; placed < count - 1; round++) {
+            for(int i = 1; i < count; i++) {
+                int first = 1, rank = 0; // i é a primeira CPU do seu nó? qual a posição dela no nó?
+                for(int j = 1; j < i; j++)
+                    if(nodes[j] == nodes[i]) {
+                        first = 0;
+                        break;
+                    }
+                if(!first) continue;
+                for(int j = i; j < count; j++) {
+                    if(nodes[j] != nodes[i]) continue;
+                    if(rank++ == round) {
+                        writerCpus[placed++] = cpus[j];
+                        break;
+                    }
+                }
+            }
+        }
+        return placed;
+    }
+    for(int i = 1; i < count; i++) writerCpus[placed++] = cpus[i];
+    return placed;
+}
+
+int pinCurrentThread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 ? 0 : -1;
+}
@@ -0,0 +1,24 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+// posicionamento das threads do servidor (--cpus, --placement). O laço de
+// eventos fica na primeira CPU da lista e as threads escritoras nas demais.
+// Os buffers dos lotes são alocados e preenchidos (recv) pelo laço, então o
+// kernel os coloca no nó NUMA do laço (first touch): com PLACEMENT_LOCAL as
+// escritoras ficam nesse mesmo nó e leem memória local; PLACEMENT_SPREAD
+// alterna entre os nós, para comparar o custo do acesso remoto.
+#define AFFINITY_MAX_CPUS 256
+
+enum { PLACEMENT_LOCAL, PLACEMENT_SPREAD };
+
+// "0,2,4-7" -> CPUs em ordem. Retorna quantas, ou -1 se a lista é malformada
+int cpuListParse(const char *list, int *cpus, int max);
+// nó NUMA da CPU (0 se o sistema não informa, como em máquinas sem NUMA)
+int cpuNode(int cpu);
+// escolhe as CPUs das escritoras a partir da lista de --cpus (cpus[0] é a do
+// laço, usada também pelas escritoras se for a única). Retorna quantas
+int placeWriters(const int *cpus, int count, int policy, int *writerCpus);
+// fixa a thread que chama na CPU
+int pinCurrentThread(int cpu);
+
+#endif
@@ -0,0 +1,256 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include "batch.h"
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wakeup = PTHREAD_COND_INITIALIZER;
+// lotes com arquivos ainda não pegos por nenhuma thread (FIFO)
+static struct batch *queueHead = NULL, *queueTail = NULL;
+// lotes terminados, esperando o laço de eventos responder
+static struct batch *completed = NULL;
+static unsigned inFlight = 0;
+static int doneFd = -1;
+
+// mesmo esquema do upload de uma mensagem: arquivo temporário + rename,
+// então um arquivo existente nunca fica pela metade
+static int writeEntry(struct batchEntry *entry) {
+    char tmpName[] = ".upload-XXXXXX";
+    int fd = mkstemp(tmpName);
+    if(fd < 0) return BATCH_FAILED;
+    fchmod(fd, 0644); // mkstemp cria com 0600
+
+    const char *p = entry->data;
+    size_t len = entry->size;
+    int failed = 0;
+    while(len > 0) {
+        ssize_t count = write(fd, p, len);
+        if(count < 0) {
+            if(errno == EINTR) continue;
+            failed = 1;
+            break;
+        }
+        p += count;
+        len -= count;
+    }
+    if(close(fd) != 0) failed = 1;
+
+    int overwritten = access(entry->name, F_OK) == 0;
+    if(!failed && rename(tmpName, entry->name) != 0) failed = 1;
+    if(failed) {
+        unlink(tmpName);
+        return BATCH_FAILED;
+    }
+    return overwritten ? BATCH_OVERWRITTEN : BATCH_RECEIVED;
+}
+
+// avança para o próximo arquivo que uma thread deve pegar: pula os que já falharam
+// e os repetidos, que vão junto com a primeira entrada de mesmo nome (com o mutex)
+static void skipTaken(struct batch *batch) {
+    while(batch->nextEntry < batch->count && (batch->entries[batch->nextEntry].status == BATCH_FAILED ||
+                                              batch->entries[batch->nextEntry].chained))
+        batch->nextEntry++;
+}
+
+// avisa o laço de eventos que o lote terminou (com o mutex)
+static void batchFinished(struct batch *batch) {
+    batch->next = completed;
+    completed = batch;
+    uint64_t one = 1;
+    if(write(doneFd, &one, sizeof(one)) != sizeof(one)) perror("eventfd write failed");
+}
+
+// cada thread pega um arquivo por vez do lote mais antigo, então um lote
+// grande é dividido entre todas e lotes de conexões diferentes não se bloqueiam
+static void *writerThread(void *arg) {
+    while(1) {
+        pthread_mutex_lock(&lock);
+        while(queueHead == NULL) pthread_cond_wait(&wakeup, &lock);
+        struct batch *batch = queueHead;
+        struct batchEntry *entry = &batch->entries[batch->nextEntry++];
+        skipTaken(batch);
+        if(batch->nextEntry == batch->count) {
+            queueHead = batch->next;
+            if(queueHead == NULL) queueTail = NULL;
+        }
+        pthread_mutex_unlock(&lock);
+
+        unsigned written = 0;
+        for(; entry != NULL; entry = entry->nextSame, written++) entry->status = writeEntry(entry);
+
+        pthread_mutex_lock(&lock);
+        batch->done += written;
+        if(batch->done == batch->queued) batchFinished(batch);
+        pthread_mutex_unlock(&lock);
+    }
+    return NULL;
+}
+
+int batchPoolStart(unsigned writers, const int *cpus, unsigned ncpus) {
+    doneFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(doneFd < 0) return -1;
+    for(unsigned i = 0; i < writers; i++) {
+        // a afinidade vai nos atributos: a thread já começa na CPU certa e a
+        // pilha dela é tocada pela primeira vez (e alocada) no nó dessa CPU
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if(ncpus > 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[i % ncpus], &set);
+            pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        }
+        pthread_t thread;
+        int failed = pthread_create(&thread, &attr, writerThread, NULL) != 0;
+        pthread_attr_destroy(&attr);
+        if(failed) return -1;
+    }
+    return doneFd;
+}
+
+struct batch *batchCreate(unsigned count, size_t indexSize, size_t dataSize, const char **error) {
+    if(count == 0 || count > BATCH_MAX_FILES) {
+        *error = "invalid file count";
+        return NULL;
+    }
+    if(indexSize == 0 || indexSize > BATCH_MAX_BYTES || dataSize > BATCH_MAX_BYTES - indexSize) {
+        *error = "batch too large";
+        return NULL;
+    }
+    struct batch *batch = calloc(1, sizeof(*batch));
+    if(batch) batch->data = malloc(indexSize + dataSize);
+    if(batch) batch->entries = calloc(count, sizeof(*batch->entries));
+    if(batch == NULL || batch->data == NULL || batch->entries == NULL) {
+        *error = "out of memory";
+        if(batch) batchFree(batch);
+        return NULL;
+    }
+    batch->count = count;
+    batch->indexSize = indexSize;
+    batch->size = indexSize + dataSize;
+    return batch;
+}
+
+// ordena por nome e, entre nomes iguais, pela posição no índice
+static int entryCompare(const void *a, const void *b) {
+    const struct batchEntry *x = *(const struct batchEntry * const *)a, *y = *(const struct batchEntry * const *)b;
+    int cmp = strcmp(x->name, y->name);
+    if(cmp != 0) return cmp;
+    return x < y ? -1 : x > y;
+}
+
+// encadeia as entradas de mesmo nome: duas threads escrevendo o mesmo arquivo
+// disputariam o rename e o conteúdo final não seria o da última entrada
+static int chainDuplicates(struct batch *batch) {
+    struct batchEntry **sorted = malloc(batch->count * sizeof(*sorted));
+    if(sorted == NULL) return -1;
+    for(unsigned i = 0; i < batch->count; i++) sorted[i] = &batch->entries[i];
+    qsort(sorted, batch->count, sizeof(*sorted), entryCompare);
+    for(unsigned i = 1; i < batch->count; i++) {
+        if(strcmp(sorted[i - 1]->name, sorted[i]->name) != 0) continue;
+        sorted[i - 1]->nextSame = sorted[i];
+        sorted[i]->chained = 1;
+    }
+    free(sorted);
+    return 0;
+}
+
+int batchParse(struct batch *batch, int (*validName)(const char *), const char **error) {
+    const char *p = batch->data, *indexEnd = batch->data + batch->indexSize;
+    const char *data = indexEnd;
+    size_t dataLeft = batch->size - batch->indexSize;
+
+    for(unsigned i = 0; i < batch->count; i++) {
+        struct batchEntry *entry = &batch->entries[i];
+        const char *newline = memchr(p, '\n', indexEnd - p);
+        const char *space = newline ? memchr(p, ' ', newline - p) : NULL;
+        if(space == NULL || space == p || newline - space - 1 >= UPLOAD_NAME_MAX) {
+            *error = "malformed batch index";
+            return -1;
+        }
+        size_t size = 0;
+        for(const char *c = p; c < space; c++) {
+            if(*c < '0' || *c > '9' || size > dataLeft) {
+                *error = "malformed batch index";
+                return -1;
+            }
+            size = size * 10 + (*c - '0');
+        }
+        if(size > dataLeft) {
+            *error = "batch index does not match data";
+            return -1;
+        }
+        memcpy(entry->name, space + 1, newline - space - 1);
+        entry->name[newline - space - 1] = '\0';
+        entry->data = data;
+        entry->size = size;
+        // nome inválido só falha este arquivo; o resto do lote segue
+        entry->status = validName(entry->name) ? BATCH_RECEIVED : BATCH_FAILED;
+        data += size;
+        dataLeft -= size;
+        p = newline + 1;
+    }
+    if(p != indexEnd || dataLeft != 0) {
+        *error = "batch index does not match data";
+        return -1;
+    }
+    if(chainDuplicates(batch) != 0) {
+        *error = "out of memory";
+        return -1;
+    }
+    return 0;
+}
+
+void batchSubmit(struct batch *batch) {
+    pthread_mutex_lock(&lock);
+    inFlight++;
+    batch->next = NULL;
+    batch->nextEntry = 0;
+    batch->done = 0;
+    // arquivos com nome inválido já estão decididos: só os válidos vão para as threads
+    batch->queued = 0;
+    for(unsigned i = 0; i < batch->count; i++)
+        if(batch->entries[i].status != BATCH_FAILED) batch->queued++;
+    skipTaken(batch);
+    if(batch->queued == 0) batchFinished(batch);
+    else {
+        if(queueTail) queueTail->next = batch;
+        else queueHead = batch;
+        queueTail = batch;
+        pthread_cond_broadcast(&wakeup);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+struct batch *batchCompleted(void) {
+    pthread_mutex_lock(&lock);
+    struct batch *batch = completed;
+    if(batch) {
+        completed = batch->next;
+        inFlight--;
+    }
+    pthread_mutex_unlock(&lock);
+    return batch;
+}
+
+unsigned batchInFlight(void) {
+    pthread_mutex_lock(&lock);
+    unsigned count = inFlight;
+    pthread_mutex_unlock(&lock);
+    return count;
+}
+
+void batchFree(struct batch *batch) {
+    free(batch->entries);
+    free(batch->data);
+    free(batch);
+}
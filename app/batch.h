@@ -0,0 +1,57 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+#include "upload.h"
+
+// lote de arquivos pequenos enviados em um único quadro, para não pagar uma
+// ida e volta e um ciclo recv/parse/fopen/fclose por arquivo:
+//   "batch <arquivos> <bytes do índice> <bytes dos dados>\end" + '\0'
+//   índice: uma linha "<tamanho> <nome>\n" por arquivo
+//   dados: o conteúdo dos arquivos concatenado, na ordem do índice
+// O laço de eventos só recebe o quadro; um pool de threads escreve os arquivos
+// e avisa o laço por um eventfd quando o lote inteiro termina.
+#define BATCH_MAX_FILES 4096
+#define BATCH_MAX_BYTES (64 << 20)
+#define BATCH_DEFAULT_WRITERS 4
+
+struct batchEntry {
+    char name[UPLOAD_NAME_MAX];
+    const char *data;
+    size_t size;
+    int status; // BATCH_RECEIVED, BATCH_OVERWRITTEN ou BATCH_FAILED
+    // nomes repetidos no índice: a primeira entrada leva as outras, escritas pela
+    // mesma thread na ordem do índice (a última vence, como em uploads sucessivos)
+    struct batchEntry *nextSame;
+    int chained; // vai junto com uma entrada anterior de mesmo nome
+};
+enum { BATCH_RECEIVED, BATCH_OVERWRITTEN, BATCH_FAILED };
+
+struct batch {
+    struct batch *next;
+    void *owner;      // conexão que enviou o lote (NULL se ela fechou antes do fim)
+    char *data;       // índice seguido do conteúdo
+    size_t indexSize, size, used;
+    unsigned count;
+    struct batchEntry *entries;
+    unsigned queued;          // arquivos entregues às threads (os de nome válido)
+    unsigned nextEntry, done; // protegidos pelo mutex do pool
+};
+
+// inicia as threads escritoras; retorna o eventfd sinalizado quando um lote termina.
+// Com ncpus > 0, a escritora i nasce fixada em cpus[i % ncpus]
+int batchPoolStart(unsigned writers, const int *cpus, unsigned ncpus);
+
+// aloca um lote para receber o corpo anunciado no cabeçalho
+struct batch *batchCreate(unsigned count, size_t indexSize, size_t dataSize, const char **error);
+// confere o índice do corpo já recebido; validName decide quais nomes são aceitos
+int batchParse(struct batch *batch, int (*validName)(const char *), const char **error);
+// entrega o lote às threads escritoras
+void batchSubmit(struct batch *batch);
+// próximo lote terminado (só no laço de eventos) ou NULL
+struct batch *batchCompleted(void);
+// lotes entregues ao pool e ainda não devolvidos por batchCompleted
+unsigned batchInFlight(void);
+void batchFree(struct batch *batch);
+
+#endif
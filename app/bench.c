@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "latency.h"
+#include "protocol.h"
+#define BUFSZ 500
+#define DEFAULT_COUNT 10000
+#define DEFAULT_WARMUP 100
+#define DEFAULT_SIZE 64
+
+// mede a latência de confirmação do servidor: envia um arquivo (ou um lote de
+// arquivos) por vez e espera o "received" antes do próximo, então cada amostra
+// é o tempo de uma ida e volta completa. Para comparar posicionamentos, rode o
+// servidor com cada --cpus/--placement/--busy-poll e o bench contra cada um
+void usageExit(int argc, char **argv) {
+    printf("Bench usage: %s <server IP> <server port> [options]\n", argv[0]);
+    printf("             %s unix:<socket path> [options]\n", argv[0]);
+    printf("Ex: %s 127.0.0.1 51511 --count 20000\n", argv[0]);
+    printf("Options:\n");
+    printf("  --count <n>   acknowledged messages to measure (default %d)\n", DEFAULT_COUNT);
+    printf("  --warmup <n>  messages sent before measuring (default %d)\n", DEFAULT_WARMUP);
+    printf("  --size <b>    bytes per file (default %d)\n", DEFAULT_SIZE);
+    printf("  --batch <k>   send k files per batch frame instead of one file per message\n");
+    exit(EXIT_FAILURE);
+}
+
+void msgExit(const char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+    static struct option options[] = {
+        {"count", required_argument, NULL, 'n'},
+        {"warmup", required_argument, NULL, 'W'},
+        {"size", required_argument, NULL, 's'},
+        {"batch", required_argument, NULL, 'b'},
+        {NULL, 0, NULL, 0}
+    };
+    int count = DEFAULT_COUNT, warmup = DEFAULT_WARMUP, size = DEFAULT_SIZE, batch = 0, opt;
+    while((opt = getopt_long(argc, argv, "n:W:s:b:", options, NULL)) != -1) {
+        if(opt == 'n') count = atoi(optarg);
+        else if(opt == 'W') warmup = atoi(optarg);
+        else if(opt == 's') size = atoi(optarg);
+        else if(opt == 'b') batch = atoi(optarg);
+        else usageExit(argc, argv);
+    }
+    if(count <= 0 || warmup < 0 || size < 0 || batch < 0) usageExit(argc, argv);
+    int positional = argc - optind;
+    if(positional < 1 || positional > 2) usageExit(argc, argv);
+
+    struct sockaddr_storage storage;
+    if(addrparse(argv[optind], positional == 2 ? argv[optind + 1] : NULL, &storage) != 0) usageExit(argc, argv);
+    int sock = socket(storage.ss_family, SOCK_STREAM, 0);
+    if(sock < 0) msgExit("socket() failed");
+    if(connect(sock, (struct sockaddr *)&storage, addrlen(&storage)) != 0) msgExit("connect() failed");
+    if(storage.ss_family != AF_UNIX) {
+        // mensagens pequenas e uma de cada vez: sem Nagle, cada uma sai na hora
+        int enable = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+
+    // conteúdo sem '\0' (o servidor termina a mensagem no primeiro)
+    char *contents = malloc(size + 1);
+    for(int i = 0; i < size; i++) contents[i] = 'a' + i % 26;
+    contents[size] = '\0';
+
+    // a mensagem é sempre a mesma: o servidor sobrescreve os mesmos arquivos
+    char *message;
+    size_t messageLen;
+    if(batch == 0) {
+        messageLen = strlen("bench.txt") + size + strlen("\\end") + 1;
+        if(messageLen > BUFSZ) {
+            printf("--size too big for a single message, use --batch\n");
+            exit(EXIT_FAILURE);
+        }
+        message = malloc(messageLen);
+        snprintf(message, messageLen, "bench.txt%s\\end", contents);
+    } else {
+        char *index = malloc(batch * 32);
+        size_t indexSize = 0;
+        for(int i = 0; i < batch; i++) indexSize += sprintf(index + indexSize, "%d bench%d.txt\n", size, i);
+        char header[BUFSZ];
+        size_t headerLen = batchHeader(header, batch, indexSize, (size_t)batch * size);
+        messageLen = headerLen + indexSize + (size_t)batch * size;
+        message = malloc(messageLen);
+        memcpy(message, header, headerLen);
+        memcpy(message + headerLen, index, indexSize);
+        for(int i = 0; i < batch; i++) memcpy(message + headerLen + indexSize + (size_t)i * size, contents, size);
+        free(index);
+    }
+
+    struct latencyStats stats = {0};
+    char reply[BUFSZ];
+    uint64_t start = 0;
+    for(int i = 0; i < warmup + count; i++) {
+        if(i == warmup) start = latencyNow();
+        uint64_t sent = latencyNow();
+        if(sendAll(sock, message, messageLen) != 0) msgExit("send() failed");
+        if(recvResponse(sock, reply) != 0) msgExit("recv() failed");
+        if(strstr(reply, "error") != NULL || strstr(reply, "disconnect") != NULL) {
+            printf("server replied: %s\n", reply);
+            exit(EXIT_FAILURE);
+        }
+        if(i >= warmup) latencyAdd(&stats, latencyNow() - sent);
+    }
+    latencyReport(&stats, batch ? "batch acks" : "file acks", latencyNow() - start);
+
+    latencyFree(&stats);
+    free(message);
+    free(contents);
+    close(sock);
+    exit(EXIT_SUCCESS);
+}
@@ -1,20 +1,53 @@
+#define _GNU_SOURCE
 #include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <libgen.h>
+#include <dirent.h>
+#include <sys/random.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <limits.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include "fdpass.h"
+#include "shmring.h"
+#include "ktls.h"
+#include "hashring.h"
+#include "protocol.h"
 #define BUFSZ 500
+#define MIN_RANGE_SIZE (1 << 20) // arquivos menores não valem várias conexões
+#define MAX_STREAMS 64
+#define DEFAULT_STREAMS 4
+#define BATCH_MAX_FILES 4096
+#define BATCH_MAX_BYTES (64 << 20) // limites do servidor para um lote
+#define MAX_SHARDS 64
+#define RANGE_ATTEMPTS 5 // tentativas por faixa antes de desistir (com espera crescente)
 
 void usageExit(int argc, char **argv) {
-    printf("Client usage: %s <server IP> <server port>\n", argv[0]);
+    printf("Client usage: %s <server IP> <server port> [options]\n", argv[0]);
+    printf("              %s unix:<socket path> [options]\n", argv[0]);
     printf("Ex: %s 127.0.0.1 51511\n", argv[0]); // IPv4 loopback
     printf("Ex: %s ::1 51511\n", argv[0]); // IPv6 loopback
+    printf("Ex: %s unix:/tmp/server.sock --shm\n", argv[0]); // mesmo host
+    printf("Options:\n");
+    printf("  --shm         with unix:, send messages through a shared-memory ring\n");
+    printf("  --psk <file>  encrypt the connection with kTLS using this pre-shared key\n");
+    printf("  --streams <k> upload files too big for one message over k parallel connections (default %d)\n", DEFAULT_STREAMS);
+    printf("  --shard <a>   add a server (host:port, [v6]:port or unix:<p>) to the cluster; files are spread\n");
+    printf("                over all servers by a consistent hash of their names (repeatable)\n");
+    printf("  --record <f>  write every upload (kind, sizes and timing) to capture file <f>, for replay\n");
     exit(EXIT_FAILURE);
 }
 
@@ -23,41 +56,6 @@ void msgExit(const char *msg) {
     exit(EXIT_FAILURE);
 }
 
-int addrparse(const char *addrstr, const char *portstr, struct sockaddr_storage *storage) {
-    // AF_INET = IPv4, AF_INET6 = IPv6
-    if(addrstr == NULL || portstr == NULL) return -1;
-
-    uint16_t port = (uint16_t)atoi(portstr); // unsigned short, 16 bits
-    if(port == 0) return -1;
-
-    port = htons(port); // converte para network byte order, host to network short
-
-    struct in_addr inaddr4; // IPv4, 32 bits
-    // inet presentation to network
-    if(inet_pton(AF_INET, addrstr, &inaddr4)) {
-        // converte para sockaddr_in (IPv4) e armazena em storage
-        struct sockaddr_in *addr4 = (struct sockaddr_in *)storage;
-        addr4->sin_family = AF_INET;
-        addr4->sin_port = port;
-        addr4->sin_addr = inaddr4;
-        return 0;
-    }
-
-    struct in6_addr inaddr6; // IPv6, 128 bits
-    if(inet_pton(AF_INET6, addrstr, &inaddr6)) {
-        // converte para sockaddr_in6 (IPv6) e armazena em storage
-        struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)storage;
-        addr6->sin6_family = AF_INET6;
-        addr6->sin6_port = port;
-        // addr6->sin6_addr = inaddr6; não funciona, pois inaddr6 é um array de 16 bytes
-        // memcpy(destino, origem, tamanho)
-        memcpy(&(addr6->sin6_addr), &inaddr6, sizeof(inaddr6));
-        return 0;
-    }
-
-    return -1;
-}
-
 void addrtostr(const struct sockaddr *addr, char *str, size_t strsize) {
     int version;
     char addrstr[INET6_ADDRSTRLEN + 1] = ""; // pode ser IPv4 ou IPv6
@@ -80,31 +78,580 @@ void addrtostr(const struct sockaddr *addr, char *str, size_t strsize) {
             msgExit("ntop ipv6 failed");
         // network to host short
         port = ntohs(addr6->sin6_port);
+    } else if(addr->sa_family == AF_UNIX) {
+        if(str) snprintf(str, strsize, "unix %s", ((const struct sockaddr_un *)addr)->sun_path);
+        return;
     } else msgExit("addrtostr() failed, unknown protocol");
 
     if(str) snprintf(str, strsize, "IPv%d %s %hu", version, addrstr, port);
 }
 
+// captura da sessão (--record): uma linha "<microssegundos desde o início> <evento>"
+// por upload, só com tamanhos e nomes; o replay gera conteúdo do mesmo tamanho
+static FILE *recordFile = NULL;
+static uint64_t recordStart;
 
-int main(int argc, char **argv) {
-    if(argc < 3 || argc > 3) usageExit(argc, argv);
+uint64_t nowMicros(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
 
+// eventos: "file <bytes> <nome>", "upload <bytes> <nome>", "batch <arquivos> <bytes>"
+void recordEvent(const char *format, ...) {
+    if(recordFile == NULL) return;
+    va_list args;
+    va_start(args, format);
+    fprintf(recordFile, "%llu ", (unsigned long long)(nowMicros() - recordStart));
+    vfprintf(recordFile, format, args);
+    fputc('\n', recordFile);
+    fflush(recordFile); // o cliente costuma terminar com exit() de qualquer ponto
+    va_end(args);
+}
+
+// anel de memória compartilhada negociado com o servidor (header NULL = não usado)
+static struct shmRing ring;
 
-    // estrutura que armazena endereço ipv4 ou ipv6
+// chave kTLS, usada também nas conexões extras do upload paralelo e dos shards
+static struct ktlsPsk psk;
+static int usePsk = 0;
+static int streams = DEFAULT_STREAMS;
+
+// servidores do cluster: o da linha de comando é o 0 e os outros vêm de --shard.
+// Cada arquivo vai para o dono do seu nome no anel de hash consistente
+struct shard {
     struct sockaddr_storage storage;
-    if (addrparse(argv[1], argv[2], &storage) != 0) usageExit(argc, argv);
+    char name[BUFSZ]; // endereço como foi digitado: é a identidade do servidor no anel
+    int sock;         // conexão com o servidor, aberta na primeira vez que é usada
+};
+static struct shard shardList[MAX_SHARDS];
+static unsigned shardCount = 0;
+static struct hashRing shardRing;
+
+// abre uma conexão com o servidor, fazendo o handshake kTLS se houver PSK. Retorna -1 em caso de falha
+int connectServer(const struct sockaddr_storage *storage) {
+    //IPv4, IPv6 ou Unix, stream
+    int sock = socket(storage->ss_family, SOCK_STREAM, 0);
+    if(sock < 0) return -1;
+
+    struct sockaddr *addr = (struct sockaddr *)storage;
+    if(connect(sock, addr, addrlen(storage)) != 0) {
+        close(sock);
+        return -1;
+    }
+    // handshake com a chave pré-compartilhada; depois o kernel cifra tudo
+    if(usePsk && ktlsClientHandshake(sock, &psk) != 0) {
+        printf("kTLS handshake failed\n");
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// mapeia o arquivo inteiro só para leitura: o conteúdo é enviado direto do
+// page cache, sem cópias nem leituras byte a byte. Arquivo vazio não tem
+// mapeamento. Retorna NULL se o arquivo não puder ser aberto
+const char *mapFile(const char *path, size_t *size) {
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return NULL;
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    *size = st.st_size;
+    if(*size == 0) {
+        close(fd);
+        return "";
+    }
+    char *map = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // o mapeamento continua válido sem o descritor
+    if(map == MAP_FAILED) return NULL;
+    // leitura do início ao fim: o kernel lê adiante e descarta as páginas já enviadas
+    madvise(map, *size, MADV_SEQUENTIAL);
+    return map;
+}
+
+void unmapFile(const char *map, size_t size) {
+    if(size > 0) munmap((void *)map, size);
+}
+
+// uma faixa do upload paralelo, enviada por uma thread em sua própria conexão
+struct rangeStream {
+    pthread_t thread;
+    const char *map;   // arquivo local mapeado, compartilhado pelas threads
+    const struct sockaddr_storage *server;
+    const char *name;  // nome enviado ao servidor
+    const char *id;
+    unsigned index, count;
+    uint64_t size, offset, length;
+    char reply[BUFSZ];
+    int ok;
+};
+
+// pergunta ao servidor quanto da faixa já foi salvo em uma tentativa anterior.
+// Retorna 0 com *offset preenchido, 1 se a faixa ainda está ocupada no servidor
+// e -1 em caso de erro
+int resumeOffset(int sock, struct rangeStream *range, uint64_t *offset) {
+    char buffer[BUFSZ];
+    unsigned long long value;
+    snprintf(buffer, BUFSZ, "resume %s %u\\end", range->id, range->index);
+    if(sendAll(sock, buffer, strlen(buffer)+1) != 0 || recvResponse(sock, buffer) != 0) return -1;
+    if(strcmp(buffer, "offset busy\n") == 0) return 1;
+    *offset = range->offset;
+    if(strcmp(buffer, "offset none\n") == 0) return 0;
+    if(sscanf(buffer, "offset %llu", &value) != 1) return -1;
+    // o servidor só conhece offsets dentro da faixa; qualquer outra coisa recomeça
+    if(value >= range->offset && value <= range->offset + range->length) *offset = value;
+    return 0;
+}
+
+// uma tentativa de enviar a faixa, continuando de onde o servidor parou.
+// Retorna 0 se a faixa foi confirmada
+int sendRangeAttempt(struct rangeStream *range) {
+    char header[BUFSZ];
+    int sock = connectServer(range->server);
+    if(sock < 0) return -1;
+
+    uint64_t offset;
+    int busy = resumeOffset(sock, range, &offset);
+    if(busy != 0) {
+        close(sock);
+        return -1;
+    }
+    uint64_t remaining = range->offset + range->length - offset;
+
+    // cabeçalho terminado em '\0', seguido dos bytes crus da faixa
+    size_t headerLen = rangeHeader(header, range->id, range->index, range->count, range->size, offset, remaining, range->name);
+    int failed = sendAll(sock, header, headerLen) != 0;
+    if(!failed && sendAll(sock, range->map + offset, remaining) != 0) failed = 1;
+
+    if(!failed && recvResponse(sock, range->reply) != 0) failed = 1;
+    close(sock);
+    return failed ? -1 : 0;
+}
 
+void *sendRange(void *arg) {
+    struct rangeStream *range = arg;
+    range->ok = 0;
+    snprintf(range->reply, BUFSZ, "error sending range %u\n", range->index);
+
+    // conexão caiu no meio: espera um pouco e retoma a partir do último checkpoint
+    for(int attempt = 0; attempt < RANGE_ATTEMPTS; attempt++) {
+        if(attempt > 0) usleep(100000 << attempt);
+        if(sendRangeAttempt(range) == 0) {
+            range->ok = 1;
+            break;
+        }
+    }
+    return NULL;
+}
+
+// estado local de um upload paralelo ("<dir>/.<nome>.upload"): se o cliente for
+// interrompido, a próxima execução reutiliza o mesmo id e o servidor retoma as faixas
+void uploadStatePath(const char *path, char *statePath, size_t len) {
+    char *dirCopy = strdup(path), *baseCopy = strdup(path);
+    snprintf(statePath, len, "%s/.%s.upload", dirname(dirCopy), basename(baseCopy));
+    free(dirCopy);
+    free(baseCopy);
+}
+
+// reutiliza o id salvo se o arquivo não mudou desde a tentativa anterior
+int loadUploadState(const char *statePath, const struct stat *st, char *id, unsigned *count) {
+    unsigned long long size;
+    long long mtime;
+    unsigned savedCount;
+    FILE *f = fopen(statePath, "r");
+    if(f == NULL) return -1;
+    int ok = fscanf(f, "%16s %llu %lld %u", id, &size, &mtime, &savedCount) == 4;
+    fclose(f);
+    if(!ok || strlen(id) != 16 || size != st->st_size || mtime != st->st_mtime) return -1;
+    if(savedCount == 0 || savedCount > MAX_STREAMS) return -1;
+    *count = savedCount;
+    return 0;
+}
+
+void saveUploadState(const char *statePath, const struct stat *st, const char *id, unsigned count) {
+    FILE *f = fopen(statePath, "w");
+    if(f == NULL) return; // sem estado salvo o upload só não é retomável
+    fprintf(f, "%s %llu %lld %u\n", id, (unsigned long long)st->st_size, (long long)st->st_mtime, count);
+    fclose(f);
+}
+
+// envia um arquivo grande dividido em faixas por várias conexões em paralelo;
+// o servidor escreve cada faixa na sua posição e confirma o arquivo quando todas chegam
+void parallelUpload(const char *path, const struct stat *st, const struct sockaddr_storage *server) {
+    size_t size;
+    // todas as threads enviam do mesmo mapeamento, cada uma a sua faixa
+    const char *map = mapFile(path, &size);
+    if(map == NULL || size != st->st_size) {
+        printf("%s changed while being read\n", path);
+        if(map) unmapFile(map, size);
+        return;
+    }
+    unsigned count = streams;
+    if(size / MIN_RANGE_SIZE < count) count = size / MIN_RANGE_SIZE;
+    if(count == 0) count = 1;
+
+    char statePath[BUFSZ];
+    char id[17];
+    uploadStatePath(path, statePath, sizeof(statePath));
+    if(loadUploadState(statePath, st, id, &count) == 0) printf("resuming upload %s\n", id);
+    else {
+        // identificador aleatório da sessão de upload no servidor
+        unsigned char random[8];
+        if(getrandom(random, sizeof(random), 0) != sizeof(random)) msgExit("getrandom() failed");
+        for(int i = 0; i < sizeof(random); i++) sprintf(&id[2*i], "%02x", random[i]);
+        saveUploadState(statePath, st, id, count);
+    }
+
+    char *pathCopy = strdup(path);
+    const char *name = basename(pathCopy);
+    recordEvent("upload %zu %s", size, name);
+    struct rangeStream *ranges = calloc(count, sizeof(*ranges));
+    uint64_t chunk = (size + count - 1) / count;
+    for(unsigned i = 0; i < count; i++) {
+        ranges[i].map = map;
+        ranges[i].server = server;
+        ranges[i].name = name;
+        ranges[i].id = id;
+        ranges[i].index = i;
+        ranges[i].count = count;
+        ranges[i].size = size;
+        ranges[i].offset = (uint64_t)i * chunk;
+        ranges[i].length = i == count - 1 ? size - ranges[i].offset : chunk;
+        pthread_create(&ranges[i].thread, NULL, sendRange, &ranges[i]);
+    }
+
+    // só a faixa que completou o arquivo recebe "file ... received"
+    const char *result = NULL;
+    for(unsigned i = 0; i < count; i++) {
+        pthread_join(ranges[i].thread, NULL);
+        if(!ranges[i].ok || strncmp(ranges[i].reply, "range ", 6) != 0) result = ranges[i].reply;
+    }
+    printf("%s", result ? result : "error receiving file\n");
+    // arquivo confirmado: não há mais o que retomar
+    if(result != NULL && strncmp(result, "file ", 5) == 0) unlink(statePath);
+    free(ranges);
+    free(pathCopy);
+    unmapFile(map, size);
+}
+
+// pede ao servidor o transporte por memória compartilhada; se não der, segue pelo socket
+void setupSharedRing(int sock) {
+    char buffer[BUFSZ];
+    sprintf(buffer, "shm\\end");
+    if(send(sock, buffer, strlen(buffer)+1, 0) != strlen(buffer)+1) msgExit("send() failed, msg size mismatch");
+
+    int fd;
+    memset(buffer, 0, BUFSZ);
+    if(recvFd(sock, &fd, buffer, BUFSZ - 1) <= 0) msgExit("recv() failed");
+    if(strcmp(buffer, "shm ok\n\\end") != 0 || fd < 0 || shmRingAttach(&ring, fd) != 0) {
+        if(fd >= 0) close(fd);
+        printf("shared memory unavailable, using the socket\n");
+        return;
+    }
+    close(fd);
+    printf("Using shared memory ring\n");
+}
+
+// envia len bytes, pelo anel quando ativo ou pelo socket.
+// Retorna o número de bytes enviados, como send()
+ssize_t sendBytes(int sock, const char *message, size_t len) {
+    if(ring.header == NULL) return sendAll(sock, message, len) == 0 ? len : -1;
+
+    size_t written = 0;
+    char doorbell = 1;
+    while(written < len) {
+        size_t n = shmRingWrite(&ring, message + written, len - written);
+        if(n == 0) { // anel cheio: espera o servidor consumir
+            usleep(100);
+            continue;
+        }
+        written += n;
+        // avisa o servidor que há dados novos no anel
+        if(send(sock, &doorbell, 1, 0) != 1) return -1;
+    }
+    return written;
+}
+
+// envia uma mensagem inteira (com o '\0')
+ssize_t sendMessage(int sock, const char *message) {
+    return sendBytes(sock, message, strlen(message)+1);
+}
+
+// envia vários pedaços em sequência pelo socket com sendmsg (scatter-gather),
+// sem juntá-los em um buffer. Altera iov durante envios parciais.
+// Retorna o total enviado ou -1
+ssize_t sendIovSocket(int sock, struct iovec *iov, int iovcnt) {
+    size_t total = 0;
+    while(iovcnt > 0) {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovcnt < IOV_MAX ? iovcnt : IOV_MAX;
+        ssize_t count = sendmsg(sock, &msg, MSG_NOSIGNAL);
+        if(count < 0) return -1;
+        total += count;
+        // descarta os pedaços já enviados e avança no que ficou pela metade
+        while(iovcnt > 0 && count >= iov->iov_len) {
+            count -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if(iovcnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + count;
+            iov->iov_len -= count;
+        }
+    }
+    return total;
+}
+
+// como sendIovSocket, mas pelo anel quando ativo (um pedaço de cada vez)
+ssize_t sendIov(int sock, struct iovec *iov, int iovcnt) {
+    if(ring.header == NULL) return sendIovSocket(sock, iov, iovcnt);
+    size_t total = 0;
+    for(int i = 0; i < iovcnt; i++) {
+        if(sendBytes(sock, iov[i].iov_base, iov[i].iov_len) != iov[i].iov_len) return -1;
+        total += iov[i].iov_len;
+    }
+    return total;
+}
+
+// shard dono do arquivo: o anel usa só o nome, que é o que o servidor grava
+unsigned shardFor(const char *path) {
+    if(shardCount <= 1) return 0;
+    char *pathCopy = strdup(path);
+    unsigned shard = hashRingLookup(&shardRing, basename(pathCopy));
+    free(pathCopy);
+    return shard;
+}
+
+// conexão com o shard, aberta na primeira vez. Retorna -1 se ele não responder
+int shardSocket(unsigned shard) {
+    if(shardList[shard].sock < 0) shardList[shard].sock = connectServer(&shardList[shard].storage);
+    return shardList[shard].sock;
+}
+
+// quadro "batch" sendo montado: índice "<tamanho> <nome>\n" e os arquivos mapeados
+struct batchFrame {
+    char *index;
+    size_t indexSize, dataSize;
+    struct iovec *files; // files[0] fica reservado para o índice
+    unsigned count;
+};
+
+// acrescenta um arquivo ao lote do seu shard (frames tem um lote por shard);
+// diretórios entram com todos os arquivos de dentro
+void batchAdd(struct batchFrame *frames, const char *path) {
+    struct stat st;
+    if(stat(path, &st) != 0) {
+        printf("%s does not exist\n", path);
+        return;
+    }
+    if(S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(path);
+        if(dir == NULL) return;
+        char child[BUFSZ];
+        for(struct dirent *entry = readdir(dir); entry != NULL; entry = readdir(dir)) {
+            if(entry->d_name[0] == '.') continue;
+            snprintf(child, BUFSZ, "%s/%s", path, entry->d_name);
+            if(stat(child, &st) == 0 && S_ISREG(st.st_mode)) batchAdd(frames, child);
+        }
+        closedir(dir);
+        return;
+    }
+    struct batchFrame *batch = &frames[shardFor(path)];
+    if(batch->count == BATCH_MAX_FILES || batch->indexSize + BUFSZ + batch->dataSize + st.st_size > BATCH_MAX_BYTES) {
+        printf("batch too large, %s not sent\n", path);
+        return;
+    }
+    size_t size;
+    const char *map = mapFile(path, &size);
+    if(map == NULL) return;
+
+    char *pathCopy = strdup(path);
+    char line[BUFSZ];
+    int lineLen = snprintf(line, BUFSZ, "%zu %s\n", size, basename(pathCopy));
+    free(pathCopy);
+    batch->index = realloc(batch->index, batch->indexSize + lineLen);
+    memcpy(batch->index + batch->indexSize, line, lineLen);
+    batch->indexSize += lineLen;
+    batch->files = realloc(batch->files, (batch->count + 2) * sizeof(*batch->files));
+    batch->files[batch->count + 1].iov_base = (void *)map;
+    batch->files[batch->count + 1].iov_len = size;
+    batch->dataSize += size;
+    batch->count++;
+}
+
+// envia um quadro "batch" montado e libera os mapeamentos. viaRing usa o anel de
+// memória compartilhada (só a conexão principal tem um). Retorna -1 se o envio falhar
+int sendFrame(int sock, struct batchFrame *batch, int viaRing) {
+    char header[BUFSZ];
+    size_t headerLen = batchHeader(header, batch->count, batch->indexSize, batch->dataSize);
+    // guarda os mapeamentos: sendIov avança os ponteiros do vetor enviado
+    struct iovec *iov = malloc((batch->count + 1) * sizeof(*iov));
+    batch->files[0].iov_base = batch->index;
+    batch->files[0].iov_len = batch->indexSize;
+    memcpy(iov, batch->files, (batch->count + 1) * sizeof(*iov));
+    int failed;
+    if(viaRing) failed = sendMessage(sock, header) != headerLen ||
+                         sendIov(sock, iov, batch->count + 1) != batch->indexSize + batch->dataSize;
+    else failed = sendAll(sock, header, headerLen) != 0 ||
+                  sendIovSocket(sock, iov, batch->count + 1) != batch->indexSize + batch->dataSize;
+    for(unsigned i = 1; i <= batch->count; i++) unmapFile(batch->files[i].iov_base, batch->files[i].iov_len);
+    free(iov);
+    free(batch->files);
+    free(batch->index);
+    return failed ? -1 : 0;
+}
+
+// lote de um shard, enviado por uma thread na conexão dele
+struct shardUpload {
+    pthread_t thread;
+    unsigned shard;
     int sock;
-    //IPv4 ou IPv6, TCP, IP
-    sock = socket(storage.ss_family, SOCK_STREAM, 0);
-    if(sock < 0) msgExit("socket() failed");
+    struct batchFrame *batch;
+    char reply[BUFSZ];
+};
 
-    struct sockaddr *addr = (struct sockaddr *)(&storage);
-    if(connect(sock, addr, sizeof(storage)) != 0) msgExit("connect() failed");
+void *sendShardBatch(void *arg) {
+    struct shardUpload *upload = arg;
+    // o shard 0 usa a conexão principal, que pode estar no anel
+    if(sendFrame(upload->sock, upload->batch, upload->shard == 0) != 0 || recvResponse(upload->sock, upload->reply) != 0)
+        snprintf(upload->reply, BUFSZ, "error sending batch\n");
+    return NULL;
+}
 
+// envia vários arquivos pequenos em um único quadro "batch": cabeçalho, índice
+// e o conteúdo de todos em sequência, com uma só resposta do servidor.
+// files é a lista de arquivos ou diretórios separados por espaço.
+// Retorna -1 se nada foi enviado, 0 se a resposta ainda deve ser lida de sock
+// e 1 se o lote foi dividido entre os shards (as respostas já foram mostradas)
+int sendBatch(int sock, char *files) {
+    struct batchFrame *frames = calloc(shardCount, sizeof(*frames));
+    unsigned total = 0;
+    for(char *path = strtok(files, " \n"); path != NULL; path = strtok(NULL, " \n")) batchAdd(frames, path);
+    for(unsigned i = 0; i < shardCount; i++) total += frames[i].count;
+    if(total == 0) {
+        printf("no file selected!\n");
+        free(frames);
+        return -1;
+    }
+    size_t dataSize = 0;
+    for(unsigned i = 0; i < shardCount; i++) dataSize += frames[i].dataSize;
+    recordEvent("batch %u %zu", total, dataSize);
+    if(shardCount == 1) {
+        if(sendFrame(sock, &frames[0], 1) != 0) msgExit("send() failed, msg size mismatch");
+        free(frames);
+        return 0;
+    }
+
+    // cluster: um lote por shard, todos enviados em paralelo
+    struct shardUpload *uploads = calloc(shardCount, sizeof(*uploads));
+    for(unsigned i = 0; i < shardCount; i++) {
+        uploads[i].shard = i;
+        uploads[i].batch = &frames[i];
+        if(frames[i].count == 0) continue;
+        uploads[i].sock = shardSocket(i);
+        if(uploads[i].sock < 0) {
+            snprintf(uploads[i].reply, BUFSZ, "connect() failed, %u files not sent\n", frames[i].count);
+            for(unsigned f = 1; f <= frames[i].count; f++) unmapFile(frames[i].files[f].iov_base, frames[i].files[f].iov_len);
+            free(frames[i].files);
+            free(frames[i].index);
+            frames[i].count = 0;
+            continue;
+        }
+        pthread_create(&uploads[i].thread, NULL, sendShardBatch, &uploads[i]);
+    }
+    for(unsigned i = 0; i < shardCount; i++) {
+        if(frames[i].count > 0) pthread_join(uploads[i].thread, NULL);
+        if(uploads[i].reply[0] != '\0') printf("%s: %s", shardList[i].name, uploads[i].reply);
+    }
+    free(uploads);
+    free(frames);
+    return 1;
+}
+
+// "host:porta", "[v6]:porta" ou "unix:<caminho>" de --shard
+int main(int argc, char **argv) {
+    static struct option options[] = {
+        {"shm", no_argument, NULL, 's'},
+        {"psk", required_argument, NULL, 'k'},
+        {"streams", required_argument, NULL, 'j'},
+        {"shard", required_argument, NULL, 'S'},
+        {"record", required_argument, NULL, 'r'},
+        {NULL, 0, NULL, 0}
+    };
+    int useShm = 0, opt;
+    const char *pskPath = NULL;
+    // o servidor principal ocupa o shard 0, preenchido depois das opções
+    shardCount = 1;
+    while((opt = getopt_long(argc, argv, "sk:j:S:r:", options, NULL)) != -1) {
+        if(opt == 's') useShm = 1;
+        else if(opt == 'r') {
+            recordFile = fopen(optarg, "w");
+            if(recordFile == NULL) msgExit("fopen() failed");
+            fprintf(recordFile, "# upload capture v1\n");
+            recordStart = nowMicros();
+        }
+        else if(opt == 'S') {
+            if(shardCount == MAX_SHARDS || hostportparse(optarg, &shardList[shardCount].storage) != 0) usageExit(argc, argv);
+            snprintf(shardList[shardCount].name, BUFSZ, "%s", optarg);
+            shardList[shardCount++].sock = -1;
+        }
+        else if(opt == 'k') pskPath = optarg;
+        else if(opt == 'j') {
+            streams = atoi(optarg);
+            if(streams < 1 || streams > MAX_STREAMS) usageExit(argc, argv);
+        }
+        else usageExit(argc, argv);
+    }
+    // argumentos posicionais: endereço e porta (ou só unix:<caminho>)
+    int positional = argc - optind;
+    if(positional < 1 || positional > 2) usageExit(argc, argv);
+    char *portstr = positional == 2 ? argv[optind + 1] : NULL;
+
+    // estrutura que armazena endereço ipv4, ipv6 ou unix
+    struct sockaddr_storage storage;
+    if (addrparse(argv[optind], portstr, &storage) != 0) usageExit(argc, argv);
+    shardList[0].storage = storage;
+    if(portstr) snprintf(shardList[0].name, BUFSZ, "%s:%s", argv[optind], portstr);
+    else snprintf(shardList[0].name, BUFSZ, "%s", argv[optind]);
+    if(shardCount > 1) {
+        const char *names[MAX_SHARDS];
+        for(unsigned i = 0; i < shardCount; i++) names[i] = shardList[i].name;
+        if(hashRingInit(&shardRing, names, shardCount) != 0) msgExit("hashRingInit() failed");
+    }
+
+    if(pskPath) {
+        int overUnix = 0;
+        for(unsigned i = 0; i < shardCount; i++) overUnix |= shardList[i].storage.ss_family == AF_UNIX;
+        if(overUnix) {
+            printf("--psk is only supported over TCP\n");
+            exit(EXIT_FAILURE);
+        }
+        if(ktlsLoadPsk(pskPath, &psk) != 0) {
+            printf("could not read a key of at least %d bytes from %s\n", KTLS_PSK_MIN, pskPath);
+            exit(EXIT_FAILURE);
+        }
+        usePsk = 1;
+    }
+
+    int sock = connectServer(&storage);
+    if(sock < 0) msgExit("connect() failed");
+    shardList[0].sock = sock;
+
+    struct sockaddr *addr = (struct sockaddr *)(&storage);
     char addrstr[BUFSZ];
     addrtostr(addr, addrstr, BUFSZ);
     printf("Connected to %s\n", addrstr);
+    if(usePsk) printf("Encrypted with kTLS\n");
+    if(shardCount > 1) printf("Sharding files over %u servers\n", shardCount);
+    if(useShm) {
+        if(storage.ss_family != AF_UNIX) printf("--shm needs a unix: server, using the socket\n");
+        else setupSharedRing(sock);
+    }
 
     // inicializa buffer com máximo de 500 bytes
     char buffer[BUFSZ];
@@ -117,11 +664,9 @@ int main(int argc, char **argv) {
     char *valid_extensions[] = {".txt", ".c", ".cpp", ".py", ".tex", ".java"};
     // string que representa o nome do último arquivo válido selecionado
     char *selected_file = NULL;
-    // string que representa a mensagem "<nomearquivo><conteudo>\exit"
-    char message[BUFSZ];
     // activeFile indica se há algum arquivo selecionado no momento
-    // to send file indica se é para enviar um arquivo selecionado ou não
-    int activeFile = 0, toSendFile = 0;
+    // sent indica que o arquivo (ou lote) já foi enviado e só falta ler a resposta
+    int activeFile = 0, sent = 0;
 
     int count = 0;
     while(1) {
@@ -172,6 +717,11 @@ int main(int argc, char **argv) {
             free(file_name);
             continue;
         } 
+        else if(strncmp(buffer, "send batch ", 11) == 0) {
+            // "send batch <arquivo|diretório> ...": todos em um único quadro
+            if(sendBatch(sock, buffer + 11) != 0) continue;
+            sent = 1;
+        }
         else if(strcmp(buffer, "send file\n") == 0) { // caso seja exatamente send file
             // checa se um arquivo foi selecionado para enviar
             if(activeFile == 0) {
@@ -185,38 +735,49 @@ int main(int argc, char **argv) {
                     // free(selected);
                     continue;
                 }
-                // lê os conteúdos do arquivo
-                FILE *f = fopen(selected_file, "r");
-                char content[BUFSZ];
-                char buf;
-
-                memset(content, 0, BUFSZ);
-                memset(message, 0, BUFSZ);
-
-                // leitura char a char
-                while(1) {
-                    buf = getc(f);
-                    if(buf == EOF) break;
-                    char c = (char)buf;
-                    strncat(content, &c, 1);
+                // o conteúdo é enviado direto do mapeamento do arquivo
+                size_t size;
+                const char *contents = mapFile(selected_file, &size);
+                if(contents == NULL) {
+                    printf("%s does not exist\n", selected_file);
+                    activeFile = 0;
+                    continue;
+                }
+                // arquivos que não cabem em uma mensagem "<nome><conteúdo>\end", ou com um '\0'
+                // (que terminaria a mensagem antes da hora), vão em faixas paralelas
+                if(strlen(selected_file) + size + strlen("\\end") + 1 > BUFSZ || memchr(contents, '\0', size) != NULL) {
+                    unmapFile(contents, size);
+                    struct stat st;
+                    if(stat(selected_file, &st) == 0) parallelUpload(selected_file, &st, &shardList[shardFor(selected_file)].storage);
+                    continue;
+                }
+                // envia <nomearquivo><conteudo><\end> de uma vez, sem montar a mensagem em um buffer.
+                // Comentar o "\\end" para testar msg error receiving file
+                struct iovec iov[3] = {
+                    { selected_file, strlen(selected_file) },
+                    { (void *)contents, size },
+                    { "\\end", strlen("\\end") + 1 },
+                };
+                size_t total = iov[0].iov_len + iov[1].iov_len + iov[2].iov_len;
+                recordEvent("file %zu %s", size, selected_file);
+                unsigned shard = shardFor(selected_file);
+                if(shard != 0) {
+                    // arquivo de outro servidor do cluster: vai pela conexão dele
+                    int shardSock = shardSocket(shard);
+                    char reply[BUFSZ];
+                    if(shardSock < 0 || sendIovSocket(shardSock, iov, 3) != total || recvResponse(shardSock, reply) != 0)
+                        printf("%s: error sending %s\n", shardList[shard].name, selected_file);
+                    else printf("%s", reply);
+                    unmapFile(contents, size);
+                    continue;
                 }
-                fclose(f);
-
-                // monta a mensagem e manda para o servidor
-                strcat(content, "\\end"); // Comentar essa parte para testar msg error receiving file
-                strcpy(message, selected_file);
-                // strcat(message, " "); seria muito mais fácil se tivesse esse espaço
-                strcat(message, content);
-                // marca que pode enviar o arquivo e, como não há continue, segue direto para enviá-lo abaixo
-                toSendFile = 1;
+                count = sendIov(sock, iov, 3);
+                unmapFile(contents, size);
+                if(count != total) msgExit("send() failed, msg size mismatch");
+                sent = 1;
             }
         }
-        // envia mensagem <nomearquivo><conteudo><\end> para o servidor, count conta os bytes enviados
-        if(toSendFile == 1) {
-            toSendFile = 0;
-            count = send(sock, message, strlen(message)+1, 0);
-            if(count != strlen(message)+1) msgExit("send() failed, msg size mismatch");
-        }
+        if(sent == 1) sent = 0; // mensagem já enviada, só falta a resposta
         // pedido para desconexão
         else if(strncmp(buffer, "exit", 4) == 0) {
             // coloca '\end' no fim da mensagem de exit
@@ -225,13 +786,13 @@ int main(int argc, char **argv) {
                 strcat(buffer, "end");
             }
             else strcat(buffer, "\\end");
-            count = send(sock, buffer, strlen(buffer)+1, 0);
+            count = sendMessage(sock, buffer);
             if(count != strlen(buffer)+1) msgExit("send() failed, msg size mismatch");
         }
         // comando inválido
         else {
             sprintf(buffer, "invalid command\\end");
-            count = send(sock, buffer, strlen(buffer)+1, 0);
+            count = sendMessage(sock, buffer);
             if(count != strlen(buffer)+1) msgExit("send() failed, msg size mismatch");
         }
 
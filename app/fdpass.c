@@ -0,0 +1,55 @@
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "fdpass.h"
+
+int sendFd(int sock, int fd, const void *data, size_t len) {
+    // os dados "normais" são obrigatórios: sem ao menos 1 byte o descritor não é entregue
+    struct iovec iov = { .iov_base = (void *)data, .iov_len = len };
+    union { // garante o alinhamento do buffer de controle
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if(fd >= 0) {
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+
+    ssize_t count = sendmsg(sock, &msg, MSG_NOSIGNAL);
+    return count == (ssize_t)len ? 0 : -1;
+}
+
+ssize_t recvFd(int sock, int *fd, void *data, size_t len) {
+    struct iovec iov = { .iov_base = data, .iov_len = len };
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    *fd = -1;
+    ssize_t count = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    if(count <= 0) return count;
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if(cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+        memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+    return count;
+}
@@ -0,0 +1,16 @@
+#ifndef FDPASS_H
+#define FDPASS_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+// envia um descritor de arquivo por um socket Unix (SCM_RIGHTS), junto com
+// uma pequena mensagem que descreve o descritor. Retorna 0 em caso de sucesso
+int sendFd(int sock, int fd, const void *data, size_t len);
+
+// recebe uma mensagem enviada por sendFd. *fd fica -1 se nenhum descritor
+// veio junto. Retorna o número de bytes de dados recebidos (0 = conexão
+// fechada) ou -1 em caso de erro
+ssize_t recvFd(int sock, int *fd, void *data, size_t len);
+
+#endif
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "message.h"
+#define BUFSZ 500
+
+// harness do parser de mensagens (message.c) para libFuzzer, AFL++ e OSS-Fuzz.
+//
+// Cada entrada passa pelo mesmo caminho do servidor: corta no primeiro '\0',
+// no máximo BUFSZ bytes. Além de procurar falhas de memória (com ASan/UBSan),
+// confere os invariantes do resultado e compara com a implementação antiga
+// baseada em strtok, que o parser substituiu: nome e conteúdo devem ser iguais.
+//
+// libFuzzer/OSS-Fuzz: $CC $CFLAGS fuzz_message.c message.c $LIB_FUZZING_ENGINE
+// AFL++ (modo persistente): afl-clang-fast -DFUZZ_STANDALONE fuzz_message.c message.c
+// Sem fuzzer (make fuzz): ./fuzz_message <arquivos...> roda cada entrada uma vez,
+// ./fuzz_message --bench <segundos> mede parses por segundo (make parser-bench)
+
+static const char *const legacyExtensions[] = {"cpp", "txt", "c", "py", "tex", "java"};
+
+// o parser antigo do servidor, com strtok e cópias; só o caso sem nome (que o
+// fazia ler um ponteiro nulo) foi protegido. Retorna 0 se a mensagem termina em "\end"
+static int legacyParse(char *buffer, char *file_name, char *contents) {
+    int size = strlen(buffer);
+    char *aux = strtok(buffer, ".");
+    if(aux == NULL) return -1;
+    strcpy(file_name, aux);
+    char *rest = strtok(NULL, "");
+    if(rest == NULL) rest = "";
+    strcpy(contents, rest);
+    for(int i = 0; i < 6; i++) {
+        int extension_name_size = strlen(legacyExtensions[i]);
+        if(strncmp(rest, legacyExtensions[i], extension_name_size) == 0) {
+            strcat(file_name, ".");
+            strcat(file_name, legacyExtensions[i]);
+            memmove(contents, contents + extension_name_size, strlen(contents + extension_name_size) + 1);
+            if(strlen(contents) >= 4) contents[strlen(contents)-4] = '\0';
+            break;
+        }
+    }
+    // o servidor só chega aqui com size >= 4
+    return strcmp(&buffer[size-4], "\\end") == 0 ? 0 : 1;
+}
+
+static int inside(const char *p, size_t len, const char *start, const char *end) {
+    return p >= start && p + len <= end;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    char message[BUFSZ + 1];
+    size_t len = 0;
+    while(len < size && len < BUFSZ && data[len] != '\0') len++;
+    memcpy(message, data, len);
+    message[len] = '\0';
+
+    struct fileMessage msg;
+    int parsed = parseFileMessage(message, len, &msg);
+    const char *end = message + len;
+
+    // invariantes: tudo aponta para dentro da mensagem, na ordem nome, extensão, conteúdo
+    if(parsed == MESSAGE_NO_NAME) {
+        if(strspn(message, ".") != len) abort();
+        return 0;
+    }
+    if(!inside(msg.name, msg.nameLen, message, end) || msg.nameLen == 0 || msg.name[0] == '.' ||
+       memchr(msg.name, '.', msg.nameLen) != NULL)
+        abort();
+    if(msg.extensionLen > 0) {
+        char extension[8];
+        if(msg.extension != msg.name + msg.nameLen + 1 || msg.extensionLen >= sizeof(extension)) abort();
+        memcpy(extension, msg.extension, msg.extensionLen);
+        extension[msg.extensionLen] = '\0';
+        if(!validExtension(extension)) abort();
+    }
+    if(!inside(msg.contents, msg.contentsLen, message, end) || msg.contents < msg.name + msg.nameLen) abort();
+    if(parsed == MESSAGE_OK && (len < 4 || memcmp(end - 4, "\\end", 4) != 0)) abort();
+    if(parsed == MESSAGE_TOO_LONG || len < 4) return 0; // o antigo não tinha limite nem mensagens curtas
+
+    // diferencial contra o parser antigo
+    char legacyBuffer[BUFSZ + 1], legacyName[2 * BUFSZ], legacyContents[BUFSZ + 1];
+    memcpy(legacyBuffer, message, len + 1);
+    int legacy = legacyParse(legacyBuffer, legacyName, legacyContents);
+    char name[BUFSZ + 8]; // sem "\end" o parser não limita o nome
+    snprintf(name, sizeof(name), "%.*s%s%.*s", (int)msg.nameLen, msg.name, msg.extensionLen ? "." : "",
+             (int)msg.extensionLen, msg.extensionLen ? msg.extension : "");
+    if(legacy != (parsed == MESSAGE_OK ? 0 : 1) || strcmp(legacyName, name) != 0) abort();
+    if(parsed == MESSAGE_OK && (strlen(legacyContents) != msg.contentsLen ||
+                                memcmp(legacyContents, msg.contents, msg.contentsLen) != 0))
+        abort();
+    return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+#ifdef __AFL_FUZZ_TESTCASE_LEN
+__AFL_FUZZ_INIT();
+#endif
+
+// mensagens típicas (e algumas malformadas) para o microbenchmark
+static const char *const benchMessages[] = {
+    "main.c#include <stdio.h>\nint main(void) { return 0; }\n\\end",
+    "notes.txt a short text file\\end",
+    "script.py print('hello')\\end",
+    "report.tex \\documentclass{article}\\end",
+    "Main.java class Main {}\\end",
+    "module.cpp int x;\\end",
+    "missing.txt without the end mark",
+    "....\\end",
+    "name.exe unknown extension\\end",
+};
+
+// repete o parse das mensagens acima por seconds segundos
+static void bench(double seconds) {
+    size_t count = sizeof(benchMessages) / sizeof(*benchMessages), lens[16];
+    for(size_t i = 0; i < count; i++) lens[i] = strlen(benchMessages[i]);
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unsigned long long parses = 0, sink = 0;
+    double elapsed;
+    do {
+        for(int round = 0; round < 10000; round++)
+            for(size_t i = 0; i < count; i++) {
+                struct fileMessage msg;
+                sink += parseFileMessage(benchMessages[i], lens[i], &msg) + msg.contentsLen;
+            }
+        parses += 10000ULL * count;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1e9;
+    } while(elapsed < seconds);
+    printf("%llu parses in %.2f s: %.1f M/s, %.1f ns each (%llu)\n", parses, elapsed,
+           parses / elapsed / 1e6, elapsed * 1e9 / parses, sink & 1);
+}
+
+int main(int argc, char **argv) {
+#ifdef __AFL_FUZZ_TESTCASE_LEN
+    // AFL++ persistente: muitas entradas por processo, sem fork por execução
+    __AFL_INIT();
+    unsigned char *data = __AFL_FUZZ_TESTCASE_BUF;
+    while(__AFL_LOOP(100000)) LLVMFuzzerTestOneInput(data, __AFL_FUZZ_TESTCASE_LEN);
+    return 0;
+#endif
+    if(argc == 3 && strcmp(argv[1], "--bench") == 0) {
+        bench(atof(argv[2]));
+        return 0;
+    }
+    // sem argumentos lê uma entrada da entrada padrão; senão, cada arquivo é uma entrada
+    static uint8_t data[1 << 16];
+    for(int i = 1; i < argc || i == 1; i++) {
+        FILE *fp = argc > 1 ? fopen(argv[i], "rb") : stdin;
+        if(fp == NULL) {
+            perror(argv[i]);
+            return 1;
+        }
+        size_t size = fread(data, 1, sizeof(data), fp);
+        if(fp != stdin) fclose(fp);
+        LLVMFuzzerTestOneInput(data, size);
+    }
+    return 0;
+}
+#endif
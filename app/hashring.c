@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hashring.h"
+
+// FNV-1a seguido do finalizador do splitmix64: FNV sozinho agrupa chaves
+// parecidas ("a1.c", "a2.c"), o finalizador espalha os bits
+uint64_t hashString(const char *s) {
+    uint64_t h = 14695981039346656037ULL;
+    for(; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+static int comparePoints(const void *a, const void *b) {
+    const struct ringPoint *x = a, *y = b;
+    if(x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    return x->node < y->node ? -1 : x->node > y->node;
+}
+
+int hashRingInit(struct hashRing *ring, const char **names, unsigned nodes) {
+    ring->count = nodes * HASH_RING_VNODES;
+    ring->points = malloc(ring->count * sizeof(*ring->points));
+    if(ring->points == NULL) return -1;
+    char vnode[300];
+    for(unsigned n = 0; n < nodes; n++)
+        for(unsigned v = 0; v < HASH_RING_VNODES; v++) {
+            snprintf(vnode, sizeof(vnode), "%s#%u", names[n], v);
+            ring->points[n * HASH_RING_VNODES + v].hash = hashString(vnode);
+            ring->points[n * HASH_RING_VNODES + v].node = n;
+        }
+    qsort(ring->points, ring->count, sizeof(*ring->points), comparePoints);
+    return 0;
+}
+
+unsigned hashRingLookup(const struct hashRing *ring, const char *key) {
+    uint64_t h = hashString(key);
+    // busca binária pelo primeiro ponto com hash >= h; depois do último, volta ao início
+    unsigned lo = 0, hi = ring->count;
+    while(lo < hi) {
+        unsigned mid = lo + (hi - lo) / 2;
+        if(ring->points[mid].hash < h) lo = mid + 1;
+        else hi = mid;
+    }
+    return ring->points[lo == ring->count ? 0 : lo].node;
+}
+
+void hashRingFree(struct hashRing *ring) {
+    free(ring->points);
+    ring->points = NULL;
+    ring->count = 0;
+}
@@ -0,0 +1,30 @@
+#ifndef HASHRING_H
+#define HASHRING_H
+
+#include <stdint.h>
+
+// anel de hash consistente: cada servidor ocupa várias posições (nós virtuais)
+// em um círculo de 64 bits e um nome de arquivo pertence ao primeiro servidor
+// depois do hash do nome. Acrescentar um servidor a N move só ~1/(N+1) dos
+// nomes (os que caem nas posições novas); os demais continuam onde estavam.
+#define HASH_RING_VNODES 160 // posições por servidor: espalha a carga de forma uniforme
+
+struct ringPoint {
+    uint64_t hash;
+    unsigned node;
+};
+
+struct hashRing {
+    struct ringPoint *points; // ordenados por hash
+    unsigned count;
+};
+
+uint64_t hashString(const char *s);
+// names identifica cada servidor (ex.: o endereço); a posição de um servidor
+// só depende do seu nome, não da ordem nem de quantos outros existem
+int hashRingInit(struct hashRing *ring, const char **names, unsigned nodes);
+// índice (em names) do servidor dono da chave
+unsigned hashRingLookup(const struct hashRing *ring, const char *key);
+void hashRingFree(struct hashRing *ring);
+
+#endif
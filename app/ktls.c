@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/tls.h>
+#include "ktls.h"
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+
+// ---------------------------------------------------------------------------
+// SHA-256 / HMAC / HKDF mínimos, só o necessário para o handshake
+
+struct sha256 {
+    uint32_t state[8];
+    uint64_t length; // bytes processados
+    unsigned char block[64];
+    size_t used;
+};
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256Block(struct sha256 *ctx, const unsigned char *p) {
+    uint32_t w[64], a, b, c, d, e, f, g, h;
+    for(int i = 0; i < 16; i++)
+        w[i] = (uint32_t)p[4*i] << 24 | (uint32_t)p[4*i+1] << 16 | (uint32_t)p[4*i+2] << 8 | p[4*i+3];
+    for(int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR(w[i-15], 7) ^ ROTR(w[i-15], 18) ^ (w[i-15] >> 3);
+        uint32_t s1 = ROTR(w[i-2], 17) ^ ROTR(w[i-2], 19) ^ (w[i-2] >> 10);
+        w[i] = w[i-16] + s0 + w[i-7] + s1;
+    }
+    a = ctx->state[0]; b = ctx->state[1]; c = ctx->state[2]; d = ctx->state[3];
+    e = ctx->state[4]; f = ctx->state[5]; g = ctx->state[6]; h = ctx->state[7];
+    for(int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    ctx->state[0] += a; ctx->state[1] += b; ctx->state[2] += c; ctx->state[3] += d;
+    ctx->state[4] += e; ctx->state[5] += f; ctx->state[6] += g; ctx->state[7] += h;
+}
+
+static void sha256Init(struct sha256 *ctx) {
+    static const uint32_t init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(ctx->state, init, sizeof(init));
+    ctx->length = 0;
+    ctx->used = 0;
+}
+
+static void sha256Update(struct sha256 *ctx, const void *data, size_t len) {
+    const unsigned char *p = data;
+    ctx->length += len;
+    while(len > 0) {
+        size_t n = 64 - ctx->used < len ? 64 - ctx->used : len;
+        memcpy(ctx->block + ctx->used, p, n);
+        ctx->used += n;
+        p += n;
+        len -= n;
+        if(ctx->used == 64) {
+            sha256Block(ctx, ctx->block);
+            ctx->used = 0;
+        }
+    }
+}
+
+static void sha256Final(struct sha256 *ctx, unsigned char *out) {
+    uint64_t bits = ctx->length * 8;
+    unsigned char pad = 0x80, zero = 0, len[8];
+    sha256Update(ctx, &pad, 1);
+    while(ctx->used != 56) sha256Update(ctx, &zero, 1);
+    for(int i = 0; i < 8; i++) len[i] = bits >> (56 - 8 * i);
+    sha256Update(ctx, len, 8);
+    for(int i = 0; i < 8; i++) {
+        out[4*i] = ctx->state[i] >> 24;
+        out[4*i+1] = ctx->state[i] >> 16;
+        out[4*i+2] = ctx->state[i] >> 8;
+        out[4*i+3] = ctx->state[i];
+    }
+}
+
+// HMAC-SHA256 sobre a concatenação de até dois pedaços de dados
+static void hmac(const unsigned char *key, size_t keyLen, const void *a, size_t aLen,
+                 const void *b, size_t bLen, unsigned char *out) {
+    unsigned char k[64], pad[64], inner[32];
+    struct sha256 ctx;
+    memset(k, 0, sizeof(k));
+    if(keyLen > 64) {
+        sha256Init(&ctx);
+        sha256Update(&ctx, key, keyLen);
+        sha256Final(&ctx, k);
+    } else memcpy(k, key, keyLen);
+
+    for(int i = 0; i < 64; i++) pad[i] = k[i] ^ 0x36;
+    sha256Init(&ctx);
+    sha256Update(&ctx, pad, 64);
+    sha256Update(&ctx, a, aLen);
+    sha256Update(&ctx, b, bLen);
+    sha256Final(&ctx, inner);
+
+    for(int i = 0; i < 64; i++) pad[i] = k[i] ^ 0x5c;
+    sha256Init(&ctx);
+    sha256Update(&ctx, pad, 64);
+    sha256Update(&ctx, inner, 32);
+    sha256Final(&ctx, out);
+}
+
+// HKDF-Expand com um único bloco (saída de até 32 bytes)
+static void hkdfExpand(const unsigned char *prk, const char *label, unsigned char *out, size_t len) {
+    unsigned char block[32], counter = 1;
+    unsigned char info[32];
+    size_t labelLen = strlen(label);
+    memcpy(info, label, labelLen);
+    info[labelLen] = counter;
+    hmac(prk, 32, info, labelLen + 1, NULL, 0, block);
+    memcpy(out, block, len);
+}
+
+// ---------------------------------------------------------------------------
+// handshake e instalação das chaves
+
+int ktlsLoadPsk(const char *path, struct ktlsPsk *psk) {
+    FILE *f = fopen(path, "rb");
+    if(f == NULL) return -1;
+    psk->len = fread(psk->key, 1, KTLS_PSK_MAX, f);
+    fclose(f);
+    return psk->len >= KTLS_PSK_MIN ? 0 : -1;
+}
+
+static void computeMac(const struct ktlsPsk *psk, const char *label, const unsigned char *randoms, unsigned char *mac) {
+    hmac(psk->key, psk->len, label, strlen(label), randoms, 2 * KTLS_RANDOM_LEN, mac);
+}
+
+// comparação em tempo constante
+static int macEqual(const unsigned char *a, const unsigned char *b) {
+    unsigned char diff = 0;
+    for(int i = 0; i < KTLS_MAC_LEN; i++) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+static void fillCryptoInfo(struct tls12_crypto_info_aes_gcm_128 *info, const unsigned char *material) {
+    // material: chave (16) + IV de 12 bytes, que o kTLS divide em salt (4) + iv (8)
+    memset(info, 0, sizeof(*info));
+    info->info.version = TLS_1_3_VERSION;
+    info->info.cipher_type = TLS_CIPHER_AES_GCM_128;
+    memcpy(info->key, material, TLS_CIPHER_AES_GCM_128_KEY_SIZE);
+    memcpy(info->salt, material + 16, TLS_CIPHER_AES_GCM_128_SALT_SIZE);
+    memcpy(info->iv, material + 16 + TLS_CIPHER_AES_GCM_128_SALT_SIZE, TLS_CIPHER_AES_GCM_128_IV_SIZE);
+}
+
+// deriva uma chave por sentido a partir da PSK e dos aleatórios e instala no socket
+static int install(int sock, const struct ktlsPsk *psk, const unsigned char *randoms, int isServer) {
+    unsigned char prk[32], c2s[28], s2c[28];
+    hmac(randoms, 2 * KTLS_RANDOM_LEN, psk->key, psk->len, NULL, 0, prk); // HKDF-Extract
+    hkdfExpand(prk, "ktls c2s", c2s, sizeof(c2s));
+    hkdfExpand(prk, "ktls s2c", s2c, sizeof(s2c));
+
+    struct tls12_crypto_info_aes_gcm_128 tx, rx;
+    fillCryptoInfo(&tx, isServer ? s2c : c2s);
+    fillCryptoInfo(&rx, isServer ? c2s : s2c);
+
+    int ret = -1;
+    if(setsockopt(sock, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0) perror("kTLS unavailable (TCP_ULP)");
+    else if(setsockopt(sock, SOL_TLS, TLS_TX, &tx, sizeof(tx)) != 0) perror("setsockopt(TLS_TX) failed");
+    else if(setsockopt(sock, SOL_TLS, TLS_RX, &rx, sizeof(rx)) != 0) perror("setsockopt(TLS_RX) failed");
+    else ret = 0;
+
+    // não deixa chaves na pilha
+    memset(prk, 0, sizeof(prk));
+    memset(c2s, 0, sizeof(c2s));
+    memset(s2c, 0, sizeof(s2c));
+    memset(&tx, 0, sizeof(tx));
+    memset(&rx, 0, sizeof(rx));
+    return ret;
+}
+
+// recv/send bloqueantes de tamanho exato (o cliente é síncrono)
+static int recvAll(int sock, unsigned char *buf, size_t len) {
+    size_t total = 0;
+    while(total < len) {
+        ssize_t n = recv(sock, buf + total, len - total, 0);
+        if(n <= 0) {
+            if(n < 0 && errno == EINTR) continue;
+            return -1;
+        }
+        total += n;
+    }
+    return 0;
+}
+
+int ktlsClientHandshake(int sock, const struct ktlsPsk *psk) {
+    unsigned char hello[KTLS_HELLO_LEN], randoms[2 * KTLS_RANDOM_LEN], reply[KTLS_SERVER_HELLO_LEN], mac[KTLS_MAC_LEN];
+
+    memcpy(hello, KTLS_MAGIC, KTLS_MAGIC_LEN);
+    if(getrandom(randoms, KTLS_RANDOM_LEN, 0) != KTLS_RANDOM_LEN) return -1;
+    memcpy(hello + KTLS_MAGIC_LEN, randoms, KTLS_RANDOM_LEN);
+    if(send(sock, hello, sizeof(hello), MSG_NOSIGNAL) != sizeof(hello)) return -1;
+
+    if(recvAll(sock, reply, sizeof(reply)) != 0) return -1;
+    memcpy(randoms + KTLS_RANDOM_LEN, reply, KTLS_RANDOM_LEN);
+    computeMac(psk, "ktls server finished", randoms, mac);
+    if(!macEqual(mac, reply + KTLS_RANDOM_LEN)) {
+        fprintf(stderr, "kTLS handshake failed: server does not know the key\n");
+        return -1;
+    }
+
+    computeMac(psk, "ktls client finished", randoms, mac);
+    if(send(sock, mac, sizeof(mac), MSG_NOSIGNAL) != sizeof(mac)) return -1;
+    return install(sock, psk, randoms, 0);
+}
+
+int ktlsServerHello(const struct ktlsPsk *psk, const unsigned char *hello,
+                    unsigned char *randoms, unsigned char *reply) {
+    if(memcmp(hello, KTLS_MAGIC, KTLS_MAGIC_LEN) != 0) return -1;
+    memcpy(randoms, hello + KTLS_MAGIC_LEN, KTLS_RANDOM_LEN);
+    if(getrandom(randoms + KTLS_RANDOM_LEN, KTLS_RANDOM_LEN, 0) != KTLS_RANDOM_LEN) return -1;
+
+    memcpy(reply, randoms + KTLS_RANDOM_LEN, KTLS_RANDOM_LEN);
+    computeMac(psk, "ktls server finished", randoms, reply + KTLS_RANDOM_LEN);
+    return 0;
+}
+
+int ktlsServerFinish(int sock, const struct ktlsPsk *psk, const unsigned char *randoms,
+                     const unsigned char *clientMac) {
+    unsigned char mac[KTLS_MAC_LEN];
+    computeMac(psk, "ktls client finished", randoms, mac);
+    if(!macEqual(mac, clientMac)) return -1;
+    return install(sock, psk, randoms, 1);
+}
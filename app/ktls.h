@@ -0,0 +1,46 @@
+#ifndef KTLS_H
+#define KTLS_H
+
+#include <stddef.h>
+
+// transporte cifrado com kTLS: um handshake mínimo com chave pré-compartilhada
+// (PSK) deriva as chaves da sessão, que são instaladas no kernel (TLS 1.3,
+// AES-128-GCM). Depois disso send()/recv() (e sendfile()/splice()) continuam
+// funcionando normalmente, mas o kernel cifra e decifra os registros.
+//
+// Handshake (em claro, antes de qualquer mensagem do protocolo):
+//   cliente -> servidor: "KTLS1" + 32 bytes aleatórios do cliente
+//   servidor -> cliente: 32 bytes aleatórios do servidor + MAC do servidor
+//   cliente -> servidor: MAC do cliente
+// Os MACs (HMAC-SHA256 com a PSK sobre os dois aleatórios) provam que os dois
+// lados conhecem a chave; as chaves de cada sentido saem de HKDF-SHA256.
+
+#define KTLS_MAGIC "KTLS1"
+#define KTLS_MAGIC_LEN 5
+#define KTLS_RANDOM_LEN 32
+#define KTLS_MAC_LEN 32
+#define KTLS_HELLO_LEN (KTLS_MAGIC_LEN + KTLS_RANDOM_LEN)
+#define KTLS_SERVER_HELLO_LEN (KTLS_RANDOM_LEN + KTLS_MAC_LEN)
+#define KTLS_PSK_MIN 16
+#define KTLS_PSK_MAX 64
+
+struct ktlsPsk {
+    unsigned char key[KTLS_PSK_MAX];
+    size_t len;
+};
+
+// lê a chave de um arquivo binário (ex.: head -c 32 /dev/urandom > psk)
+int ktlsLoadPsk(const char *path, struct ktlsPsk *psk);
+
+// lado do cliente: faz o handshake inteiro (bloqueante) e instala o kTLS
+int ktlsClientHandshake(int sock, const struct ktlsPsk *psk);
+
+// lado do servidor, em passos para caber no laço de eventos:
+// valida o hello do cliente e monta a resposta; randoms recebe os dois aleatórios
+int ktlsServerHello(const struct ktlsPsk *psk, const unsigned char *hello,
+                    unsigned char *randoms, unsigned char *reply);
+// confere o MAC final do cliente e instala o kTLS no socket
+int ktlsServerFinish(int sock, const struct ktlsPsk *psk, const unsigned char *randoms,
+                     const unsigned char *clientMac);
+
+#endif
@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "latency.h"
+
+uint64_t latencyNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void latencyAdd(struct latencyStats *stats, uint64_t nanoseconds) {
+    if(stats->count == stats->capacity) {
+        size_t capacity = stats->capacity ? stats->capacity * 2 : 1024;
+        uint64_t *samples = realloc(stats->samples, capacity * sizeof(*samples));
+        if(samples == NULL) return; // sem memória: a amostra fica de fora
+        stats->samples = samples;
+        stats->capacity = capacity;
+    }
+    stats->samples[stats->count++] = nanoseconds;
+}
+
+void latencyMerge(struct latencyStats *dst, const struct latencyStats *src) {
+    for(size_t i = 0; i < src->count; i++) latencyAdd(dst, src->samples[i]);
+}
+
+static int compareSamples(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// percentil pelo método do posto mais próximo, em microssegundos
+static double percentile(const struct latencyStats *stats, double p) {
+    size_t rank = (size_t)(p / 100.0 * stats->count + 0.5);
+    if(rank == 0) rank = 1;
+    if(rank > stats->count) rank = stats->count;
+    return stats->samples[rank - 1] / 1000.0;
+}
+
+void latencyReport(struct latencyStats *stats, const char *label, uint64_t elapsed) {
+    if(stats->count == 0) {
+        printf("%s: no samples\n", label);
+        return;
+    }
+    qsort(stats->samples, stats->count, sizeof(*stats->samples), compareSamples);
+    double seconds = elapsed / 1e9;
+    printf("%s: %zu in %.3f s (%.0f/s), latency us p50 %.1f p90 %.1f p99 %.1f p99.9 %.1f max %.1f\n",
+           label, stats->count, seconds, seconds > 0 ? stats->count / seconds : 0.0,
+           percentile(stats, 50), percentile(stats, 90), percentile(stats, 99), percentile(stats, 99.9),
+           stats->samples[stats->count - 1] / 1000.0);
+}
+
+void latencyFree(struct latencyStats *stats) {
+    free(stats->samples);
+    stats->samples = NULL;
+    stats->count = stats->capacity = 0;
+}
@@ -0,0 +1,24 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// amostras de latência (em nanossegundos) de uma medição, guardadas inteiras
+// para que os percentis sejam exatos
+struct latencyStats {
+    uint64_t *samples;
+    size_t count, capacity;
+};
+
+// relógio monotônico em nanossegundos
+uint64_t latencyNow(void);
+void latencyAdd(struct latencyStats *stats, uint64_t nanoseconds);
+// junta as amostras de src (de outra thread, por exemplo) em dst
+void latencyMerge(struct latencyStats *dst, const struct latencyStats *src);
+// ordena as amostras e imprime quantidade, vazão e p50/p90/p99/p99.9/máx em
+// microssegundos; elapsed é a duração da medição em nanossegundos
+void latencyReport(struct latencyStats *stats, const char *label, uint64_t elapsed);
+void latencyFree(struct latencyStats *stats);
+
+#endif
@@ -0,0 +1,46 @@
+#include <string.h>
+#include "message.h"
+
+#define END_MARK "\\end"
+#define END_LEN 4
+
+const char *const messageExtensions[MESSAGE_EXTENSIONS] = {"cpp", "txt", "c", "py", "tex", "java"};
+
+int parseFileMessage(const char *message, size_t len, struct fileMessage *msg) {
+    const char *p = message, *end = message + len;
+    memset(msg, 0, sizeof(*msg));
+
+    // como strtok(buffer, "."): pontos no início não fazem parte do nome
+    while(p < end && *p == '.') p++;
+    if(p == end) return MESSAGE_NO_NAME;
+    const char *dot = memchr(p, '.', end - p);
+    msg->name = p;
+    msg->nameLen = (dot ? dot : end) - p;
+
+    // depois do ponto: a primeira extensão da lista que for prefixo do resto
+    const char *rest = dot ? dot + 1 : end;
+    for(int i = 0; i < MESSAGE_EXTENSIONS; i++) {
+        size_t extLen = strlen(messageExtensions[i]);
+        if((size_t)(end - rest) >= extLen && memcmp(rest, messageExtensions[i], extLen) == 0) {
+            msg->extension = rest;
+            msg->extensionLen = extLen;
+            rest += extLen;
+            break;
+        }
+    }
+
+    // com uma extensão reconhecida, o conteúdo perde os 4 últimos bytes, que
+    // deveriam ser o "\end"; sem ela, o servidor sempre gravou o resto inteiro
+    msg->contents = rest;
+    msg->contentsLen = end - rest;
+    if(msg->extensionLen > 0 && msg->contentsLen >= END_LEN) msg->contentsLen -= END_LEN;
+    if(len < END_LEN || memcmp(end - END_LEN, END_MARK, END_LEN) != 0) return MESSAGE_NO_END;
+    if(msg->nameLen + 1 + msg->extensionLen >= MESSAGE_NAME_MAX) return MESSAGE_TOO_LONG;
+    return MESSAGE_OK;
+}
+
+int validExtension(const char *extension) {
+    for(int i = 0; i < MESSAGE_EXTENSIONS; i++)
+        if(strcmp(extension, messageExtensions[i]) == 0) return 1;
+    return 0;
+}
@@ -0,0 +1,37 @@
+#ifndef MESSAGE_H
+#define MESSAGE_H
+
+#include <stddef.h>
+
+// parser da mensagem de upload de um arquivo, "<nome>.<extensão><conteúdo>\end",
+// separado do servidor: não aloca, não copia e não faz I/O, só aponta para
+// pedaços da própria mensagem. É o que o harness de fuzzing exercita.
+#define MESSAGE_EXTENSIONS 6
+#define MESSAGE_NAME_MAX 256 // "<nome>.<extensão>" com o '\0', como UPLOAD_NAME_MAX
+
+// extensões aceitas, na ordem em que são testadas ("cpp" antes de "c")
+extern const char *const messageExtensions[MESSAGE_EXTENSIONS];
+
+enum {
+    MESSAGE_OK,
+    MESSAGE_NO_END,   // não termina em "\end": "error receiving file <nome>"
+    MESSAGE_NO_NAME,  // só pontos, nada que sirva de nome
+    MESSAGE_TOO_LONG, // "<nome>.<extensão>" não cabe em MESSAGE_NAME_MAX
+};
+
+struct fileMessage {
+    const char *name;      // até o primeiro '.' depois dos pontos iniciais
+    size_t nameLen;
+    const char *extension; // extensão reconhecida logo depois do '.' (extensionLen 0 se nenhuma)
+    size_t extensionLen;
+    const char *contents;  // o que sobra, sem o "\end"
+    size_t contentsLen;
+};
+
+// message tem len bytes, sem '\0' no meio (o servidor já cortou no terminador).
+// Preenche msg mesmo com MESSAGE_NO_END, para que o erro cite o nome
+int parseFileMessage(const char *message, size_t len, struct fileMessage *msg);
+// extensão (sem o ponto) aceita?
+int validExtension(const char *extension);
+
+#endif
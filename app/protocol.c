@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "protocol.h"
+
+int addrparse(const char *addrstr, const char *portstr, struct sockaddr_storage *storage) {
+    // AF_INET = IPv4, AF_INET6 = IPv6, AF_UNIX = socket local ("unix:<caminho>")
+    if(addrstr == NULL) return -1;
+
+    memset(storage, 0, sizeof(*storage));
+    if(strncmp(addrstr, "unix:", 5) == 0) {
+        struct sockaddr_un *addrun = (struct sockaddr_un *)storage;
+        const char *path = addrstr + 5;
+        if(*path == '\0' || strlen(path) >= sizeof(addrun->sun_path)) return -1;
+        addrun->sun_family = AF_UNIX;
+        strcpy(addrun->sun_path, path);
+        return 0;
+    }
+    if(portstr == NULL) return -1;
+
+    uint16_t port = (uint16_t)atoi(portstr); // unsigned short, 16 bits
+    if(port == 0) return -1;
+
+    port = htons(port); // converte para network byte order, host to network short
+
+    struct in_addr inaddr4; // IPv4, 32 bits
+    // inet presentation to network
+    if(inet_pton(AF_INET, addrstr, &inaddr4)) {
+        // converte para sockaddr_in (IPv4) e armazena em storage
+        struct sockaddr_in *addr4 = (struct sockaddr_in *)storage;
+        addr4->sin_family = AF_INET;
+        addr4->sin_port = port;
+        addr4->sin_addr = inaddr4;
+        return 0;
+    }
+
+    struct in6_addr inaddr6; // IPv6, 128 bits
+    if(inet_pton(AF_INET6, addrstr, &inaddr6)) {
+        // converte para sockaddr_in6 (IPv6) e armazena em storage
+        struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)storage;
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_port = port;
+        // addr6->sin6_addr = inaddr6; não funciona, pois inaddr6 é um array de 16 bytes
+        // memcpy(destino, origem, tamanho)
+        memcpy(&(addr6->sin6_addr), &inaddr6, sizeof(inaddr6));
+        return 0;
+    }
+
+    return -1;
+}
+
+int hostportparse(const char *target, struct sockaddr_storage *storage) {
+    if(strncmp(target, "unix:", 5) == 0) return addrparse(target, NULL, storage);
+    // a porta vem depois do último ':'; IPv6 pode vir entre colchetes
+    char host[64];
+    const char *colon = strrchr(target, ':');
+    if(colon == NULL || colon == target || (size_t)(colon - target) >= sizeof(host)) return -1;
+    size_t hostLen = colon - target;
+    if(target[0] == '[' && colon[-1] == ']') {
+        target++;
+        hostLen -= 2;
+    }
+    memcpy(host, target, hostLen);
+    host[hostLen] = '\0';
+    return addrparse(host, colon + 1, storage);
+}
+
+socklen_t addrlen(const struct sockaddr_storage *storage) {
+    if(storage->ss_family == AF_INET) return sizeof(struct sockaddr_in);
+    if(storage->ss_family == AF_INET6) return sizeof(struct sockaddr_in6);
+    return sizeof(struct sockaddr_un);
+}
+
+int sendAll(int sock, const void *data, size_t len) {
+    const char *p = data;
+    while(len > 0) {
+        ssize_t count = send(sock, p, len, MSG_NOSIGNAL);
+        if(count <= 0) return -1;
+        p += count;
+        len -= count;
+    }
+    return 0;
+}
+
+int recvResponse(int sock, char *buffer) {
+    size_t total = 0;
+    memset(buffer, 0, PROTOCOL_BUFSZ);
+    while(total < PROTOCOL_BUFSZ - 1) {
+        ssize_t count = recv(sock, buffer + total, 1, 0);
+        if(count <= 0) return -1;
+        if(buffer[total] == '\0') break;
+        total++;
+    }
+    if(total >= 4 && strcmp(&buffer[total-4], "\\end") == 0) buffer[total-4] = '\0';
+    return 0;
+}
+
+size_t rangeHeader(char *header, const char *id, unsigned index, unsigned count,
+                   uint64_t size, uint64_t offset, uint64_t length, const char *name) {
+    // "range <id> <índice> <total de faixas> <tamanho do arquivo> <offset> <bytes> <nome>\end"
+    return snprintf(header, PROTOCOL_BUFSZ, "range %s %u %u %llu %llu %llu %s\\end", id, index, count,
+                    (unsigned long long)size, (unsigned long long)offset, (unsigned long long)length, name) + 1;
+}
+
+size_t batchHeader(char *header, unsigned count, size_t indexSize, size_t dataSize) {
+    // "batch <arquivos> <bytes do índice> <bytes dos dados>\end"
+    return snprintf(header, PROTOCOL_BUFSZ, "batch %u %zu %zu\\end", count, indexSize, dataSize) + 1;
+}
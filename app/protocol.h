@@ -0,0 +1,29 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+
+// lado cliente do protocolo de upload, usado pelo client, pelo bench e pelo replay
+// (e pelo servidor, que se conecta aos seguidores como cliente). Toda mensagem termina em "\end" seguido de '\0'; as respostas também
+#define PROTOCOL_BUFSZ 500 // maior mensagem/resposta de texto
+
+// "<IP>" + "<porta>" (IPv4 ou IPv6) ou "unix:<caminho>" (portstr NULL)
+int addrparse(const char *addrstr, const char *portstr, struct sockaddr_storage *storage);
+// "host:porta", "[v6]:porta" ou "unix:<caminho>", em uma string só
+int hostportparse(const char *target, struct sockaddr_storage *storage);
+// tamanho real do endereço: bind/connect em AF_UNIX rejeita sizeof(sockaddr_storage)
+socklen_t addrlen(const struct sockaddr_storage *storage);
+
+// envia len bytes, repetindo enquanto o socket aceitar só uma parte
+int sendAll(int sock, const void *data, size_t len);
+// recebe uma resposta (terminada em '\0', até PROTOCOL_BUFSZ) e remove o "\end" do final
+int recvResponse(int sock, char *buffer);
+
+// cabeçalhos dos quadros binários, já com o '\0'. Retornam o tamanho a enviar
+size_t rangeHeader(char *header, const char *id, unsigned index, unsigned count,
+                   uint64_t size, uint64_t offset, uint64_t length, const char *name);
+size_t batchHeader(char *header, unsigned count, size_t indexSize, size_t dataSize);
+
+#endif
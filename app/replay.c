@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <libgen.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "latency.h"
+#include "protocol.h"
+#define BUFSZ PROTOCOL_BUFSZ
+#define NAME_MAX_LEN 256
+#define MAX_CLIENTS 1024
+#define PATTERN_SIZE (1 << 20) // conteúdo sintético, reaproveitado por todos os envios
+
+// repete uma captura feita com "client --record" contra um servidor: cada
+// replayer abre a sua conexão e refaz os uploads na ordem e no ritmo gravados
+// (ou N vezes mais rápido, ou sem esperar), com conteúdo gerado do mesmo
+// tamanho. Os nomes ganham o prefixo "r<replayer>-" para que replayers
+// concorrentes não disputem o mesmo arquivo.
+void usageExit(int argc, char **argv) {
+    printf("Replay usage: %s <capture> <server IP> <server port> [options]\n", argv[0]);
+    printf("              %s <capture> unix:<socket path> [options]\n", argv[0]);
+    printf("Ex: %s session.cap 127.0.0.1 51511 --clients 16 --speed max\n", argv[0]);
+    printf("Options:\n");
+    printf("  --clients <n>  concurrent replayers, each on its own connection (default 1)\n");
+    printf("  --speed <x>    replay at x times the recorded pace, or \"max\" for no pauses (default 1)\n");
+    exit(EXIT_FAILURE);
+}
+
+void msgExit(const char *msg) {
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+enum { EVENT_FILE, EVENT_UPLOAD, EVENT_BATCH, EVENT_KINDS };
+static const char *kindNames[EVENT_KINDS] = {"file", "upload", "batch"};
+
+struct event {
+    uint64_t at;    // microssegundos desde o início da sessão gravada
+    int kind;
+    uint64_t size;  // bytes do arquivo (file/upload) ou de todos os arquivos (batch)
+    unsigned count; // arquivos do lote
+    char name[NAME_MAX_LEN];
+};
+
+struct replayer {
+    pthread_t thread;
+    unsigned id;
+    struct latencyStats stats[EVENT_KINDS];
+    uint64_t bytes, errors;
+};
+
+static struct event *events = NULL;
+static size_t eventCount = 0;
+static struct sockaddr_storage server;
+static double speed = 1; // 0 = o mais rápido possível
+static uint64_t startNs;
+static char *pattern;
+
+static void loadCapture(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if(fp == NULL) msgExit("fopen() failed");
+    char line[BUFSZ], kind[16];
+    size_t capacity = 0;
+    unsigned lineNumber = 0;
+    while(fgets(line, sizeof(line), fp) != NULL) {
+        lineNumber++;
+        if(line[0] == '#' || line[0] == '\n') continue;
+        if(eventCount == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            events = realloc(events, capacity * sizeof(*events));
+            if(events == NULL) msgExit("realloc() failed");
+        }
+        struct event *event = &events[eventCount];
+        unsigned long long at, size;
+        char name[NAME_MAX_LEN] = "";
+        int fields = sscanf(line, "%llu %15s %llu %255s", &at, kind, &size, name);
+        event->at = at;
+        event->size = size;
+        if(fields == 4 && strcmp(kind, "file") == 0) event->kind = EVENT_FILE;
+        else if(fields == 4 && strcmp(kind, "upload") == 0) event->kind = EVENT_UPLOAD;
+        else if(fields == 4 && strcmp(kind, "batch") == 0) {
+            // "batch <arquivos> <bytes>": o primeiro número lido é a quantidade
+            event->kind = EVENT_BATCH;
+            event->count = size;
+            event->size = strtoull(name, NULL, 10);
+            if(event->count == 0) fields = 0;
+        }
+        else fields = 0;
+        if(fields != 4) {
+            printf("%s:%u: unknown event, skipped\n", path, lineNumber);
+            continue;
+        }
+        // só o nome vai para o servidor, sem os diretórios do cliente original
+        snprintf(event->name, NAME_MAX_LEN, "%s", basename(name));
+        eventCount++;
+    }
+    fclose(fp);
+}
+
+static int connectServer(void) {
+    int sock = socket(server.ss_family, SOCK_STREAM, 0);
+    if(sock < 0) return -1;
+    if(connect(sock, (struct sockaddr *)&server, addrlen(&server)) != 0) {
+        close(sock);
+        return -1;
+    }
+    if(server.ss_family != AF_UNIX) {
+        int enable = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+    return sock;
+}
+
+// envia len bytes de conteúdo sintético
+static int sendPattern(int sock, uint64_t len) {
+    while(len > 0) {
+        size_t chunk = len < PATTERN_SIZE ? len : PATTERN_SIZE;
+        if(sendAll(sock, pattern, chunk) != 0) return -1;
+        len -= chunk;
+    }
+    return 0;
+}
+
+// "<nome><conteúdo>\end": o prefixo do replayer pode tirar alguns bytes do conteúdo
+static int sendFile(int sock, const char *name, uint64_t size) {
+    char message[BUFSZ];
+    size_t nameLen = strlen(name), room = BUFSZ - nameLen - strlen("\\end") - 1;
+    if(nameLen + strlen("\\end") + 1 > BUFSZ) return -1;
+    if(size > room) size = room;
+    memcpy(message, name, nameLen);
+    memcpy(message + nameLen, pattern, size);
+    memcpy(message + nameLen + size, "\\end", strlen("\\end") + 1);
+    return sendAll(sock, message, nameLen + size + strlen("\\end") + 1);
+}
+
+// o upload paralelo original vira uma única faixa nesta conexão
+static int sendUpload(int sock, const struct replayer *replayer, unsigned seq, const char *name, uint64_t size) {
+    char header[BUFSZ], id[33];
+    snprintf(id, sizeof(id), "%06x%04x%06x", (unsigned)getpid() & 0xffffff, replayer->id & 0xffff, seq & 0xffffff);
+    size_t headerLen = rangeHeader(header, id, 0, 1, size, 0, size, name);
+    if(sendAll(sock, header, headerLen) != 0) return -1;
+    return sendPattern(sock, size);
+}
+
+// lote de count arquivos "r<k>-b<i>.txt" dividindo size bytes entre eles
+static int sendBatch(int sock, const struct replayer *replayer, unsigned count, uint64_t size) {
+    char *index = malloc((size_t)count * 48);
+    if(index == NULL) return -1;
+    size_t indexSize = 0;
+    for(unsigned i = 0; i < count; i++) {
+        uint64_t fileSize = size / count + (i < size % count);
+        indexSize += sprintf(index + indexSize, "%llu r%u-b%u.txt\n", (unsigned long long)fileSize, replayer->id, i);
+    }
+    char header[BUFSZ];
+    size_t headerLen = batchHeader(header, count, indexSize, size);
+    int failed = sendAll(sock, header, headerLen) != 0 || sendAll(sock, index, indexSize) != 0 ||
+                 sendPattern(sock, size) != 0;
+    free(index);
+    return failed ? -1 : 0;
+}
+
+// "error ..." ou um lote com algum arquivo recusado
+static int replyFailed(const char *reply) {
+    unsigned failed;
+    if(strncmp(reply, "error", 5) == 0) return 1;
+    return sscanf(reply, "batch %*u received %*u overwritten %u failed", &failed) == 1 && failed > 0;
+}
+
+// espera até o momento do evento na escala pedida
+static void waitFor(const struct event *event) {
+    if(speed == 0) return;
+    uint64_t target = startNs + (uint64_t)(event->at * 1000 / speed);
+    struct timespec ts = { .tv_sec = target / 1000000000ULL, .tv_nsec = target % 1000000000ULL };
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+}
+
+static void *replay(void *arg) {
+    struct replayer *replayer = arg;
+    int sock = connectServer();
+    if(sock < 0) {
+        perror("connect() failed");
+        replayer->errors = eventCount;
+        return NULL;
+    }
+    char name[NAME_MAX_LEN + 16], reply[BUFSZ];
+    for(size_t i = 0; i < eventCount; i++) {
+        const struct event *event = &events[i];
+        waitFor(event);
+        snprintf(name, sizeof(name), "r%u-%s", replayer->id, event->name);
+
+        uint64_t sent = latencyNow();
+        int failed;
+        if(event->kind == EVENT_FILE) failed = sendFile(sock, name, event->size);
+        else if(event->kind == EVENT_UPLOAD) failed = sendUpload(sock, replayer, i, name, event->size);
+        else failed = sendBatch(sock, replayer, event->count, event->size);
+        if(failed == 0) failed = recvResponse(sock, reply);
+        if(failed != 0) {
+            // conexão perdida: o resto da captura não tem como seguir neste replayer
+            replayer->errors += eventCount - i;
+            break;
+        }
+        if(replyFailed(reply)) replayer->errors++;
+        latencyAdd(&replayer->stats[event->kind], latencyNow() - sent);
+        replayer->bytes += event->size;
+    }
+    close(sock);
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    static struct option options[] = {
+        {"clients", required_argument, NULL, 'c'},
+        {"speed", required_argument, NULL, 'x'},
+        {NULL, 0, NULL, 0}
+    };
+    int clients = 1, opt;
+    while((opt = getopt_long(argc, argv, "c:x:", options, NULL)) != -1) {
+        if(opt == 'c') {
+            clients = atoi(optarg);
+            if(clients < 1 || clients > MAX_CLIENTS) usageExit(argc, argv);
+        }
+        else if(opt == 'x') {
+            speed = strcmp(optarg, "max") == 0 ? 0 : atof(optarg);
+            if(speed < 0 || (speed == 0 && strcmp(optarg, "max") != 0)) usageExit(argc, argv);
+        }
+        else usageExit(argc, argv);
+    }
+    int positional = argc - optind;
+    if(positional < 2 || positional > 3) usageExit(argc, argv);
+    if(addrparse(argv[optind + 1], positional == 3 ? argv[optind + 2] : NULL, &server) != 0) usageExit(argc, argv);
+    loadCapture(argv[optind]);
+    if(eventCount == 0) {
+        printf("%s has no events\n", argv[optind]);
+        exit(EXIT_FAILURE);
+    }
+
+    pattern = malloc(PATTERN_SIZE);
+    if(pattern == NULL) msgExit("malloc() failed");
+    for(int i = 0; i < PATTERN_SIZE; i++) pattern[i] = 'a' + i % 26;
+
+    struct replayer *replayers = calloc(clients, sizeof(*replayers));
+    startNs = latencyNow();
+    for(int i = 0; i < clients; i++) {
+        replayers[i].id = i;
+        if(pthread_create(&replayers[i].thread, NULL, replay, &replayers[i]) != 0) msgExit("pthread_create() failed");
+    }
+    uint64_t bytes = 0, errors = 0;
+    struct latencyStats stats[EVENT_KINDS] = {{0}}, all = {0};
+    for(int i = 0; i < clients; i++) {
+        pthread_join(replayers[i].thread, NULL);
+        bytes += replayers[i].bytes;
+        errors += replayers[i].errors;
+        for(int k = 0; k < EVENT_KINDS; k++) {
+            latencyMerge(&stats[k], &replayers[i].stats[k]);
+            latencyMerge(&all, &replayers[i].stats[k]);
+            latencyFree(&replayers[i].stats[k]);
+        }
+    }
+    uint64_t elapsed = latencyNow() - startNs;
+
+    printf("%d clients x %zu events, %.1f MB in %.3f s (%.1f MB/s), %llu errors\n", clients, eventCount,
+           bytes / 1e6, elapsed / 1e9, bytes / 1e6 / (elapsed / 1e9), (unsigned long long)errors);
+    latencyReport(&all, "all", elapsed);
+    for(int k = 0; k < EVENT_KINDS; k++) {
+        if(stats[k].count > 0) latencyReport(&stats[k], kindNames[k], elapsed);
+        latencyFree(&stats[k]);
+    }
+    latencyFree(&all);
+    free(replayers);
+    free(pattern);
+    free(events);
+    exit(EXIT_SUCCESS);
+}
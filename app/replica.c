@@ -0,0 +1,537 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/random.h>
+#include "replica.h"
+#include "batch.h"
+#include "protocol.h"
+
+#define REPLY_BUFSZ 500
+#define MAX_SEGMENTS 64 // pedaços por writev
+
+// bytes de um quadro, compartilhados pelas filas de todos os seguidores
+struct replData {
+    unsigned refs;
+    char *bytes;
+    size_t len;
+    int mapped; // mmap do arquivo (quadro "range") ou memória alocada
+};
+
+struct replSegment {
+    struct replSegment *next;
+    struct replData *data;
+    size_t offset; // quanto deste pedaço já foi enviado
+};
+
+enum { REPLICA_DOWN, REPLICA_CONNECTING, REPLICA_UP };
+
+struct replica {
+    char target[64];
+    struct sockaddr_storage addr;
+    int fd;
+    int state;
+    struct replSegment *head, *tail; // fila de saída
+    size_t queued;                   // bytes ainda na fila
+    int wantWrite;                   // EPOLLOUT ligado
+    uint64_t firstSeq;  // primeiro quadro enviado nesta conexão
+    uint64_t nextReply; // quadro confirmado pela próxima resposta
+    unsigned pings;     // "ping" sem "pong" ainda
+    int sent;           // algo foi para a fila desde o último keepalive
+    uint64_t connectedAt; // tick em que a conexão atual foi aberta
+    char in[REPLY_BUFSZ];
+    size_t used;
+    struct twTimer timer;     // reconexão
+    struct twTimer keepalive; // "ping" quando a conexão fica quieta
+};
+
+// resposta de uma escrita esperando as confirmações dos seguidores
+struct replicaWaiter {
+    struct replicaWaiter *next, *prev;
+    void *owner;
+    char *okReply, *errorReply;
+    uint64_t first, last; // quadros que levam os arquivos desta escrita
+    unsigned okMask, failMask; // bit i = seguidor i confirmou / falhou
+};
+
+static struct replica replicas[REPLICA_MAX];
+static int replicaTotal = 0;
+static int epfd = -1;
+static int ackPolicy = ACK_LOCAL;
+static struct timerWheel *wheel = NULL;
+static uint64_t reconnectDelay;
+static uint64_t keepaliveDelay;
+static replicaRelease release;
+static struct replicaWaiter *waiters = NULL;
+// esperas decididas cujo dono ainda não foi avisado (ver releaseDecided)
+static struct replicaWaiter *decided = NULL;
+
+// número do próximo quadro; enquanto há arquivos acumulados, é o do lote em montagem
+static uint64_t nextSeq = 1;
+// prefixo aleatório dos ids dos quadros "range": não colidem entre execuções do primário
+static char idPrefix[17];
+
+// quadro "batch" em montagem
+static char *pendingIndex = NULL, *pendingData = NULL;
+static size_t pendingIndexSize = 0, pendingDataSize = 0, pendingCapacity = 0;
+static unsigned pendingCount = 0;
+
+static void replicaConnect(struct replica *r);
+
+int replicaAdd(const char *target) {
+    if(replicaTotal == REPLICA_MAX || strlen(target) >= sizeof(replicas[0].target)) return -1;
+    struct replica *r = &replicas[replicaTotal];
+    memset(r, 0, sizeof(*r));
+    strcpy(r->target, target);
+
+    if(hostportparse(target, &r->addr) != 0) return -1;
+    r->fd = -1;
+    replicaTotal++;
+    return 0;
+}
+
+int replicaCount(void) {
+    return replicaTotal;
+}
+
+static void dataRelease(struct replData *data) {
+    if(--data->refs > 0) return;
+    if(data->mapped) munmap(data->bytes, data->len);
+    else free(data->bytes);
+    free(data);
+}
+
+static struct replData *dataNew(char *bytes, size_t len, int mapped) {
+    struct replData *data = malloc(sizeof(*data));
+    data->refs = 1; // referência de quem criou, liberada depois de enfileirar
+    data->bytes = bytes;
+    data->len = len;
+    data->mapped = mapped;
+    return data;
+}
+
+static void waiterFinish(struct replicaWaiter *w, int ok) {
+    if(w->prev) w->prev->next = w->next;
+    else waiters = w->next;
+    if(w->next) w->next->prev = w->prev;
+    if(!ok) {
+        free(w->okReply);
+        w->okReply = w->errorReply;
+        w->errorReply = NULL;
+    }
+    w->next = decided;
+    decided = w;
+}
+
+// avisa os donos das esperas decididas. Só roda no nível de cima do laço
+// (replicaEvent, replicaFlush): o aviso volta a processar a conexão do dono,
+// que pode enfileirar novos quadros e decidir outras esperas
+static void releaseDecided(void) {
+    while(decided) {
+        struct replicaWaiter *w = decided;
+        decided = w->next;
+        if(w->owner) release(w->owner, w->okReply);
+        free(w->okReply);
+        free(w->errorReply);
+        free(w);
+    }
+}
+
+// decide a espera assim que houver confirmações suficientes, ou assim que
+// elas não forem mais possíveis. Retorna 1 se decidiu, com *ok preenchido
+static int waiterDecided(const struct replicaWaiter *w, int *ok) {
+    int needed = ackPolicy == ACK_ONE ? 1 : replicaTotal;
+    int confirmed = __builtin_popcount(w->okMask), failed = __builtin_popcount(w->failMask);
+    if(confirmed >= needed) *ok = 1;
+    else if(replicaTotal - failed < needed) *ok = 0;
+    else return 0;
+    return 1;
+}
+
+// resposta do seguidor i ao quadro seq: atualiza todas as esperas que dependem dele
+static void waitersUpdate(int i, uint64_t seq, int positive) {
+    struct replicaWaiter *w = waiters, *next;
+    for(; w != NULL; w = next) {
+        next = w->next;
+        unsigned bit = 1u << i;
+        if(!positive && seq >= w->first && seq <= w->last) w->failMask |= bit;
+        // as respostas chegam em ordem: confirmar o último quadro confirma a escrita
+        else if(positive && seq >= w->last && !(w->failMask & bit)) w->okMask |= bit;
+        int ok;
+        if(waiterDecided(w, &ok)) waiterFinish(w, ok);
+    }
+}
+
+static void scheduleReconnect(struct replica *r) {
+    timerAdd(wheel, &r->timer, wheel->now + reconnectDelay);
+}
+
+static void replicaLost(struct replica *r, const char *why) {
+    printf("[log] replica %s lost (%s)\n", r->target, why);
+    epoll_ctl(epfd, EPOLL_CTL_DEL, r->fd, NULL);
+    close(r->fd);
+    r->fd = -1;
+    r->state = REPLICA_DOWN;
+    while(r->head) {
+        struct replSegment *segment = r->head;
+        r->head = segment->next;
+        dataRelease(segment->data);
+        free(segment);
+    }
+    r->tail = NULL;
+    r->queued = 0;
+    r->used = 0;
+    r->pings = 0;
+    timerDel(&r->keepalive);
+
+    // quadros sem resposta deste seguidor não serão confirmados
+    int i = r - replicas;
+    struct replicaWaiter *w = waiters, *next;
+    for(; w != NULL; w = next) {
+        next = w->next;
+        if(!(w->okMask & (1u << i))) w->failMask |= 1u << i;
+        int ok;
+        if(waiterDecided(w, &ok)) waiterFinish(w, ok);
+    }
+    scheduleReconnect(r);
+}
+
+// o seguidor fechou uma conexão que estava de pé (ex.: prazo de ociosidade dele):
+// reconecta já, para os próximos quadros não se perderem esperando o timer.
+// Uma conexão que cai logo depois de abrir espera o intervalo normal
+static void replicaClosed(struct replica *r) {
+    int wasStable = wheel->now - r->connectedAt >= reconnectDelay;
+    replicaLost(r, "closed");
+    if(!wasStable) return;
+    timerDel(&r->timer);
+    replicaConnect(r);
+}
+
+static void setWantWrite(struct replica *r, int want) {
+    if(r->wantWrite == want) return;
+    struct epoll_event ev = { .events = EPOLLIN | (want ? EPOLLOUT : 0), .data.ptr = r };
+    epoll_ctl(epfd, EPOLL_CTL_MOD, r->fd, &ev);
+    r->wantWrite = want;
+}
+
+// escreve o quanto o socket aceitar da fila; o resto sai quando ele ficar livre (EPOLLOUT)
+static int flushQueue(struct replica *r) {
+    while(r->head) {
+        struct iovec iov[MAX_SEGMENTS];
+        int n = 0;
+        for(struct replSegment *s = r->head; s != NULL && n < MAX_SEGMENTS; s = s->next, n++) {
+            iov[n].iov_base = s->data->bytes + s->offset;
+            iov[n].iov_len = s->data->len - s->offset;
+        }
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = n;
+        ssize_t count = sendmsg(r->fd, &msg, MSG_NOSIGNAL);
+        if(count < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                setWantWrite(r, 1);
+                return 0;
+            }
+            if(errno == EINTR) continue;
+            replicaLost(r, strerror(errno));
+            return -1;
+        }
+        r->queued -= count;
+        while(r->head && count >= r->head->data->len - r->head->offset) {
+            struct replSegment *segment = r->head;
+            count -= segment->data->len - segment->offset;
+            r->head = segment->next;
+            dataRelease(segment->data);
+            free(segment);
+        }
+        if(r->head) r->head->offset += count;
+        else r->tail = NULL;
+    }
+    setWantWrite(r, 0);
+    return 0;
+}
+
+// acrescenta pedaços de um quadro na fila de um seguidor. Enquanto a conexão
+// ainda está sendo aberta eles só esperam; replicaUp envia
+static void queueFrame(struct replica *r, struct replData **parts, int n) {
+    for(int p = 0; p < n; p++) {
+        struct replSegment *segment = malloc(sizeof(*segment));
+        segment->next = NULL;
+        segment->data = parts[p];
+        segment->offset = 0;
+        parts[p]->refs++;
+        if(r->tail) r->tail->next = segment;
+        else r->head = segment;
+        r->tail = segment;
+        r->queued += parts[p]->len;
+    }
+    r->sent = 1;
+    if(r->queued > REPLICA_MAX_QUEUED) replicaLost(r, "too far behind");
+    else if(r->state == REPLICA_UP && !r->wantWrite) flushQueue(r);
+}
+
+// acrescenta um quadro na fila de cada seguidor conectado ou conectando
+static void enqueue(struct replData **parts, int n) {
+    for(int i = 0; i < replicaTotal; i++)
+        if(replicas[i].state != REPLICA_DOWN) queueFrame(&replicas[i], parts, n);
+    for(int p = 0; p < n; p++) dataRelease(parts[p]);
+}
+
+static void flushPending(void) {
+    if(pendingCount == 0) return;
+    char header[REPLY_BUFSZ];
+    int len = snprintf(header, sizeof(header), "batch %u %zu %zu\\end", pendingCount, pendingIndexSize, pendingDataSize);
+    struct replData *parts[3] = {
+        dataNew(strdup(header), len + 1, 0),
+        dataNew(pendingIndex, pendingIndexSize, 0),
+        dataNew(pendingData, pendingDataSize, 0),
+    };
+    enqueue(parts, 3);
+    nextSeq++;
+    pendingIndex = pendingData = NULL;
+    pendingIndexSize = pendingDataSize = pendingCapacity = 0;
+    pendingCount = 0;
+}
+
+void replicaFlush(void) {
+    flushPending();
+    releaseDecided();
+}
+
+uint64_t replicaShip(const char *name) {
+    if(replicaTotal == 0) return 0;
+    int fd = open(name, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) return 0;
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+    size_t size = st.st_size;
+
+    if(size < REPLICA_RANGE_MIN) {
+        // arquivo pequeno: entra no lote desta volta do laço
+        if(pendingCount == BATCH_MAX_FILES || pendingIndexSize + pendingDataSize + size + REPLY_BUFSZ > BATCH_MAX_BYTES)
+            flushPending();
+        if(pendingDataSize + size > pendingCapacity) {
+            while(pendingCapacity < pendingDataSize + size) pendingCapacity = pendingCapacity ? 2 * pendingCapacity : 64 * 1024;
+            pendingData = realloc(pendingData, pendingCapacity);
+        }
+        size_t got = 0;
+        while(got < size) {
+            ssize_t count = read(fd, pendingData + pendingDataSize + got, size - got);
+            if(count <= 0) break;
+            got += count;
+        }
+        close(fd);
+        char line[REPLY_BUFSZ];
+        int lineLen = snprintf(line, sizeof(line), "%zu %s\n", got, name);
+        pendingIndex = realloc(pendingIndex, pendingIndexSize + lineLen);
+        memcpy(pendingIndex + pendingIndexSize, line, lineLen);
+        pendingIndexSize += lineLen;
+        pendingDataSize += got;
+        pendingCount++;
+        return nextSeq;
+    }
+
+    // arquivo grande: quadro "range" próprio, enviado direto do mapeamento.
+    // O lote acumulado sai antes para os quadros continuarem na ordem dos números
+    flushPending();
+    char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) return 0;
+    madvise(map, size, MADV_SEQUENTIAL);
+    char header[REPLY_BUFSZ];
+    int len = snprintf(header, sizeof(header), "range %s%016llx 0 1 %zu 0 %zu %s\\end",
+                       idPrefix, (unsigned long long)nextSeq, size, size, name);
+    struct replData *parts[2] = { dataNew(strdup(header), len + 1, 0), dataNew(map, size, 1) };
+    enqueue(parts, 2);
+    return nextSeq++;
+}
+
+struct replicaWaiter *replicaDefer(void *owner, char *reply, const char *errorReply,
+                                   uint64_t first, uint64_t last) {
+    if(ackPolicy == ACK_LOCAL || replicaTotal == 0) return NULL;
+    struct replicaWaiter w;
+    memset(&w, 0, sizeof(w));
+    w.owner = owner;
+    w.first = first;
+    w.last = last;
+    // seguidor fora do ar (ou que conectou depois destes quadros) não vai confirmá-los
+    for(int i = 0; i < replicaTotal; i++)
+        if(first == 0 || replicas[i].state == REPLICA_DOWN || replicas[i].firstSeq > first) w.failMask |= 1u << i;
+    int ok;
+    if(waiterDecided(&w, &ok)) {
+        if(!ok) strcpy(reply, errorReply);
+        return NULL;
+    }
+
+    struct replicaWaiter *waiter = malloc(sizeof(*waiter));
+    *waiter = w;
+    waiter->okReply = strdup(reply);
+    waiter->errorReply = strdup(errorReply);
+    waiter->prev = NULL;
+    waiter->next = waiters;
+    if(waiters) waiters->prev = waiter;
+    waiters = waiter;
+    return waiter;
+}
+
+void replicaDetach(struct replicaWaiter *waiter) {
+    waiter->owner = NULL;
+}
+
+static void replicaUp(struct replica *r) {
+    r->state = REPLICA_UP;
+    r->wantWrite = 0;
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = r };
+    epoll_ctl(epfd, EPOLL_CTL_MOD, r->fd, &ev);
+    printf("[log] replica %s connected\n", r->target);
+    r->sent = 0;
+    timerAdd(wheel, &r->keepalive, wheel->now + keepaliveDelay);
+    // quadros que chegaram enquanto a conexão abria
+    if(r->head) flushQueue(r);
+}
+
+static void replicaConnect(struct replica *r) {
+    r->fd = socket(r->addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(r->fd < 0) {
+        scheduleReconnect(r);
+        return;
+    }
+    // conexão não bloqueante: o laço de eventos não para esperando um seguidor fora do ar
+    struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = r };
+    epoll_ctl(epfd, EPOLL_CTL_ADD, r->fd, &ev);
+    r->state = REPLICA_CONNECTING;
+    r->wantWrite = 1; // EPOLLOUT já está ligado esperando o connect
+    // os quadros enfileirados a partir daqui seguem por esta conexão
+    r->firstSeq = r->nextReply = nextSeq;
+    r->connectedAt = wheel->now;
+    if(connect(r->fd, (struct sockaddr *)&r->addr, addrlen(&r->addr)) == 0) replicaUp(r);
+    else if(errno != EINPROGRESS) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, r->fd, NULL);
+        close(r->fd);
+        r->fd = -1;
+        r->state = REPLICA_DOWN;
+        scheduleReconnect(r);
+    }
+}
+
+static void reconnectTimer(struct twTimer *timer, void *arg) {
+    replicaConnect(arg);
+}
+
+// sem nada enviado desde a última vez, manda um "ping": o seguidor trata a
+// conexão como a de qualquer cliente e a fecharia no prazo de ociosidade dele
+static void keepaliveTimer(struct twTimer *timer, void *arg) {
+    struct replica *r = arg;
+    if(r->state != REPLICA_UP) return;
+    if(!r->sent) {
+        static const char ping[] = "ping\\end";
+        struct replData *part = dataNew(strdup(ping), sizeof(ping), 0);
+        r->pings++;
+        queueFrame(r, &part, 1);
+        dataRelease(part);
+        if(r->state != REPLICA_UP) return;
+    }
+    r->sent = 0;
+    timerAdd(wheel, &r->keepalive, wheel->now + keepaliveDelay);
+}
+
+void replicaStart(int epollFd, struct timerWheel *timerWheel, int ack, uint64_t reconnectTicks,
+                  uint64_t keepaliveTicks, replicaRelease releaseFn) {
+    epfd = epollFd;
+    wheel = timerWheel;
+    ackPolicy = ack;
+    reconnectDelay = reconnectTicks;
+    keepaliveDelay = keepaliveTicks;
+    release = releaseFn;
+
+    unsigned char random[8];
+    if(getrandom(random, sizeof(random), 0) != sizeof(random)) memset(random, 0, sizeof(random));
+    for(int i = 0; i < sizeof(random); i++) sprintf(&idPrefix[2*i], "%02x", random[i]);
+
+    for(int i = 0; i < replicaTotal; i++) {
+        timerInit(&replicas[i].timer, reconnectTimer, &replicas[i]);
+        timerInit(&replicas[i].keepalive, keepaliveTimer, &replicas[i]);
+        replicaConnect(&replicas[i]);
+    }
+}
+
+int replicaIsTag(const void *ptr) {
+    return ptr >= (const void *)replicas && ptr < (const void *)(replicas + replicaTotal);
+}
+
+// uma resposta do seguidor confirma (ou não) o próximo quadro da fila dele
+static void handleReply(struct replica *r, const char *reply) {
+    // resposta de um keepalive: não corresponde a nenhum quadro
+    if(r->pings > 0 && strncmp(reply, "pong", 4) == 0) {
+        r->pings--;
+        return;
+    }
+    if(r->nextReply >= nextSeq) {
+        replicaLost(r, "unexpected reply");
+        return;
+    }
+    unsigned received, overwritten, failed;
+    int positive = strncmp(reply, "file ", 5) == 0;
+    if(sscanf(reply, "batch %u received %u overwritten %u failed", &received, &overwritten, &failed) == 3)
+        positive = failed == 0;
+    if(!positive) printf("[log] replica %s: %s", r->target, reply);
+    waitersUpdate(r - replicas, r->nextReply++, positive);
+}
+
+static void replicaIo(struct replica *r, uint32_t events) {
+    if(r->state == REPLICA_CONNECTING) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        getsockopt(r->fd, SOL_SOCKET, SO_ERROR, &error, &len);
+        if(error != 0) replicaLost(r, strerror(error));
+        else replicaUp(r);
+        return;
+    }
+    if(events & EPOLLOUT) {
+        if(flushQueue(r) != 0) return;
+    }
+    if(events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        ssize_t count = recv(r->fd, r->in + r->used, sizeof(r->in) - r->used, 0);
+        if(count == 0) {
+            replicaClosed(r);
+            return;
+        }
+        if(count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            replicaLost(r, strerror(errno));
+            return;
+        }
+        if(count < 0) return;
+        r->used += count;
+        // respostas terminadas em '\0', como as que os clientes recebem
+        char *end;
+        while(r->state == REPLICA_UP && (end = memchr(r->in, '\0', r->used)) != NULL) {
+            size_t len = end - r->in + 1;
+            char reply[REPLY_BUFSZ];
+            memcpy(reply, r->in, len);
+            r->used -= len;
+            memmove(r->in, r->in + len, r->used);
+            // remove o "\end" do final
+            if(len >= 5 && strcmp(reply + len - 5, "\\end") == 0) reply[len - 5] = '\0';
+            handleReply(r, reply);
+        }
+        if(r->state == REPLICA_UP && r->used == sizeof(r->in)) replicaLost(r, "reply too long");
+    }
+}
+
+void replicaEvent(void *ptr, uint32_t events) {
+    replicaIo(ptr, events);
+    releaseDecided();
+}
@@ -0,0 +1,58 @@
+#ifndef REPLICA_H
+#define REPLICA_H
+
+#include <stdint.h>
+#include "timerwheel.h"
+
+// replicação dos arquivos aceitos para servidores seguidores (--replica).
+// O primário fala com cada seguidor pelo mesmo protocolo dos clientes: os
+// arquivos pequenos aceitos em uma volta do laço de eventos vão juntos em um
+// quadro "batch" e os grandes em um quadro "range". Os quadros seguem em fila
+// (pipeline), sem esperar a resposta do anterior; como cada seguidor responde
+// na ordem, a n-ésima resposta confirma o n-ésimo quadro enviado a ele.
+//
+// A política de confirmação (--ack) decide quando o cliente recebe o "file ...
+// received": na hora (local), depois de um seguidor confirmar (one) ou de
+// todos (all). Um seguidor que cai perde os quadros do período em que ficou
+// fora (não há ressincronização); o primário tenta reconectar periodicamente.
+// Para o seguidor, a conexão é a de um cliente qualquer: quando ela fica quieta
+// o primário manda "ping" (respondido com "pong") antes que o prazo de
+// ociosidade do seguidor a feche, e se ainda assim ela for fechada, reconecta
+// na hora. Os quadros aceitos enquanto a conexão abre esperam na fila dela.
+#define REPLICA_MAX 8
+#define REPLICA_RANGE_MIN (1 << 20)     // a partir daqui o arquivo vai em um quadro "range" próprio
+#define REPLICA_MAX_QUEUED (256 << 20)  // seguidor lento demais é desconectado
+
+enum { ACK_LOCAL, ACK_ONE, ACK_ALL };
+
+// chamada quando a confirmação de uma escrita pode ir para o cliente
+typedef void (*replicaRelease)(void *owner, const char *reply);
+
+// "host:porta", "[v6]:porta" ou "unix:<caminho>". Só antes de replicaStart
+int replicaAdd(const char *target);
+int replicaCount(void);
+// conecta aos seguidores; reconnectTicks é a espera entre tentativas e
+// keepaliveTicks o silêncio máximo em uma conexão antes de um "ping"
+void replicaStart(int epfd, struct timerWheel *wheel, int ack, uint64_t reconnectTicks,
+                  uint64_t keepaliveTicks, replicaRelease release);
+
+// enfileira um arquivo já gravado (pelo nome) para todos os seguidores.
+// Retorna o número do quadro que o carrega, ou 0 se não foi possível lê-lo
+uint64_t replicaShip(const char *name);
+// segura a resposta reply de uma escrita até que os quadros [first, last]
+// estejam confirmados conforme a política; então chama release com reply (ou
+// errorReply se não houver confirmações suficientes). Retorna NULL se a
+// decisão já pode ser tomada (--ack local, seguidores fora do ar): nesse caso
+// reply já contém a resposta a enviar
+struct replicaWaiter *replicaDefer(void *owner, char *reply, const char *errorReply,
+                                   uint64_t first, uint64_t last);
+// o dono da resposta foi embora: a espera continua, mas ninguém é avisado
+void replicaDetach(struct replicaWaiter *waiter);
+
+// envia o quadro com os arquivos pequenos acumulados; chamada ao fim de cada volta do laço
+void replicaFlush(void);
+// epoll_event.data.ptr pertence a um seguidor?
+int replicaIsTag(const void *ptr);
+void replicaEvent(void *ptr, uint32_t events);
+
+#endif
@@ -1,19 +1,72 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+#include <signal.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include "timerwheel.h"
+#include "fdpass.h"
+#include "shmring.h"
+#include "ktls.h"
+#include "upload.h"
+#include "batch.h"
+#include "replica.h"
+#include "affinity.h"
+#include "trace.h"
+#include "message.h"
+#include "protocol.h"
 #define BUFSZ 500
+#define MAX_EVENTS 64
+#define TICK_MS 100 // resolução da roda de timers
+#define RANGE_BUFSZ (64 * 1024) // leitura direta do corpo das faixas de upload
+
+// prazos padrão (em segundos) de cada fase de uma conexão
+#define DEFAULT_IDLE_TIMEOUT 60
+#define DEFAULT_HEADER_TIMEOUT 10
+#define DEFAULT_BODY_TIMEOUT 30
+#define DEFAULT_MAX_UPLOAD_MB 4096 // maior arquivo de um upload em faixas
+#define DEFAULT_UPLOAD_EXPIRY (24 * 3600) // upload em faixas abandonado sai do disco
+#define UPLOAD_SWEEP_SECONDS 60 // intervalo entre as varreduras dos uploads abandonados
+#define DEFAULT_REPLICA_KEEPALIVE 20 // silêncio máximo na conexão com um seguidor
 
 void usageExit(int argc, char **argv) {
-    printf("Server usage: %s <v4|v6> <server port>\n", argv[0]);
+    printf("Server usage: %s <v4|v6> <server port> [options]\n", argv[0]);
+    printf("       %s unix:<socket path> [options]\n", argv[0]);
     printf("Ex: %s v4 51511\n", argv[0]);
     printf("Ex: %s v6 51511\n", argv[0]);
+    printf("Ex: %s unix:/tmp/server.sock\n", argv[0]);
+    printf("Options:\n");
+    printf("  --idle-timeout <s>    close connections idle between commands (default %d)\n", DEFAULT_IDLE_TIMEOUT);
+    printf("  --header-timeout <s>  max time to receive a file name (default %d)\n", DEFAULT_HEADER_TIMEOUT);
+    printf("  --body-timeout <s>    max time to receive a whole message (default %d)\n", DEFAULT_BODY_TIMEOUT);
+    printf("  --upgrade-socket <p>  accept hot-upgrade requests on Unix socket <p>\n");
+    printf("  --takeover <p>        take the listening socket over from the server at <p>\n");
+    printf("  --takeover-clients    with --takeover, also take the idle client connections\n");
+    printf("  --psk <file>          require the kTLS handshake with this pre-shared key\n");
+    printf("  --max-upload <MiB>    largest file accepted as parallel ranges (default %d)\n", DEFAULT_MAX_UPLOAD_MB);
+    printf("  --upload-expiry <s>   delete the partial file of a range upload without progress for this long (default %d)\n", DEFAULT_UPLOAD_EXPIRY);
+    printf("  --writers <n>         threads writing the files of a batch upload (default %d)\n", BATCH_DEFAULT_WRITERS);
+    printf("  --replica <addr>      replicate accepted files to the server at host:port, [v6]:port or unix:<p> (repeatable)\n");
+    printf("  --replica-keepalive <s> ping a replica after this long without traffic; keep it below the\n");
+    printf("                        replicas' --idle-timeout (default %d)\n", DEFAULT_REPLICA_KEEPALIVE);
+    printf("  --ack <policy>        confirm a file after it is stored locally, on one replica or on all (local|one|all, default local)\n");
+    printf("  --cpus <list>         pin the event loop to the first CPU of <list> (e.g. 0,2-5) and the writers to the others\n");
+    printf("  --placement <p>       with --cpus, keep the writers on the event loop's NUMA node or spread them over all nodes (local|spread, default local)\n");
+    printf("  --busy-poll <us>      set SO_BUSY_POLL on client sockets and spin on epoll instead of sleeping (uses a whole core)\n");
+    printf("  --trace <n>           time each phase of every upload and print every n-th one; SIGUSR1 prints the\n");
+    printf("                        per-phase histograms, SIGUSR2 turns tracing on or off while running\n");
     exit(EXIT_FAILURE);
 }
 
@@ -23,14 +76,24 @@ void msgExit(const char *msg) {
 }
 
 int serverAddrInit(const char *proto, const char *portstr, struct sockaddr_storage *storage) {
-    // AF_INET = IPv4, AF_INET6 = IPv6
-    if(proto == NULL || portstr == NULL) return -1;
+    // AF_INET = IPv4, AF_INET6 = IPv6, AF_UNIX = socket local ("unix:<caminho>")
+    if(proto == NULL) return -1;
+
+    memset(storage, 0, sizeof(*storage));
+    if(strncmp(proto, "unix:", 5) == 0) {
+        struct sockaddr_un *addrun = (struct sockaddr_un *)storage;
+        const char *path = proto + 5;
+        if(*path == '\0' || strlen(path) >= sizeof(addrun->sun_path)) return -1;
+        addrun->sun_family = AF_UNIX;
+        strcpy(addrun->sun_path, path);
+        return 0;
+    }
+    if(portstr == NULL) return -1;
 
     uint16_t port = (uint16_t)atoi(portstr); // unsigned short, 16 bits
     if(port == 0) return -1;
     port = htons(port);
 
-    memset(storage, 0, sizeof(*storage));
     if(strcmp(proto, "v4") == 0) {
         struct sockaddr_in *addr4 = (struct sockaddr_in *)storage;
         addr4->sin_family = AF_INET;
@@ -68,172 +131,1127 @@ void addrtostr(const struct sockaddr *addr, char *str, size_t strsize) {
             msgExit("ntop ipv6 failed");
         // network to host short
         port = ntohs(addr6->sin6_port);
+    } else if(addr->sa_family == AF_UNIX) {
+        // clientes de socket Unix não têm caminho próprio
+        const struct sockaddr_un *addrun = (const struct sockaddr_un *)addr;
+        if(str) snprintf(str, strsize, "unix %s", addrun->sun_path[0] ? addrun->sun_path : "(local client)");
+        return;
     } else msgExit("addrtostr() failed, unknown protocol");
 
     if(str) snprintf(str, strsize, "IPv%d %s %hu", version, addrstr, port);
 }
 
-int main(int argc, char **argv) {
-    if(argc < 3 || argc > 3) usageExit(argc, argv);
+// fases de uma conexão, cada uma com seu próprio prazo:
+// IDLE   - esperando o primeiro byte de um novo comando
+// HEADER - comando começou, mas o nome do arquivo (até o '.') ainda não chegou
+// BODY   - nome conhecido, esperando o restante da mensagem até o '\0'
+//          (ou recebendo o corpo de uma faixa de upload)
+enum connState { CONN_IDLE, CONN_HEADER, CONN_BODY };
 
-    struct sockaddr_storage storage;
-    if (serverAddrInit(argv[1], argv[2], &storage) != 0) usageExit(argc, argv);
+struct connection {
+    struct connection *next, *prev; // lista de todas as conexões ativas
+    int fd;
+    enum connState state;
+    size_t used; // bytes já acumulados em buffer
+    char buffer[BUFSZ + 1];
+    char addrstr[64];
+    struct twTimer timer;
+    struct shmRing ring; // anel em memória compartilhada (só clientes locais, após "shm\end")
+    int handshake; // etapa do handshake kTLS (HANDSHAKE_DONE quando não há ou já terminou)
+    unsigned char tlsRandoms[2 * KTLS_RANDOM_LEN];
+    // faixa de upload em andamento: depois do cabeçalho "range" vêm bytes crus
+    struct uploadSession *upload;
+    unsigned rangeIndex;
+    uint64_t rangeRemaining; // bytes do corpo que ainda faltam
+    uint64_t bodyProgress;   // bytes recebidos desde o último rearme do prazo
+    int completed; // terminou alguma mensagem desde o último rearme: a fase seguinte é nova
+    // lote de arquivos: recebendo o corpo (used < size) ou com as threads escritoras
+    struct batch *batch;
+    // resposta segurada até os seguidores confirmarem a escrita (--ack one|all)
+    struct replicaWaiter *waiter;
+    struct traceRequest trace; // fases da mensagem atual (--trace)
+    int closed; // já encerrada; a memória só é liberada depois do despacho dos eventos
+};
 
-    int sock;
-    //IPv4 ou IPv6, TCP, IP
-    sock = socket(storage.ss_family, SOCK_STREAM, 0);
-    if(sock < 0) msgExit("socket() failed");
+enum { HANDSHAKE_DONE, HANDSHAKE_HELLO, HANDSHAKE_FINISH };
 
-    int enable = 1;
-    // Reusar porta sem atraso
-    if(setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int)) != 0)
-        msgExit("setsockopt() failed");
+struct serverConfig {
+    unsigned idleTimeout;
+    unsigned headerTimeout;
+    unsigned bodyTimeout;
+    const char *upgradePath;  // socket Unix onde um novo binário pede a troca
+    const char *takeoverPath; // socket Unix do servidor antigo a ser substituído
+    int takeoverClients;      // pedir também as conexões ociosas ao servidor antigo
+    const char *pskPath;      // com PSK, toda conexão TCP passa pelo handshake kTLS
+    unsigned writers;         // threads do pool que escreve os arquivos dos lotes
+    unsigned maxUploadMb;     // maior arquivo (MiB) aceito em um upload em faixas
+    unsigned uploadExpiry;    // segundos sem progresso até um upload em faixas sair do disco
+    int ack;                  // ACK_LOCAL, ACK_ONE ou ACK_ALL
+    unsigned replicaKeepalive; // segundos sem tráfego até um "ping" para o seguidor
+    const char *cpuList;      // CPUs do laço e das escritoras (--cpus)
+    int placement;            // PLACEMENT_LOCAL ou PLACEMENT_SPREAD
+    int busyPoll;             // microssegundos de SO_BUSY_POLL; o laço gira sem dormir
+    unsigned traceSample;     // --trace: imprime uma em cada traceSample requisições
+};
 
-    struct sockaddr *addr = (struct sockaddr *)(&storage);
-    // bind
-    if(bind(sock, addr, sizeof(storage)) != 0) msgExit("bind() failed");
+// mensagem trocada no socket de upgrade, acompanhada de um descritor (SCM_RIGHTS)
+struct handoffMsg {
+    char type; // HANDOFF_LISTENER ou HANDOFF_CLIENT
+    char addrstr[64];
+};
+#define HANDOFF_LISTENER 'L'
+#define HANDOFF_CLIENT 'C'
+// pedidos do novo servidor: só o socket de escuta ou também os clientes ociosos
+#define TAKEOVER_LISTENER 'L'
+#define TAKEOVER_ALL 'A'
 
-    // listen, 10 = número máximo de conexões pendentes para tratamento
-    if(listen(sock, 10) != 0) msgExit("listen() failed");
+static struct serverConfig config = {
+    .idleTimeout = DEFAULT_IDLE_TIMEOUT,
+    .headerTimeout = DEFAULT_HEADER_TIMEOUT,
+    .bodyTimeout = DEFAULT_BODY_TIMEOUT,
+    .writers = BATCH_DEFAULT_WRITERS,
+    .maxUploadMb = DEFAULT_MAX_UPLOAD_MB,
+    .uploadExpiry = DEFAULT_UPLOAD_EXPIRY,
+    .ack = ACK_LOCAL,
+    .replicaKeepalive = DEFAULT_REPLICA_KEEPALIVE,
+    .placement = PLACEMENT_LOCAL,
+};
+static struct ktlsPsk psk;
+static struct timerWheel wheel;
+static int epfd = -1;
+static int sock = -1;
+static struct connection *connections = NULL;
+// encerradas durante o despacho: eventos seguintes do mesmo epoll_wait ainda apontam para elas
+static struct connection *closedConnections = NULL;
 
-    char addrstr[BUFSZ];
-    addrtostr(addr, addrstr, BUFSZ);
-    printf("[log] Bound to %s, waiting connections\n", addrstr);
+// estado do hot upgrade
+static int upgradeSock = -1; // escuta pedidos de upgrade (servidor atual)
+static int upgradePeer = -1; // conexão com o outro binário durante a troca
+static int draining = 0;     // já entregou o socket de escuta, só termina o que está em andamento
+static int handoffClients = 0;
+
+// marcadores usados em epoll_event.data.ptr para os sockets que não são clientes
+static char listenerTag, upgradeListenerTag, upgradePeerTag, batchDoneTag;
+static int batchDoneFd = -1;
+// pedidos vindos de sinais, atendidos pelo laço: imprimir os histogramas, ligar/desligar o rastreador
+static volatile sig_atomic_t traceDumpRequested = 0, traceToggleRequested = 0;
+
+static void handoffConnection(struct connection *conn);
+static int connectionIdle(const struct connection *conn);
+
+
+// relógio monotônico convertido em ticks da roda de timers
+static uint64_t nowTicks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000) / TICK_MS;
+}
+
+static uint64_t secondsToTicks(unsigned seconds) {
+    return (uint64_t)seconds * 1000 / TICK_MS;
+}
+
+// prazo para uma sessão de upload sem nenhuma conexão ativa ser descartada
+static uint64_t uploadExpiry(void) {
+    return nowTicks() + secondsToTicks(config.idleTimeout);
+}
+
+// o corpo do lote ainda está chegando pelo socket
+static int batchReceiving(const struct connection *conn) {
+    return conn->batch != NULL && conn->batch->used < conn->batch->size;
+}
+
+// lote nas threads escritoras ou resposta à espera dos seguidores: a conexão está
+// pausada (ver pauseReading) até batchesDone ou replicaReleased
+static int connectionPaused(const struct connection *conn) {
+    return (conn->batch != NULL && !batchReceiving(conn)) || conn->waiter != NULL;
+}
+
+static void closeConnection(struct connection *conn) {
+    if(conn->upload) {
+        // faixa interrompida: o progresso fica salvo para o cliente retomar com "resume"
+        uploadEndRange(conn->upload, conn->rangeIndex);
+        uploadRelease(conn->upload, uploadExpiry());
+    }
+    if(conn->batch) {
+        // lote ainda chegando é descartado; já nas threads, é liberado quando terminar
+        if(batchReceiving(conn)) batchFree(conn->batch);
+        else conn->batch->owner = NULL;
+    }
+    if(conn->waiter) replicaDetach(conn->waiter);
+    if(conn->prev) conn->prev->next = conn->next;
+    else connections = conn->next;
+    if(conn->next) conn->next->prev = conn->prev;
+    timerDel(&conn->timer);
+    shmRingDetach(&conn->ring);
+    epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    conn->closed = 1;
+    conn->next = closedConnections;
+    closedConnections = conn;
+}
+
+// chamada fora do despacho, quando nenhum evento pendente pode mais apontar para elas
+static void freeClosedConnections(void) {
+    while(closedConnections) {
+        struct connection *conn = closedConnections;
+        closedConnections = conn->next;
+        free(conn);
+    }
+}
+
+static void connectionTimeout(struct twTimer *timer, void *arg) {
+    struct connection *conn = arg;
+    const char *phase = conn->state == CONN_IDLE ? "idle" : conn->state == CONN_HEADER ? "header" : "body";
+    printf("[log] %s timed out (%s)\n", conn->addrstr, phase);
+    closeConnection(conn);
+}
+
+// reavalia a fase da conexão e rearma o timer somente quando a fase muda:
+// o prazo conta a partir do início da fase, então um cliente que manda um
+// byte de cada vez (slow-loris) não consegue adiá-lo
+static void updateDeadline(struct connection *conn) {
+    enum connState state;
+    if(conn->handshake != HANDSHAKE_DONE) state = CONN_HEADER; // handshake tem o prazo do cabeçalho
+    else if(conn->upload != NULL || conn->batch != NULL || conn->waiter != NULL) state = CONN_BODY;
+    else if(conn->used == 0) state = CONN_IDLE;
+    else if(memchr(conn->buffer, '.', conn->used) == NULL) state = CONN_HEADER;
+    else state = CONN_BODY;
+
+    // no corpo de uma faixa (ou de um lote) o prazo também é renovado a cada RANGE_BUFSZ bytes
+    // recebidos: arquivos grandes demoram, mas precisam continuar avançando
+    int progressed = (conn->upload != NULL || conn->batch != NULL) && conn->bodyProgress >= RANGE_BUFSZ;
+    // uma mensagem inteira que chega e termina na mesma leitura volta para a mesma fase
+    // (IDLE), mas começa outra: sem isso o cliente ativo cai no prazo de ociosidade
+    if(state == conn->state && timerPending(&conn->timer) && !progressed && !conn->completed) return;
+    conn->state = state;
+    conn->bodyProgress = 0;
+    conn->completed = 0;
+
+    unsigned timeout = state == CONN_IDLE ? config.idleTimeout : state == CONN_HEADER ? config.headerTimeout : config.bodyTimeout;
+    timerAdd(&wheel, &conn->timer, nowTicks() + secondsToTicks(timeout));
+}
+
+// envia uma resposta terminada em '\0'; em caso de falha só este cliente é desconectado
+static int sendResponse(struct connection *conn, const char *buffer) {
+    ssize_t count = send(conn->fd, buffer, strlen(buffer)+1, MSG_NOSIGNAL);
+    if(count != strlen(buffer)+1) {
+        perror("send() failed");
+        return -1;
+    }
+    return 0;
+}
+
+// tira a conexão do epoll enquanto algo fora do laço (threads escritoras,
+// seguidores) decide a resposta; o que o cliente mandar depois espera no socket
+static void pauseReading(struct connection *conn) {
+    struct epoll_event ev = { .events = 0, .data.ptr = conn };
+    epoll_ctl(epfd, EPOLL_CTL_MOD, conn->fd, &ev);
+}
+
+// resposta de uma escrita aceita. Com --ack one|all ela só sai depois que os
+// seguidores confirmarem os quadros [first, last]; se não confirmarem, vai errorReply
+static int acceptedReply(struct connection *conn, char *buffer, const char *errorReply, uint64_t first, uint64_t last) {
+    conn->waiter = replicaDefer(conn, buffer, errorReply, first, last);
+    if(conn->waiter != NULL) {
+        pauseReading(conn);
+        return 0;
+    }
+    return sendResponse(conn, buffer);
+}
+
+// cria o anel de memória compartilhada e envia o memfd junto com a confirmação.
+// Daqui em diante o cliente escreve as mensagens no anel e o socket só carrega
+// um byte de aviso (doorbell) por escrita; as respostas continuam pelo socket
+static int setupSharedRing(struct connection *conn, char *buffer) {
+    int domain = 0;
+    socklen_t len = sizeof(domain);
+    getsockopt(conn->fd, SOL_SOCKET, SO_DOMAIN, &domain, &len);
+
+    int fd = -1;
+    if(domain != AF_UNIX || conn->ring.header != NULL || shmRingCreate(&conn->ring, SHM_RING_DEFAULT_SIZE, &fd) != 0) {
+        sprintf(buffer, "shm unavailable\n\\end");
+        return sendResponse(conn, buffer);
+    }
+    sprintf(buffer, "shm ok\n\\end");
+    int ret = sendFd(conn->fd, fd, buffer, strlen(buffer)+1);
+    close(fd); // o mapeamento continua válido sem o descritor
+    if(ret != 0) {
+        perror("shm handoff failed");
+        return -1;
+    }
+    printf("[log] %s switched to shared memory\n", conn->addrstr);
+    return 0;
+}
+
+// nome de arquivo vindo do cliente: sem diretórios e com uma extensão válida
+static int validFileName(const char *name) {
+    const char *dot = strrchr(name, '.');
+    if(name[0] == '\0' || name[0] == '.' || strchr(name, '/') != NULL || dot == NULL) return 0;
+    if(strlen(name) >= UPLOAD_NAME_MAX) return 0;
+    return validExtension(dot + 1);
+}
+
+// faixa completa: confirma para o cliente e, se for a última, faz o commit do arquivo
+static int finishRange(struct connection *conn) {
+    struct uploadSession *session = conn->upload;
+    char buffer[BUFSZ];
+    conn->upload = NULL;
+
+    if(uploadEndRange(session, conn->rangeIndex) && session->active == 1) {
+        char name[UPLOAD_NAME_MAX];
+        int overwritten;
+        strcpy(name, session->name);
+        if(uploadCommit(session, &overwritten) != 0) sprintf(buffer, "error receiving file %s\n\\end", name);
+        else {
+            char errorReply[BUFSZ];
+            uint64_t seq = replicaShip(name);
+            sprintf(buffer, "file %s %s\n\\end", name, overwritten ? "overwritten" : "received");
+            sprintf(errorReply, "error replicating file %s\n\\end", name);
+            return acceptedReply(conn, buffer, errorReply, seq, seq);
+        }
+    } else {
+        uploadRelease(session, uploadExpiry());
+        sprintf(buffer, "range %u received\n\\end", conn->rangeIndex);
+    }
+    return sendResponse(conn, buffer);
+}
+
+// escreve bytes do corpo da faixa atual na posição certa do arquivo
+static int consumeRange(struct connection *conn, const char *data, size_t len) {
+    if(uploadWrite(conn->upload, conn->rangeIndex, data, len) != 0) {
+        char buffer[BUFSZ];
+        perror("pwrite() failed");
+        snprintf(buffer, BUFSZ, "error receiving file %s\n\\end", conn->upload->name);
+        sendResponse(conn, buffer);
+        return -1;
+    }
+    conn->rangeRemaining -= len;
+    conn->bodyProgress += len;
+    if(conn->rangeRemaining == 0) return finishRange(conn);
+    return 0;
+}
+
+// cabeçalho de uma faixa de upload paralelo, seguido de <bytes> bytes crus:
+// "range <id> <índice> <total de faixas> <tamanho do arquivo> <offset> <bytes> <nome>\end"
+static int startRange(struct connection *conn, char *buffer) {
+    char id[UPLOAD_ID_MAX + 1] = "";
+    unsigned index = 0, count = 0;
+    unsigned long long size = 0, offset = 0, length = 0;
+    int nameStart = 0;
+    const char *error = NULL;
+    const char *name = "";
+
+    size_t len = strlen(buffer);
+    if(len < 4 || strcmp(buffer + len - 4, "\\end") != 0) error = "missing \\end";
+    else {
+        buffer[len - 4] = '\0';
+        if(sscanf(buffer, "range %32s %u %u %llu %llu %llu %n", id, &index, &count, &size, &offset, &length, &nameStart) != 6 || nameStart == 0)
+            error = "malformed range";
+        else name = buffer + nameStart;
+    }
+    if(error == NULL && (!validFileName(name) || index >= count || offset > size || length > size - offset))
+        error = "invalid range";
+
+    struct uploadSession *session = NULL;
+    if(error == NULL) session = uploadAcquire(id, name, size, count, &error);
+    if(session != NULL && uploadBeginRange(session, index, offset, length, &error) != 0) {
+        uploadRelease(session, uploadExpiry());
+        session = NULL;
+    }
+    if(session == NULL) {
+        // o corpo já está a caminho e não dá para separá-lo do próximo comando: desconecta
+        printf("[log] %s: %s\n", conn->addrstr, error);
+        snprintf(buffer, BUFSZ, "error receiving file %s\n\\end", name);
+        sendResponse(conn, buffer);
+        return -1;
+    }
+
+    conn->upload = session;
+    conn->rangeIndex = index;
+    conn->rangeRemaining = length;
+    if(length == 0) return finishRange(conn);
+    return 0;
+}
+
+// o cliente perdeu a conexão no meio de uma faixa e pergunta quanto já foi salvo.
+// Responde "offset <n>", "offset none" (recomece a faixa) ou "offset busy"
+// (a conexão antiga ainda não caiu do lado do servidor; tente de novo)
+static int resumeRange(struct connection *conn, char *buffer) {
+    char id[UPLOAD_ID_MAX + 1];
+    unsigned index;
+    char end[8];
+    uint64_t offset;
+    if(sscanf(buffer, "resume %32s %u%7s", id, &index, end) != 3 || strcmp(end, "\\end") != 0) {
+        sprintf(buffer, "offset none\n\\end");
+        return sendResponse(conn, buffer);
+    }
+    int ret = uploadResumeOffset(id, index, &offset, uploadExpiry());
+    if(ret > 0) sprintf(buffer, "offset %llu\n\\end", (unsigned long long)offset);
+    else if(ret < 0) sprintf(buffer, "offset busy\n\\end");
+    else sprintf(buffer, "offset none\n\\end");
+    return sendResponse(conn, buffer);
+}
+
+// corpo do lote completo: confere o índice e entrega às threads escritoras.
+// Enquanto elas trabalham a conexão deixa de ser lida, então a resposta do
+// lote sai antes da de qualquer comando que o cliente mande depois
+static int finishBatchBody(struct connection *conn) {
+    const char *error;
+    if(batchParse(conn->batch, validFileName, &error) != 0) {
+        char buffer[BUFSZ];
+        printf("[log] %s: %s\n", conn->addrstr, error);
+        batchFree(conn->batch);
+        conn->batch = NULL;
+        sprintf(buffer, "error receiving batch\n\\end");
+        return sendResponse(conn, buffer);
+    }
+    pauseReading(conn);
+    conn->batch->owner = conn;
+    batchSubmit(conn->batch);
+    return 0;
+}
+
+// copia bytes do corpo do lote para o buffer dele
+static int consumeBatch(struct connection *conn, const char *data, size_t len) {
+    struct batch *batch = conn->batch;
+    memcpy(batch->data + batch->used, data, len);
+    batch->used += len;
+    conn->bodyProgress += len;
+    if(batch->used == batch->size) return finishBatchBody(conn);
+    return 0;
+}
+
+// cabeçalho de um lote de arquivos pequenos, seguido do índice e dos dados:
+// "batch <arquivos> <bytes do índice> <bytes dos dados>\end"
+static int startBatch(struct connection *conn, char *buffer) {
+    unsigned count;
+    unsigned long long indexSize, dataSize;
+    char end[8];
+    const char *error = NULL;
+    if(sscanf(buffer, "batch %u %llu %llu%7s", &count, &indexSize, &dataSize, end) != 4 || strcmp(end, "\\end") != 0)
+        error = "malformed batch";
+    else conn->batch = batchCreate(count, indexSize, dataSize, &error);
+    if(conn->batch == NULL) {
+        // como na faixa, o corpo já está a caminho: desconecta
+        printf("[log] %s: %s\n", conn->addrstr, error);
+        sprintf(buffer, "error receiving batch\n\\end");
+        sendResponse(conn, buffer);
+        return -1;
+    }
+    return 0;
+}
+
+// trata uma mensagem completa do cliente. Retorna -1 se a conexão deve ser fechada
+static int handleMessage(struct connection *conn, char *buffer) {
+    int size = strlen(buffer);
+
+    if(strcmp(buffer, "exit\\end") == 0) { // cliente solicita desconexão
+        // printa "connection closed" na saída padrão e no buffer para enviar para o cliente.
+        // Só esta conexão é fechada: as dos outros clientes (e o que elas têm em
+        // andamento) continuam sendo atendidas pelo mesmo laço
+        printf("connection closed\n");
+        sprintf(buffer, "connection closed");
+        sendResponse(conn, buffer);
+        return -1;
+    }
+    else if(strncmp(buffer, "range ", 6) == 0) {
+        // faixa de um upload paralelo: o corpo binário vem logo em seguida
+        return startRange(conn, buffer);
+    }
+    else if(strncmp(buffer, "batch ", 6) == 0) {
+        // vários arquivos pequenos em um só quadro
+        return startBatch(conn, buffer);
+    }
+    else if(strncmp(buffer, "resume ", 7) == 0) {
+        // "resume <id> <índice>\end": de onde continuar uma faixa interrompida
+        return resumeRange(conn, buffer);
+    }
+    else if(strcmp(buffer, "ping\\end") == 0) {
+        // keepalive (do primário, na replicação): só renova o prazo de ociosidade
+        sprintf(buffer, "pong\n\\end");
+        return sendResponse(conn, buffer);
+    }
+    else if(strcmp(buffer, "shm\\end") == 0) {
+        // cliente no mesmo host pede o transporte por memória compartilhada
+        return setupSharedRing(conn, buffer);
+    }
+    else if(strcmp(buffer, "invalid command\\end") == 0) {
+        // comando inválido: envia "disconnect" para o cliente, que trata isso e apenas o cliente é desconectado
+        sprintf(buffer, "disconnect");
+        sendResponse(conn, buffer);
+        return -1; // fecha somente esta conexão
+    }
+    else if(size >= 4) { // size >= 4 pois strlen("\end") = 4
+        // separa nome, extensão e conteúdo (ponteiros para dentro de buffer)
+        struct fileMessage msg;
+        int parsed = parseFileMessage(buffer, size, &msg);
+        char file_name[MESSAGE_NAME_MAX]; // nomes maiores são recusados pelo parser
+        snprintf(file_name, sizeof(file_name), "%.*s%s%.*s", (int)msg.nameLen, msg.name ? msg.name : "",
+                 msg.extensionLen ? "." : "", (int)msg.extensionLen, msg.extension ? msg.extension : "");
+        TRACE_PHASE(&conn->trace, conn->fd, TRACE_PARSE);
+
+        // se caso a mensagem fora enviada sem o "\end" (ou sem um nome usável), printar
+        // error receiving file. O cliente atual não é desconectado por conta disso e o
+        // servidor aguarda uma nova mensagem
+        if(parsed != MESSAGE_OK) {
+            memset(buffer, 0, BUFSZ);
+            sprintf(buffer, "error receiving file %s\n\\end", file_name);
+            return sendResponse(conn, buffer);
+        }
+
+        FILE *fp;
+        const char *status = "received";
+        if(access(file_name, F_OK) == 0) status = "overwritten"; // se o arquivo já existe no diretório, reescreva-o
+        TRACE_PHASE(&conn->trace, conn->fd, TRACE_ACCESS);
+        // escreve o conteúdo em um arquivo temporário e só então o renomeia para
+        // file_name: uma falha no meio não deixa o arquivo antigo truncado
+        char tmp_name[] = ".upload-XXXXXX";
+        int tmp_fd = mkstemp(tmp_name);
+        fp = tmp_fd < 0 ? NULL : fdopen(tmp_fd, "w");
+        if(fp == NULL) {
+            perror("mkstemp() failed");
+            if(tmp_fd >= 0) {
+                close(tmp_fd);
+                unlink(tmp_name);
+            }
+            return -1;
+        }
+        fchmod(tmp_fd, 0644); // mkstemp cria com 0600
+        TRACE_PHASE(&conn->trace, conn->fd, TRACE_OPEN);
+        // o conteúdo já está inteiro no buffer: um fwrite em vez de um fputc por byte
+        int failed = fwrite(msg.contents, 1, msg.contentsLen, fp) != msg.contentsLen;
+        TRACE_PHASE(&conn->trace, conn->fd, TRACE_WRITE);
+        if(fclose(fp) != 0) failed = 1;
+        if(!failed && rename(tmp_name, file_name) != 0) failed = 1;
+        TRACE_PHASE(&conn->trace, conn->fd, TRACE_COMMIT);
+
+        memset(buffer, 0, BUFSZ);
+        if(failed) {
+            unlink(tmp_name);
+            sprintf(buffer, "error receiving file %s\n\\end", file_name);
+        }
+        else sprintf(buffer, "file %s %s\n\\end", file_name, status); // msg de confirmação
+        int ret;
+        if(failed) ret = sendResponse(conn, buffer);
+        else {
+            // arquivo aceito: vai para os seguidores e, conforme --ack, a confirmação espera por eles
+            char errorReply[BUFSZ];
+            uint64_t seq = replicaShip(file_name);
+            snprintf(errorReply, BUFSZ, "error replicating file %s\n\\end", file_name);
+            ret = acceptedReply(conn, buffer, errorReply, seq, seq);
+        }
+        TRACE_PHASE(&conn->trace, conn->fd, TRACE_SEND);
+        TRACE_END(&conn->trace, conn->fd, file_name);
+        return ret;
+    }
+    return 0;
+}
+
+// processa cada mensagem completa acumulada em conn->buffer (o cliente termina
+// cada mensagem com '\0'). Retorna -1 se a conexão deve ser fechada
+static int processBuffer(struct connection *conn) {
+    while(conn->used > 0) {
+        if(conn->batch != NULL && !batchReceiving(conn)) break; // espera as threads terminarem o lote
+        if(conn->waiter != NULL) break; // espera os seguidores confirmarem a última escrita
+        if(batchReceiving(conn)) {
+            size_t left = conn->batch->size - conn->batch->used;
+            size_t n = conn->used < left ? conn->used : left;
+            char body[BUFSZ];
+            memcpy(body, conn->buffer, n);
+            conn->used -= n;
+            memmove(conn->buffer, conn->buffer + n, conn->used);
+            if(consumeBatch(conn, body, n) != 0) return -1;
+            continue;
+        }
+        if(conn->upload != NULL) { // bytes do corpo de uma faixa, não são mensagens
+            size_t n = conn->used < conn->rangeRemaining ? conn->used : conn->rangeRemaining;
+            char body[BUFSZ];
+            memcpy(body, conn->buffer, n);
+            conn->used -= n;
+            memmove(conn->buffer, conn->buffer + n, conn->used);
+            if(consumeRange(conn, body, n) != 0) return -1;
+            continue;
+        }
+
+        char *end = memchr(conn->buffer, '\0', conn->used);
+        size_t msglen;
+        if(end != NULL) msglen = end - conn->buffer + 1;
+        else if(conn->used == BUFSZ) msglen = BUFSZ; // buffer cheio sem terminador: trata como está
+        else break;
+
+        // string na stack do programa com a mensagem completa do cliente
+        char buffer[BUFSZ + 1];
+        memset(buffer, 0, sizeof(buffer));
+        memcpy(buffer, conn->buffer, msglen);
+        conn->used -= msglen;
+        memmove(conn->buffer, conn->buffer + msglen, conn->used);
+
+        if(handleMessage(conn, buffer) != 0) return -1;
+        conn->completed = 1;
+        // a próxima mensagem já chegou junto: o recv dela foi o desta
+        if(conn->used > 0) TRACE_BEGIN(&conn->trace, conn->fd);
+    }
+    return 0;
+}
+
+// com o anel ativo, o socket só traz avisos: descarta-os e consome o anel
+static int drainSharedRing(struct connection *conn) {
+    char doorbells[64];
+    ssize_t count = recv(conn->fd, doorbells, sizeof(doorbells), 0);
+    if(count == 0) return -1;
+    if(count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return -1;
+
+    size_t n;
+    if(conn->used == 0) TRACE_BEGIN(&conn->trace, conn->fd);
+    else TRACE_RESUME(&conn->trace);
+    while((n = shmRingRead(&conn->ring, conn->buffer + conn->used, BUFSZ - conn->used)) > 0) {
+        TRACE_PHASE(&conn->trace, conn->fd, TRACE_RECV);
+        conn->used += n;
+        if(processBuffer(conn) != 0) return -1;
+    }
+    return 0;
+}
+
+// avança o handshake kTLS lendo exatamente os bytes da etapa atual: o que vier
+// depois já é um registro cifrado e precisa ficar no socket para o kernel
+static int handshakeStep(struct connection *conn) {
+    size_t need = conn->handshake == HANDSHAKE_HELLO ? KTLS_HELLO_LEN : KTLS_MAC_LEN;
+    ssize_t count = recv(conn->fd, conn->buffer + conn->used, need - conn->used, 0);
+    if(count == 0) return -1;
+    if(count < 0) return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    conn->used += count;
+    if(conn->used < need) return 0;
+    conn->used = 0;
+
+    if(conn->handshake == HANDSHAKE_HELLO) {
+        unsigned char reply[KTLS_SERVER_HELLO_LEN];
+        if(ktlsServerHello(&psk, (unsigned char *)conn->buffer, conn->tlsRandoms, reply) != 0) return -1;
+        if(send(conn->fd, reply, sizeof(reply), MSG_NOSIGNAL) != sizeof(reply)) return -1;
+        conn->handshake = HANDSHAKE_FINISH;
+        return 0;
+    }
+    if(ktlsServerFinish(conn->fd, &psk, conn->tlsRandoms, (unsigned char *)conn->buffer) != 0) {
+        printf("[log] %s failed the kTLS handshake\n", conn->addrstr);
+        return -1;
+    }
+    memset(conn->tlsRandoms, 0, sizeof(conn->tlsRandoms));
+    conn->handshake = HANDSHAKE_DONE;
+    printf("[log] %s encrypted with kTLS\n", conn->addrstr);
+    return 0;
+}
+
+// lê o que estiver disponível no socket e processa cada mensagem completa
+static void handleReadable(struct connection *conn) {
+    if(conn->closed) return; // fechada (ou entregue no upgrade) por um evento anterior desta volta
+    if(connectionPaused(conn)) {
+        // pausada, só chega EPOLLHUP/EPOLLERR: não há a quem responder, e ler agora
+        // processaria a próxima mensagem com o lote nas threads ou a resposta pendente
+        closeConnection(conn);
+        return;
+    }
+    if(conn->handshake != HANDSHAKE_DONE) {
+        if(handshakeStep(conn) != 0) closeConnection(conn);
+        else updateDeadline(conn);
+        return;
+    }
+    if(conn->ring.header != NULL) {
+        if(drainSharedRing(conn) != 0) closeConnection(conn);
+        else updateDeadline(conn);
+        return;
+    }
+
+    ssize_t bytesReceived;
+    if(conn->upload != NULL && conn->used == 0) {
+        // corpo de faixa: lê em blocos grandes direto para o arquivo, sem passar pelo buffer de mensagens
+        static char rangeBuffer[RANGE_BUFSZ];
+        size_t want = conn->rangeRemaining < RANGE_BUFSZ ? conn->rangeRemaining : RANGE_BUFSZ;
+        bytesReceived = recv(conn->fd, rangeBuffer, want, 0);
+        if(bytesReceived > 0) {
+            if(consumeRange(conn, rangeBuffer, bytesReceived) != 0) closeConnection(conn);
+            else updateDeadline(conn);
+            return;
+        }
+    }
+    else if(batchReceiving(conn) && conn->used == 0) {
+        // corpo do lote: vai direto para o buffer do lote
+        struct batch *batch = conn->batch;
+        bytesReceived = recv(conn->fd, batch->data + batch->used, batch->size - batch->used, 0);
+        if(bytesReceived > 0) {
+            batch->used += bytesReceived;
+            conn->bodyProgress += bytesReceived;
+            if(batch->used == batch->size && finishBatchBody(conn) != 0) closeConnection(conn);
+            else updateDeadline(conn);
+            return;
+        }
+    }
+    else {
+        // a espera até o socket ficar legível não conta: só o tempo dentro do recv
+        if(conn->used == 0) TRACE_BEGIN(&conn->trace, conn->fd);
+        else TRACE_RESUME(&conn->trace);
+        bytesReceived = recv(conn->fd, conn->buffer + conn->used, BUFSZ - conn->used, 0);
+        TRACE_PHASE(&conn->trace, conn->fd, TRACE_RECV);
+    }
+    if(bytesReceived == 0) { // conexão fechada pelo cliente
+        closeConnection(conn);
+        return;
+    }
+    if(bytesReceived == -1) {
+        if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return;
+        perror("recv() failed");
+        closeConnection(conn);
+        return;
+    }
+    conn->used += bytesReceived;
+
+    if(processBuffer(conn) != 0) {
+        closeConnection(conn);
+        return;
+    }
+    // durante o upgrade, a conexão vai para o novo servidor assim que termina a mensagem atual
+    if(draining && handoffClients && connectionIdle(conn)) {
+        handoffConnection(conn);
+        return;
+    }
+    updateDeadline(conn);
+}
+
+// volta a ler uma conexão pausada, depois de enviar a resposta que ela esperava,
+// e processa o que o cliente já tinha mandado
+static void resumeConnection(struct connection *conn, const char *reply) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = conn };
+    epoll_ctl(epfd, EPOLL_CTL_MOD, conn->fd, &ev);
+    int ret = sendResponse(conn, reply);
+    if(ret == 0) ret = conn->ring.header != NULL ? drainSharedRing(conn) : processBuffer(conn);
+    if(ret != 0) closeConnection(conn);
+    else updateDeadline(conn);
+}
+
+// as threads terminaram um ou mais lotes: responde a cada cliente e volta a ler
+// as conexões, processando o que já tinha chegado depois do lote
+static void batchesDone(void) {
+    uint64_t count;
+    if(read(batchDoneFd, &count, sizeof(count)) < 0 && errno != EAGAIN) perror("eventfd read failed");
+
+    struct batch *batch;
+    while((batch = batchCompleted()) != NULL) {
+        struct connection *conn = batch->owner;
+        unsigned status[3] = {0, 0, 0};
+        uint64_t first = 0, last = 0;
+        for(unsigned i = 0; i < batch->count; i++) {
+            struct batchEntry *entry = &batch->entries[i];
+            status[entry->status]++;
+            // arquivos gravados vão para os seguidores mesmo se o cliente já foi embora
+            if(entry->status == BATCH_FAILED) continue;
+            uint64_t seq = replicaShip(entry->name);
+            if(first == 0) first = seq;
+            last = seq;
+        }
+        batchFree(batch);
+        if(conn == NULL) continue; // cliente já foi embora
+
+        char buffer[BUFSZ];
+        conn->batch = NULL;
+        sprintf(buffer, "batch %u received %u overwritten %u failed\n\\end",
+                status[BATCH_RECEIVED], status[BATCH_OVERWRITTEN], status[BATCH_FAILED]);
+        if(first != 0) conn->waiter = replicaDefer(conn, buffer, "error replicating batch\n\\end", first, last);
+        if(conn->waiter == NULL) resumeConnection(conn, buffer);
+    }
+}
+
+// os seguidores decidiram uma escrita: a resposta segurada finalmente sai
+static void replicaReleased(void *owner, const char *reply) {
+    struct connection *conn = owner;
+    conn->waiter = NULL;
+    resumeConnection(conn, reply);
+}
 
-    // mesmo raciocínio do array de extensões válidas do cliente
-    char *valid_extensions[] = {"cpp", "txt", "c", "py", "tex", "java"};
+// registra um socket de cliente já conectado (aceito aqui ou recebido no upgrade)
+static int addConnection(int fd, const char *addrstr, int needsHandshake) {
+    struct connection *conn = calloc(1, sizeof(*conn));
+    if(conn == NULL) {
+        close(fd);
+        return -1;
+    }
+    conn->fd = fd;
+    conn->handshake = needsHandshake ? HANDSHAKE_HELLO : HANDSHAKE_DONE;
+    if(config.busyPoll > 0 && setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &config.busyPoll, sizeof(config.busyPoll)) != 0) {
+        // valores acima de net.core.busy_read exigem CAP_NET_ADMIN; o laço continua girando
+        static int warned = 0;
+        if(!warned) perror("setsockopt(SO_BUSY_POLL) failed");
+        warned = 1;
+    }
+    snprintf(conn->addrstr, sizeof(conn->addrstr), "%s", addrstr);
+    timerInit(&conn->timer, connectionTimeout, conn);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
 
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = conn };
+    if(epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        perror("epoll_ctl() failed");
+        close(fd);
+        free(conn);
+        return -1;
+    }
+    conn->next = connections;
+    if(connections) connections->prev = conn;
+    connections = conn;
+    updateDeadline(conn);
+    return 0;
+}
+
+static void acceptConnections(void) {
     while(1) {
         struct sockaddr_storage clientStorage;
         struct sockaddr *clientSockaddr = (struct sockaddr *)(&clientStorage);
         socklen_t clientAddrLen = sizeof(clientStorage);
+        memset(&clientStorage, 0, sizeof(clientStorage)); // clientes Unix não preenchem o caminho
 
         // accept, Socket que conversa com cliente
-        printf("[log] Waiting for new client\n");
-        int clientSocket = accept(sock, clientSockaddr, &clientAddrLen);
+        int clientSocket = accept4(sock, clientSockaddr, &clientAddrLen, SOCK_NONBLOCK);
         if(clientSocket == -1) {
-            close(sock);
-            msgExit("accept() failed");
+            if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return;
+            // falta de descritores etc. não derruba o servidor, as conexões ficam na fila
+            perror("accept() failed");
+            return;
         }
 
-        char clientAddrStr[BUFSZ];
-        addrtostr(clientSockaddr, clientAddrStr, BUFSZ);
-        printf("[log] connected from %s\n", clientAddrStr);
+        char clientAddrStr[64];
+        addrtostr(clientSockaddr, clientAddrStr, sizeof(clientAddrStr));
+        // conexões recebidas no upgrade já fizeram o handshake; as novas fazem se houver PSK
+        if(addConnection(clientSocket, clientAddrStr, config.pskPath != NULL) == 0)
+            printf("[log] connected from %s\n", clientAddrStr);
+    }
+}
+
+// socket Unix SOCK_SEQPACKET: preserva os limites de cada mensagem de handoff
+static int unixSocketInit(const char *path, struct sockaddr_un *addr) {
+    if(strlen(path) >= sizeof(addr->sun_path)) return -1;
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strcpy(addr->sun_path, path);
+    return socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+}
 
-        // string na stack do programa para receber os caracteres do cliente
-        char buffer[BUFSZ];
-        while(1) {
-            memset(buffer, 0, BUFSZ);
-            size_t bytesReceived = recv(clientSocket, buffer, BUFSZ, 0);
-            int size = strlen(buffer);
-            
-            if(bytesReceived == 0) break; // sai do loop do cliente atual para esperar um novo caso nada é enviado (conexão fechada)
-            if(bytesReceived == -1) { // erro no recv em si
-                close(clientSocket);
-                close(sock);
-                msgExit("recv() failed");
-            }
-            if(strcmp(buffer, "exit\\end") == 0) { // cliente solicita desconexão e ambas as conexões são fechadas
-                // printa "connection closed" na saída padrão e no buffer para enviar para o cliente
-                printf("connection closed\n");
-                sprintf(buffer, "connection closed");
-                bytesReceived = send(clientSocket, buffer, strlen(buffer)+1, 0);
-                if(bytesReceived != strlen(buffer)+1) msgExit("send() failed");
-                // encerramento das conexões
-                close(clientSocket);
-                close(sock);
-                exit(1);
-            }
-            else if(strcmp(buffer, "invalid command\\end") == 0) {
-                // comando inválido: envia "disconnect" para o cliente, que trata isso e apenas o cliente é desconectado
-                sprintf(buffer, "disconnect");
-                bytesReceived = send(clientSocket, buffer, strlen(buffer)+1, 0);
-                if(bytesReceived != strlen(buffer)+1) msgExit("send() failed");
-                break; // sai do loop interno para receber outro cliente
-            }
-            else if(size >= 4) { // size >= 4 pois strlen("\end") = 4
-                // pega somente o nome do arquivo, sem o .extensão
-                char *aux = NULL;
-                aux = strtok(buffer, ".");
-                char *file_name = malloc(BUFSZ * sizeof(char));
-                strcpy(file_name, aux);
-                
-                // pega o resto da string recebida e a copia para contents
-                char *rest = strtok(NULL, "");
-                char *contents = malloc(BUFSZ * sizeof(char));
-                strcpy(contents, rest);
-                char dot = '.';
-
-                // faz o parse da extensão e do conteúdo do arquivo
-                int extension_name_size = 0;
-                for(int i = 0; i < 6; i++) {
-                    extension_name_size = strlen(valid_extensions[i]);
-                    // compara os primeiros extension_name_size caracteres do resto da mensagem com a extensão
-                    //  da atual iteração do array. Se der match, é a extensão correta
-                    if(strncmp(rest, valid_extensions[i], extension_name_size) == 0) {
-                        strncat(file_name, &dot, 1);
-                        strcat(file_name, valid_extensions[i]);
-                        // atualiza a posição do ponteiro para pular a extensão e 
-                        // o coloca no início do conteúdo de texto
-                        contents += extension_name_size;
-                        // remove o "\end" ao final, para sobrar somente o conteúdo de texto
-                        contents[strlen(contents)-4] = '\0';
-                        break;
-                    }
-                }
-
-                // se caso a mensagem fora enviada sem o "\end", printar error receiving file
-                // o cliente atual não é desconectado por conta disso e o servidor aguarda
-                // uma nova mensagem
-                const char *last_four = &buffer[size-4];
-                if(strcmp(last_four, "\\end") != 0) {
-                    memset(buffer, 0, BUFSZ);
-                    sprintf(buffer, "error receiving file %s\n\\end", file_name);
-                    bytesReceived = send(clientSocket, buffer, strlen(buffer)+1, 0);
-                    if(bytesReceived != strlen(buffer)+1) msgExit("send() failed");
-
-                    free(file_name);
-                    continue;
-                }
-
-                FILE *fp;
-                if(access(file_name, F_OK) == 0) { // se o arquivo já existe no diretório, reescreva-o
-                    fp = fopen(file_name, "w");
-                    int i = 0;
-                    while (contents[i] != '\0') {
-                        // printa char a achar no arquivo
-                        fputc(contents[i], fp);
-                        i++;
-                    }
-                    fclose(fp);
-
-                    memset(buffer, 0, BUFSZ);
-                    sprintf(buffer, "file %s overwritten\n\\end", file_name); // msg de confirmação
-                    bytesReceived = send(clientSocket, buffer, strlen(buffer)+1, 0);
-                    if(bytesReceived != strlen(buffer)+1) msgExit("send() failed");
-                }
-                else { // caso não esteja no diretório, crie o arquivo e escreva contents nele
-                    fp = fopen(file_name, "w");
-                    int i = 0;
-                    while (contents[i] != '\0') {
-                        fputc(contents[i], fp);
-                        i++;
-                    }
-                    fclose(fp);
-
-                    memset(buffer, 0, BUFSZ);
-                    sprintf(buffer, "file %s received\n\\end", file_name); // msg de confirmação
-                    bytesReceived = send(clientSocket, buffer, strlen(buffer)+1, 0);
-                    if(bytesReceived != strlen(buffer)+1) msgExit("send() failed");
-                }
-                free(file_name);
-                // libera a memória alocada, ajustando o ponteiro de acordo com o deslocamento feito na linha 178
-                free(contents - extension_name_size);
-            }
+static void upgradeListen(void) {
+    struct sockaddr_un addr;
+    upgradeSock = unixSocketInit(config.upgradePath, &addr);
+    if(upgradeSock < 0) msgExit("upgrade socket() failed");
+    unlink(config.upgradePath); // remove um socket antigo que tenha sobrado
+    if(bind(upgradeSock, (struct sockaddr *)&addr, sizeof(addr)) != 0) msgExit("upgrade bind() failed");
+    if(listen(upgradeSock, 1) != 0) msgExit("upgrade listen() failed");
+
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &upgradeListenerTag };
+    if(epoll_ctl(epfd, EPOLL_CTL_ADD, upgradeSock, &ev) != 0) msgExit("epoll_ctl() failed");
+    printf("[log] Accepting hot upgrades on %s\n", config.upgradePath);
+}
+
+// conexão sem nada em andamento, que pode ser entregue a outro processo. Durante o
+// handshake kTLS não: o estado dele (tlsRandoms) não vai junto com o descritor
+static int connectionIdle(const struct connection *conn) {
+    return conn->handshake == HANDSHAKE_DONE && conn->used == 0 && conn->upload == NULL && conn->batch == NULL && conn->waiter == NULL && conn->ring.header == NULL;
+}
+
+// entrega uma conexão ociosa ao novo servidor e fecha a cópia local
+static void handoffConnection(struct connection *conn) {
+    struct handoffMsg msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = HANDOFF_CLIENT;
+    strcpy(msg.addrstr, conn->addrstr);
+    if(sendFd(upgradePeer, conn->fd, &msg, sizeof(msg)) != 0) {
+        // novo servidor sumiu: continua atendendo as conexões que restam aqui
+        perror("handoff failed");
+        handoffClients = 0;
+        updateDeadline(conn);
+        return;
+    }
+    printf("[log] handed %s off\n", conn->addrstr);
+    closeConnection(conn);
+}
+
+// lado do servidor antigo: um novo binário conectou no socket de upgrade
+static void acceptUpgrade(void) {
+    int peer = accept4(upgradeSock, NULL, NULL, SOCK_CLOEXEC);
+    if(peer < 0) return;
+
+    // o novo servidor manda o pedido logo após conectar
+    struct timeval tv = { .tv_sec = 1, .tv_usec = 0 };
+    setsockopt(peer, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    char request = 0;
+    if(recv(peer, &request, 1, 0) != 1 || (request != TAKEOVER_LISTENER && request != TAKEOVER_ALL)) {
+        close(peer);
+        return;
+    }
+
+    // libera o caminho para que o novo servidor possa aceitar o próximo upgrade
+    epoll_ctl(epfd, EPOLL_CTL_DEL, upgradeSock, NULL);
+    close(upgradeSock);
+    upgradeSock = -1;
+    unlink(config.upgradePath);
+
+    struct handoffMsg msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = HANDOFF_LISTENER;
+    if(sendFd(peer, sock, &msg, sizeof(msg)) != 0) {
+        perror("listener handoff failed");
+        close(peer);
+        upgradeListen();
+        return;
+    }
+
+    // a partir daqui o novo servidor aceita as conexões; a fila do listen é
+    // compartilhada, então nenhuma conexão pendente é perdida
+    epoll_ctl(epfd, EPOLL_CTL_DEL, sock, NULL);
+    close(sock);
+    sock = -1;
+    upgradePeer = peer;
+    draining = 1;
+    handoffClients = request == TAKEOVER_ALL;
+    printf("[log] Handed listening socket off, draining\n");
+
+    struct connection *conn = connections;
+    while(conn && handoffClients) {
+        struct connection *next = conn->next;
+        // conexões com anel compartilhado ficam aqui até fecharem: o mapeamento não é repassado
+        if(connectionIdle(conn)) handoffConnection(conn);
+        conn = next;
+    }
+}
+
+// lado do servidor novo: recebe as conexões ociosas que o antigo for liberando
+static void receiveHandoff(void) {
+    struct handoffMsg msg;
+    int fd;
+    ssize_t count = recvFd(upgradePeer, &fd, &msg, sizeof(msg));
+    if(count <= 0) { // servidor antigo terminou
+        if(count < 0 && (errno == EAGAIN || errno == EINTR)) return;
+        epoll_ctl(epfd, EPOLL_CTL_DEL, upgradePeer, NULL);
+        close(upgradePeer);
+        upgradePeer = -1;
+        printf("[log] Previous server finished draining\n");
+        return;
+    }
+    if(fd < 0) return;
+    if(count != sizeof(msg) || msg.type != HANDOFF_CLIENT) {
+        close(fd);
+        return;
+    }
+    msg.addrstr[sizeof(msg.addrstr) - 1] = '\0';
+    if(addConnection(fd, msg.addrstr, 0) == 0)
+        printf("[log] took over %s\n", msg.addrstr);
+}
+
+// conecta no servidor antigo e recebe dele o socket de escuta
+static int takeover(void) {
+    struct sockaddr_un addr;
+    int peer = unixSocketInit(config.takeoverPath, &addr);
+    if(peer < 0) msgExit("takeover socket() failed");
+    if(connect(peer, (struct sockaddr *)&addr, sizeof(addr)) != 0) msgExit("takeover connect() failed");
+
+    char request = config.takeoverClients ? TAKEOVER_ALL : TAKEOVER_LISTENER;
+    if(send(peer, &request, 1, MSG_NOSIGNAL) != 1) msgExit("takeover send() failed");
+
+    struct handoffMsg msg;
+    int fd;
+    if(recvFd(peer, &fd, &msg, sizeof(msg)) != sizeof(msg) || fd < 0 || msg.type != HANDOFF_LISTENER)
+        msgExit("takeover failed, no listening socket received");
+
+    upgradePeer = peer;
+    return fd;
+}
+
+static void traceSignal(int signo) {
+    if(signo == SIGUSR1) traceDumpRequested = 1;
+    else traceToggleRequested = 1;
+}
+
+static void parseOptions(int argc, char **argv) {
+    static struct option options[] = {
+        {"idle-timeout", required_argument, NULL, 'i'},
+        {"header-timeout", required_argument, NULL, 'H'},
+        {"body-timeout", required_argument, NULL, 'b'},
+        {"upgrade-socket", required_argument, NULL, 'u'},
+        {"takeover", required_argument, NULL, 't'},
+        {"takeover-clients", no_argument, NULL, 'T'},
+        {"psk", required_argument, NULL, 'k'},
+        {"writers", required_argument, NULL, 'w'},
+        {"max-upload", required_argument, NULL, 'm'},
+        {"upload-expiry", required_argument, NULL, 'e'},
+        {"replica", required_argument, NULL, 'r'},
+        {"ack", required_argument, NULL, 'a'},
+        {"replica-keepalive", required_argument, NULL, 'K'},
+        {"cpus", required_argument, NULL, 'c'},
+        {"placement", required_argument, NULL, 'P'},
+        {"busy-poll", required_argument, NULL, 'B'},
+        {"trace", required_argument, NULL, 'R'},
+        {NULL, 0, NULL, 0}
+    };
+    int opt;
+    while((opt = getopt_long(argc, argv, "i:H:b:u:t:Tk:w:m:e:r:a:K:c:P:B:R:", options, NULL)) != -1) {
+        int value = 1;
+        switch(opt) {
+            case 'i': value = config.idleTimeout = atoi(optarg); break;
+            case 'H': value = config.headerTimeout = atoi(optarg); break;
+            case 'b': value = config.bodyTimeout = atoi(optarg); break;
+            case 'u': config.upgradePath = optarg; break;
+            case 't': config.takeoverPath = optarg; break;
+            case 'T': config.takeoverClients = 1; break;
+            case 'k': config.pskPath = optarg; break;
+            case 'w': value = config.writers = atoi(optarg); break;
+            case 'm': value = config.maxUploadMb = atoi(optarg); break;
+            case 'e': value = config.uploadExpiry = atoi(optarg); break;
+            case 'r': if(replicaAdd(optarg) != 0) usageExit(argc, argv); break;
+            case 'a':
+                if(strcmp(optarg, "local") == 0) config.ack = ACK_LOCAL;
+                else if(strcmp(optarg, "one") == 0) config.ack = ACK_ONE;
+                else if(strcmp(optarg, "all") == 0) config.ack = ACK_ALL;
+                else usageExit(argc, argv);
+                break;
+            case 'K': value = config.replicaKeepalive = atoi(optarg); break;
+            case 'c': config.cpuList = optarg; break;
+            case 'P':
+                if(strcmp(optarg, "local") == 0) config.placement = PLACEMENT_LOCAL;
+                else if(strcmp(optarg, "spread") == 0) config.placement = PLACEMENT_SPREAD;
+                else usageExit(argc, argv);
+                break;
+            case 'B': value = config.busyPoll = atoi(optarg); break;
+            case 'R': value = config.traceSample = atoi(optarg); break;
+            default: usageExit(argc, argv);
+        }
+        if(value <= 0) usageExit(argc, argv);
+    }
+    // restam os argumentos posicionais: protocolo e porta (ou só unix:<caminho>)
+    int positional = argc - optind;
+    if(positional == 1 && strncmp(argv[optind], "unix:", 5) == 0) return;
+    if(positional != 2) usageExit(argc, argv);
+}
+
+int main(int argc, char **argv) {
+    parseOptions(argc, argv);
+    char *proto = argv[optind], *portstr = optind + 1 < argc ? argv[optind + 1] : NULL;
+
+    struct sockaddr_storage storage;
+    if (serverAddrInit(proto, portstr, &storage) != 0) usageExit(argc, argv);
+    if(config.pskPath) {
+        // kTLS só existe para TCP
+        if(storage.ss_family == AF_UNIX) {
+            printf("--psk is only supported on v4/v6\n");
+            exit(EXIT_FAILURE);
+        }
+        if(ktlsLoadPsk(config.pskPath, &psk) != 0) {
+            printf("could not read a key of at least %d bytes from %s\n", KTLS_PSK_MIN, config.pskPath);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // fixa o laço antes de alocar qualquer coisa, para que as estruturas dele
+    // (e os buffers dos lotes, preenchidos por ele) fiquem no seu nó NUMA
+    int cpus[AFFINITY_MAX_CPUS], writerCpus[AFFINITY_MAX_CPUS], writerCount = 0;
+    if(config.cpuList) {
+        int count = cpuListParse(config.cpuList, cpus, AFFINITY_MAX_CPUS);
+        if(count <= 0) usageExit(argc, argv);
+        if(pinCurrentThread(cpus[0]) != 0) msgExit("pinCurrentThread() failed");
+        writerCount = placeWriters(cpus, count, config.placement, writerCpus);
+        printf("[log] Event loop on CPU %d (node %d), writers on CPUs", cpus[0], cpuNode(cpus[0]));
+        for(int i = 0; i < writerCount; i++) printf(" %d", writerCpus[i]);
+        printf(" (%s)\n", config.placement == PLACEMENT_LOCAL ? "local" : "spread");
+    }
+
+    // epoll multiplexa todas as conexões em uma única thread; a roda de timers
+    // encerra as conexões ociosas ou lentas demais
+    epfd = epoll_create1(0);
+    if(epfd < 0) msgExit("epoll_create1() failed");
+    timerWheelInit(&wheel, nowTicks());
+    uploadInit(&wheel, (uint64_t)config.maxUploadMb << 20, config.uploadExpiry, secondsToTicks(UPLOAD_SWEEP_SECONDS));
+    // threads que escrevem os arquivos dos lotes; avisam o laço pelo eventfd
+    batchDoneFd = batchPoolStart(config.writers, writerCpus, writerCount);
+    if(batchDoneFd < 0) msgExit("batchPoolStart() failed");
+    struct epoll_event batchEv = { .events = EPOLLIN, .data.ptr = &batchDoneTag };
+    if(epoll_ctl(epfd, EPOLL_CTL_ADD, batchDoneFd, &batchEv) != 0) msgExit("epoll_ctl() failed");
+    // seguidores: reconecta a cada segundo enquanto algum estiver fora do ar
+    if(replicaCount() > 0)
+        replicaStart(epfd, &wheel, config.ack, secondsToTicks(1), secondsToTicks(config.replicaKeepalive), replicaReleased);
+
+    if(config.takeoverPath) { // hot upgrade: herda o socket de escuta do servidor antigo
+        sock = takeover();
+        struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &upgradePeerTag };
+        if(epoll_ctl(epfd, EPOLL_CTL_ADD, upgradePeer, &ev) != 0) msgExit("epoll_ctl() failed");
+        printf("[log] Took listening socket over from %s\n", config.takeoverPath);
+    } else {
+        //IPv4 ou IPv6, TCP, IP
+        sock = socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if(sock < 0) msgExit("socket() failed");
+
+        int enable = 1;
+        // Reusar porta sem atraso
+        if(setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int)) != 0)
+            msgExit("setsockopt() failed");
+
+        struct sockaddr *addr = (struct sockaddr *)(&storage);
+        // um socket Unix que sobrou de uma execução anterior impediria o bind
+        if(storage.ss_family == AF_UNIX) unlink(((struct sockaddr_un *)addr)->sun_path);
+        // bind
+        if(bind(sock, addr, addrlen(&storage)) != 0) msgExit("bind() failed");
+
+        // listen, SOMAXCONN = número máximo de conexões pendentes para tratamento
+        if(listen(sock, SOMAXCONN) != 0) msgExit("listen() failed");
+    }
+
+    // endereço de fato associado ao socket (no upgrade, é o do servidor antigo)
+    struct sockaddr_storage bound;
+    socklen_t boundLen = sizeof(bound);
+    if(getsockname(sock, (struct sockaddr *)&bound, &boundLen) != 0) msgExit("getsockname() failed");
+    char addrstr[BUFSZ];
+    addrtostr((struct sockaddr *)&bound, addrstr, BUFSZ);
+    printf("[log] Bound to %s, waiting connections\n", addrstr);
+
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &listenerTag };
+    if(epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev) != 0) msgExit("epoll_ctl() failed");
+    if(config.upgradePath) upgradeListen();
+
+    // o rastreador pode ser ligado depois (SIGUSR2); sem --trace, imprime uma a cada 1000
+    traceInit(config.traceSample > 0 ? config.traceSample : 1000);
+    traceEnabled = config.traceSample > 0;
+    struct sigaction sa = { .sa_handler = traceSignal, .sa_flags = SA_RESTART };
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR1, &sa, NULL);
+    sigaction(SIGUSR2, &sa, NULL);
+
+    struct epoll_event events[MAX_EVENTS];
+    // com --busy-poll o laço nunca dorme: troca um núcleo por menos latência para acordar
+    int waitMs = config.busyPoll > 0 ? 0 : TICK_MS;
+    while(1) {
+        int n = epoll_wait(epfd, events, MAX_EVENTS, waitMs);
+        if(n < 0 && errno != EINTR) msgExit("epoll_wait() failed");
+
+        for(int i = 0; i < n; i++) {
+            void *ptr = events[i].data.ptr;
+            if(ptr == &listenerTag) acceptConnections();
+            else if(ptr == &upgradeListenerTag) acceptUpgrade();
+            else if(ptr == &upgradePeerTag) receiveHandoff();
+            else if(ptr == &batchDoneTag) batchesDone();
+            else if(replicaIsTag(ptr)) replicaEvent(ptr, events[i].events);
+            else handleReadable(ptr);
+        }
+        freeClosedConnections();
+        if(traceToggleRequested) {
+            traceToggleRequested = 0;
+            traceEnabled = !traceEnabled;
+            printf("[log] Tracing %s\n", traceEnabled ? "on" : "off");
+        }
+        if(traceDumpRequested) {
+            traceDumpRequested = 0;
+            traceDump();
+        }
+        // os arquivos aceitos nesta volta seguem juntos para os seguidores
+        replicaFlush();
+        timerWheelAdvance(&wheel, nowTicks());
+
+        // servidor antigo: sai quando a última conexão em andamento termina
+        if(draining && connections == NULL && batchInFlight() == 0) {
+            printf("[log] Drained, exiting\n");
+            exit(EXIT_SUCCESS);
         }
-        // fecha a conexão do cliente caso haja um break no loop interno do servidor (comando inválido do cliente)
-        close(clientSocket);
     }
     close(sock);
     exit(EXIT_SUCCESS);
-}
\ No newline at end of file
+}
@@ -0,0 +1,96 @@
+#define _GNU_SOURCE
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "shmring.h"
+
+// dados começam na primeira página depois do cabeçalho
+#define SHM_RING_DATA_OFFSET 4096
+
+static int shmRingMap(struct shmRing *ring, int fd, size_t mapped) {
+    void *base = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(base == MAP_FAILED) return -1;
+    ring->header = base;
+    ring->data = (char *)base + SHM_RING_DATA_OFFSET;
+    ring->mapped = mapped;
+    return 0;
+}
+
+int shmRingCreate(struct shmRing *ring, size_t size, int *fd) {
+    if(size == 0 || (size & (size - 1)) != 0) return -1; // precisa ser potência de 2
+
+    *fd = memfd_create("shmring", MFD_CLOEXEC);
+    if(*fd < 0) return -1;
+    size_t mapped = SHM_RING_DATA_OFFSET + size;
+    if(ftruncate(*fd, mapped) != 0 || shmRingMap(ring, *fd, mapped) != 0) {
+        close(*fd);
+        return -1;
+    }
+    ring->header->head = 0;
+    ring->header->tail = 0;
+    ring->header->size = size;
+    ring->size = size;
+    return 0;
+}
+
+int shmRingAttach(struct shmRing *ring, int fd) {
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= SHM_RING_DATA_OFFSET) return -1;
+    if(shmRingMap(ring, fd, st.st_size) != 0) return -1;
+
+    // não confia no tamanho escrito pelo outro processo além do que foi mapeado
+    uint64_t size = ring->header->size;
+    if(size == 0 || (size & (size - 1)) != 0 || size > st.st_size - SHM_RING_DATA_OFFSET) {
+        shmRingDetach(ring);
+        return -1;
+    }
+    ring->size = size;
+    return 0;
+}
+
+void shmRingDetach(struct shmRing *ring) {
+    if(ring->header) munmap(ring->header, ring->mapped);
+    memset(ring, 0, sizeof(*ring));
+}
+
+// copia len bytes entre o buffer linear e o anel, tratando a volta no fim da área
+static void ringCopy(char *data, uint64_t size, uint64_t pos, void *buf, size_t len, int toRing) {
+    size_t offset = pos & (size - 1);
+    size_t first = len < size - offset ? len : size - offset;
+    if(toRing) {
+        memcpy(data + offset, buf, first);
+        memcpy(data, (char *)buf + first, len - first);
+    } else {
+        memcpy(buf, data + offset, first);
+        memcpy((char *)buf + first, data, len - first);
+    }
+}
+
+size_t shmRingWrite(struct shmRing *ring, const void *buf, size_t len) {
+    struct shmRingHeader *h = ring->header;
+    uint64_t head = h->head;
+    uint64_t tail = __atomic_load_n(&h->tail, __ATOMIC_ACQUIRE);
+    uint64_t space = ring->size - (head - tail);
+    if(len > space) len = space;
+    if(len == 0) return 0;
+
+    ringCopy(ring->data, ring->size, head, (void *)buf, len, 1);
+    __atomic_store_n(&h->head, head + len, __ATOMIC_RELEASE);
+    return len;
+}
+
+size_t shmRingRead(struct shmRing *ring, void *buf, size_t len) {
+    struct shmRingHeader *h = ring->header;
+    uint64_t tail = h->tail;
+    uint64_t head = __atomic_load_n(&h->head, __ATOMIC_ACQUIRE);
+    uint64_t available = head - tail;
+    // anel corrompido pelo outro lado: não lê nada além da capacidade
+    if(available > ring->size) return 0;
+    if(len > available) len = available;
+    if(len == 0) return 0;
+
+    ringCopy(ring->data, ring->size, tail, buf, len, 0);
+    __atomic_store_n(&h->tail, tail + len, __ATOMIC_RELEASE);
+    return len;
+}
@@ -0,0 +1,37 @@
+#ifndef SHMRING_H
+#define SHMRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// buffer circular em memória compartilhada com um produtor (cliente) e um
+// consumidor (servidor). head só é escrito pelo produtor e tail só pelo
+// consumidor, então basta uma barreira de release/acquire em cada lado
+struct shmRingHeader {
+    uint64_t head; // total de bytes escritos
+    char pad1[56]; // head e tail em linhas de cache separadas
+    uint64_t tail; // total de bytes lidos
+    char pad2[56];
+    uint64_t size; // capacidade da área de dados (potência de 2)
+};
+
+struct shmRing {
+    struct shmRingHeader *header;
+    char *data;
+    uint64_t size; // cópia local da capacidade: o outro processo pode alterar o cabeçalho
+    size_t mapped; // tamanho total do mapeamento
+};
+
+#define SHM_RING_DEFAULT_SIZE (1 << 20)
+
+// cria um anel novo em um memfd; *fd recebe o descritor para ser enviado ao outro lado
+int shmRingCreate(struct shmRing *ring, size_t size, int *fd);
+// mapeia um anel recebido de outro processo
+int shmRingAttach(struct shmRing *ring, int fd);
+void shmRingDetach(struct shmRing *ring);
+
+// copiam o que couber e retornam quantos bytes foram transferidos
+size_t shmRingWrite(struct shmRing *ring, const void *buf, size_t len);
+size_t shmRingRead(struct shmRing *ring, void *buf, size_t len);
+
+#endif
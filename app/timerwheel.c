@@ -0,0 +1,117 @@
+#include <stddef.h>
+#include <string.h>
+#include "timerwheel.h"
+
+#define TW_ROOT_MASK (TW_ROOT_SIZE - 1)
+#define TW_LEVEL_MASK (TW_LEVEL_SIZE - 1)
+
+// índice da posição no nível n (0 = primeiro nível acima da raiz) para o tick t
+#define TW_INDEX(t, n) (((t) >> (TW_ROOT_BITS + (n) * TW_LEVEL_BITS)) & TW_LEVEL_MASK)
+
+void timerWheelInit(struct timerWheel *wheel, uint64_t now) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now = now;
+}
+
+void timerInit(struct twTimer *timer, twCallback callback, void *arg) {
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+int timerPending(const struct twTimer *timer) {
+    return timer->pprev != NULL;
+}
+
+static void listAdd(struct twTimer **head, struct twTimer *timer) {
+    timer->next = *head;
+    if(*head) (*head)->pprev = &timer->next;
+    *head = timer;
+    timer->pprev = head;
+}
+
+static void listDel(struct twTimer *timer) {
+    *timer->pprev = timer->next;
+    if(timer->next) timer->next->pprev = timer->pprev;
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// escolhe a lista certa de acordo com a distância até a expiração
+static void internalAdd(struct timerWheel *wheel, struct twTimer *timer) {
+    uint64_t expires = timer->expires;
+    uint64_t delta = expires - wheel->now;
+    struct twTimer **head;
+
+    if(expires < wheel->now) { // já venceu: roda no próximo tick processado
+        head = &wheel->root[wheel->now & TW_ROOT_MASK];
+    } else if(delta < TW_ROOT_SIZE) {
+        head = &wheel->root[expires & TW_ROOT_MASK];
+    } else {
+        int level = 0;
+        if(delta > TW_MAX_DELTA) { // limita ao maior intervalo que a roda cobre
+            expires = wheel->now + TW_MAX_DELTA;
+            timer->expires = expires;
+            delta = TW_MAX_DELTA;
+        }
+        while(level < TW_LEVELS - 1 && delta >= (1ULL << (TW_ROOT_BITS + (level + 1) * TW_LEVEL_BITS)))
+            level++;
+        head = &wheel->levels[level][TW_INDEX(expires, level)];
+    }
+    listAdd(head, timer);
+}
+
+void timerAdd(struct timerWheel *wheel, struct twTimer *timer, uint64_t expires) {
+    if(timerPending(timer)) timerDel(timer);
+    timer->expires = expires;
+    internalAdd(wheel, timer);
+}
+
+void timerDel(struct twTimer *timer) {
+    if(!timerPending(timer)) return;
+    listDel(timer);
+}
+
+// redistribui os timers de uma posição de nível superior nos níveis inferiores
+static int cascade(struct timerWheel *wheel, int level, int index) {
+    struct twTimer *list = wheel->levels[level][index];
+    wheel->levels[level][index] = NULL;
+    while(list) {
+        struct twTimer *timer = list;
+        list = timer->next;
+        timer->next = NULL;
+        timer->pprev = NULL;
+        internalAdd(wheel, timer);
+    }
+    return index;
+}
+
+void timerWheelAdvance(struct timerWheel *wheel, uint64_t now) {
+    while(wheel->now <= now) {
+        int index = wheel->now & TW_ROOT_MASK;
+        // a cada volta completa de um nível, desce uma posição do nível de cima
+        if(index == 0) {
+            for(int level = 0; level < TW_LEVELS; level++)
+                if(cascade(wheel, level, TW_INDEX(wheel->now, level)) != 0) break;
+        }
+
+        // move a posição atual para uma lista de trabalho: os callbacks podem
+        // rearmar ou remover timers (inclusive outros desta mesma lista)
+        struct twTimer *work = NULL;
+        struct twTimer *list = wheel->root[index];
+        wheel->root[index] = NULL;
+        if(list) {
+            work = list;
+            work->pprev = &work;
+        }
+        wheel->now++;
+
+        while(work) {
+            struct twTimer *timer = work;
+            listDel(timer);
+            timer->callback(timer, timer->arg);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <stdint.h>
+
+// roda de timers hierárquica (estilo kernel Linux clássico): o nível 0 tem 256
+// posições de 1 tick cada, e os níveis seguintes têm 64 posições que cobrem
+// intervalos cada vez maiores. Inserir, remover e avançar um tick são O(1)
+// (amortizado), então o servidor não precisa varrer todas as conexões.
+#define TW_ROOT_BITS 8
+#define TW_LEVEL_BITS 6
+#define TW_ROOT_SIZE (1 << TW_ROOT_BITS)
+#define TW_LEVEL_SIZE (1 << TW_LEVEL_BITS)
+#define TW_LEVELS 3 // níveis acima do nível 0
+
+// maior distância (em ticks) representável na roda
+#define TW_MAX_DELTA ((1ULL << (TW_ROOT_BITS + TW_LEVELS * TW_LEVEL_BITS)) - 1)
+
+struct twTimer;
+typedef void (*twCallback)(struct twTimer *timer, void *arg);
+
+// timer intrusivo: fica embutido na estrutura de quem o usa (ex.: a conexão)
+struct twTimer {
+    struct twTimer *next;
+    struct twTimer **pprev; // aponta para o ponteiro que aponta para este timer
+    uint64_t expires;       // tick absoluto de expiração
+    twCallback callback;
+    void *arg;
+};
+
+struct timerWheel {
+    uint64_t now; // próximo tick a ser processado
+    struct twTimer *root[TW_ROOT_SIZE];
+    struct twTimer *levels[TW_LEVELS][TW_LEVEL_SIZE];
+};
+
+void timerWheelInit(struct timerWheel *wheel, uint64_t now);
+void timerInit(struct twTimer *timer, twCallback callback, void *arg);
+int timerPending(const struct twTimer *timer);
+
+// arma (ou rearma) o timer para expirar no tick absoluto expires
+void timerAdd(struct timerWheel *wheel, struct twTimer *timer, uint64_t expires);
+void timerDel(struct twTimer *timer);
+
+// processa todos os ticks até now (inclusive), chamando os callbacks expirados
+void timerWheelAdvance(struct timerWheel *wheel, uint64_t now);
+
+#endif
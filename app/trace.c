@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include "trace.h"
+
+#define TRACE_BUCKETS 40 // 2^39 ns ~ 9 minutos
+
+volatile int traceEnabled = 0;
+
+static const char *phaseNames[TRACE_PHASES] = {"recv", "parse", "access", "open", "write", "commit", "send"};
+
+// histograma log2: o balde b conta as durações em [2^(b-1), 2^b) ns
+struct traceHistogram {
+    uint64_t buckets[TRACE_BUCKETS];
+    uint64_t count, total, max;
+};
+
+static struct traceHistogram histograms[TRACE_PHASES + 1]; // o último é a requisição inteira
+static unsigned sampleEvery = 0;
+static uint64_t requests = 0;
+
+static uint64_t now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void histogramAdd(struct traceHistogram *histogram, uint64_t ns) {
+    unsigned bucket = ns == 0 ? 0 : 64 - __builtin_clzll(ns);
+    if(bucket >= TRACE_BUCKETS) bucket = TRACE_BUCKETS - 1;
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->total += ns;
+    if(ns > histogram->max) histogram->max = ns;
+}
+
+// limite superior (em microssegundos) do balde onde cai o percentil p
+static double histogramPercentile(const struct traceHistogram *histogram, double p) {
+    uint64_t rank = (uint64_t)(p / 100.0 * histogram->count + 0.5), seen = 0;
+    if(rank == 0) rank = 1;
+    for(unsigned b = 0; b < TRACE_BUCKETS; b++) {
+        seen += histogram->buckets[b];
+        if(seen >= rank) return (double)(1ULL << b) / 1000.0;
+    }
+    return histogram->max / 1000.0;
+}
+
+void traceInit(unsigned every) {
+    sampleEvery = every;
+}
+
+void traceBegin(struct traceRequest *request) {
+    memset(request->phase, 0, sizeof(request->phase));
+    request->last = now();
+    request->active = 1;
+}
+
+void traceResume(struct traceRequest *request) {
+    request->last = now();
+}
+
+void traceMark(struct traceRequest *request, enum tracePhase phase) {
+    if(!request->active) return;
+    uint64_t t = now();
+    request->phase[phase] += t - request->last;
+    request->last = t;
+}
+
+void traceEnd(struct traceRequest *request, int fd, const char *name) {
+    if(!request->active) return;
+    request->active = 0;
+    uint64_t total = 0;
+    for(int p = 0; p < TRACE_PHASES; p++) {
+        histogramAdd(&histograms[p], request->phase[p]);
+        total += request->phase[p];
+    }
+    histogramAdd(&histograms[TRACE_PHASES], total);
+
+    if(sampleEvery == 0 || ++requests % sampleEvery != 0) return;
+    printf("[trace] fd %d file %s:", fd, name);
+    for(int p = 0; p < TRACE_PHASES; p++) printf(" %s %.1f", phaseNames[p], request->phase[p] / 1000.0);
+    printf(" total %.1f us\n", total / 1000.0);
+}
+
+void traceDump(void) {
+    printf("[trace] %-7s %10s %10s %10s %10s %10s\n", "phase", "count", "mean us", "p50 us <=", "p99 us <=", "max us");
+    for(int p = 0; p <= TRACE_PHASES; p++) {
+        const struct traceHistogram *histogram = &histograms[p];
+        if(histogram->count == 0) continue;
+        printf("[trace] %-7s %10" PRIu64 " %10.1f %10.1f %10.1f %10.1f\n", p == TRACE_PHASES ? "total" : phaseNames[p],
+               histogram->count, histogram->total / 1000.0 / histogram->count,
+               histogramPercentile(histogram, 50), histogramPercentile(histogram, 99), histogram->max / 1000.0);
+    }
+    // baldes de cada fase, para ver a forma da distribuição (caudas, modos)
+    for(int p = 0; p <= TRACE_PHASES; p++) {
+        const struct traceHistogram *histogram = &histograms[p];
+        if(histogram->count == 0) continue;
+        printf("[trace] %s buckets (us <= count):", p == TRACE_PHASES ? "total" : phaseNames[p]);
+        for(unsigned b = 0; b < TRACE_BUCKETS; b++)
+            if(histogram->buckets[b]) printf(" %g:%" PRIu64, (double)(1ULL << b) / 1000.0, histogram->buckets[b]);
+        printf("\n");
+    }
+    fflush(stdout);
+}
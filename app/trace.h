@@ -0,0 +1,80 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// rastreamento do caminho de um upload de uma mensagem, fase a fase.
+//
+// Pontos estáticos USDT (provider "fileserver"): request__start(fd),
+// phase(fd, fase) no fim de cada fase e request__done(fd, nome). Com
+// <sys/sdt.h> eles viram um nop no binário, ativado só quando um bpftrace/perf
+// se prende a ele (que mede o tempo entre eles); sem o cabeçalho, somem.
+//
+// O rastreador interno (--trace, ou SIGUSR2 com o servidor rodando) mede cada
+// fase com o relógio monotônico, acumula um histograma log2 por fase e imprime
+// uma em cada N requisições inteira. SIGUSR1 imprime os histogramas.
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define TRACE_HAVE_SDT 1
+#endif
+#endif
+
+#ifdef TRACE_HAVE_SDT
+#define TRACE_PROBE1(name, a) DTRACE_PROBE1(fileserver, name, a)
+#define TRACE_PROBE2(name, a, b) DTRACE_PROBE2(fileserver, name, a, b)
+#else
+#define TRACE_PROBE1(name, a) ((void)0)
+#define TRACE_PROBE2(name, a, b) ((void)0)
+#endif
+
+enum tracePhase {
+    TRACE_RECV,   // recv das partes da mensagem (sem a espera entre elas)
+    TRACE_PARSE,  // separar nome, extensão e conteúdo
+    TRACE_ACCESS, // access(): o arquivo já existe?
+    TRACE_OPEN,   // criar o arquivo temporário
+    TRACE_WRITE,  // copiar o conteúdo (fwrite)
+    TRACE_COMMIT, // fclose + rename
+    TRACE_SEND,   // replicação e envio da confirmação
+    TRACE_PHASES
+};
+
+// medição em andamento de uma requisição (uma por conexão)
+struct traceRequest {
+    uint64_t last;                 // fim da última fase medida
+    uint64_t phase[TRACE_PHASES];  // nanossegundos gastos em cada fase
+    int active;                    // começou com o rastreador ligado
+};
+
+extern volatile int traceEnabled;
+
+// pontos usados no servidor: o probe USDT sempre, o rastreador interno só se ligado
+#define TRACE_BEGIN(request, fd) do { \
+        TRACE_PROBE1(request__start, fd); \
+        if(traceEnabled) traceBegin(request); \
+    } while(0)
+#define TRACE_RESUME(request) do { if(traceEnabled) traceResume(request); } while(0)
+#define TRACE_PHASE(request, fd, which) do { \
+        TRACE_PROBE2(phase, fd, which); \
+        if(traceEnabled) traceMark(request, which); \
+    } while(0)
+#define TRACE_END(request, fd, name) do { \
+        TRACE_PROBE2(request__done, fd, name); \
+        if(traceEnabled) traceEnd(request, fd, name); \
+    } while(0)
+
+// sampleEvery: imprime uma requisição inteira a cada sampleEvery (0 = nunca).
+// O rastreador começa desligado; quem liga e desliga é traceEnabled
+void traceInit(unsigned sampleEvery);
+// começa a medir uma requisição
+void traceBegin(struct traceRequest *request);
+// retoma a contagem depois de uma espera que não pertence a nenhuma fase
+void traceResume(struct traceRequest *request);
+// atribui o tempo desde a última marca à fase
+void traceMark(struct traceRequest *request, enum tracePhase phase);
+// encerra a requisição: soma aos histogramas e talvez imprime a amostra
+void traceEnd(struct traceRequest *request, int fd, const char *name);
+// imprime os histogramas acumulados até agora
+void traceDump(void);
+
+#endif
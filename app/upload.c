@@ -0,0 +1,350 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "upload.h"
+
+static struct uploadSession *sessions = NULL;
+static struct timerWheel *wheel = NULL;
+static uint64_t maxUploadSize = 0;
+static unsigned abandonedAfter = 0; // segundos sem progresso até o upload sair do disco
+static uint64_t sweepInterval = 0;
+static struct twTimer sweepTimer;
+
+static void sweepAbandoned(struct twTimer *timer, void *arg);
+
+void uploadInit(struct timerWheel *timerWheel, uint64_t maxSize, unsigned abandonedSeconds, uint64_t sweepTicks) {
+    wheel = timerWheel;
+    maxUploadSize = maxSize;
+    abandonedAfter = abandonedSeconds;
+    sweepInterval = sweepTicks;
+    timerInit(&sweepTimer, sweepAbandoned, NULL);
+    // sobras de execuções anteriores também contam
+    sweepAbandoned(&sweepTimer, NULL);
+}
+
+// o id vira parte de nomes de arquivo: só letras e dígitos
+static int validId(const char *id) {
+    size_t len = strlen(id);
+    if(len == 0 || len > UPLOAD_ID_MAX) return 0;
+    for(const char *c = id; *c; c++)
+        if(!((*c >= '0' && *c <= '9') || (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z'))) return 0;
+    return 1;
+}
+
+static void sessionUnlink(struct uploadSession *session) {
+    if(session->prev) session->prev->next = session->next;
+    else sessions = session->next;
+    if(session->next) session->next->prev = session->prev;
+}
+
+static void sessionFree(struct uploadSession *session) {
+    sessionUnlink(session);
+    timerDel(&session->timer);
+    if(session->fd >= 0) close(session->fd);
+    free(session);
+}
+
+// grava o progresso de cada faixa. Os dados vão para o disco antes, então um
+// offset salvo nunca aponta para bytes que ainda estavam só no cache
+static int checkpointWrite(struct uploadSession *session) {
+    char tmpName[sizeof(session->checkpointName) + 4];
+    if(fdatasync(session->fd) != 0) return -1;
+
+    snprintf(tmpName, sizeof(tmpName), "%s.tmp", session->checkpointName);
+    FILE *f = fopen(tmpName, "w");
+    if(f == NULL) return -1;
+    fprintf(f, "%s\n%llu %u\n", session->name, (unsigned long long)session->size, session->rangeCount);
+    for(unsigned i = 0; i < session->rangeCount; i++) {
+        if(!(session->startedMask & (1ULL << i))) continue;
+        fprintf(f, "%u %llu %llu %llu\n", i, (unsigned long long)session->start[i],
+                (unsigned long long)session->end[i], (unsigned long long)session->progress[i]);
+    }
+    int ret = 0;
+    if(fflush(f) != 0 || fdatasync(fileno(f)) != 0) ret = -1;
+    if(fclose(f) != 0) ret = -1;
+    // rename troca o checkpoint antigo pelo novo de uma vez
+    if(ret == 0 && rename(tmpName, session->checkpointName) != 0) ret = -1;
+    if(ret != 0) unlink(tmpName);
+    else session->unsynced = 0;
+    return ret;
+}
+
+// ninguém usa a sessão há um tempo: salva o progresso e tira da memória.
+// Os arquivos ficam no disco para um "resume" futuro
+static void sessionExpired(struct twTimer *timer, void *arg) {
+    struct uploadSession *session = arg;
+    printf("[log] upload %s of %s idle, progress saved\n", session->id, session->name);
+    checkpointWrite(session);
+    sessionFree(session);
+}
+
+static struct uploadSession *sessionNew(const char *id) {
+    struct uploadSession *session = calloc(1, sizeof(*session));
+    if(session == NULL) return NULL;
+    snprintf(session->id, sizeof(session->id), "%s", id);
+    snprintf(session->partName, sizeof(session->partName), ".upload-%s.part", id);
+    snprintf(session->checkpointName, sizeof(session->checkpointName), ".upload-%s.ckpt", id);
+    session->fd = -1;
+    timerInit(&session->timer, sessionExpired, session);
+    return session;
+}
+
+static void sessionInsert(struct uploadSession *session) {
+    session->next = sessions;
+    session->prev = NULL;
+    if(sessions) sessions->prev = session;
+    sessions = session;
+}
+
+// recarrega uma sessão a partir do checkpoint (ex.: depois de reiniciar o servidor)
+static struct uploadSession *sessionLoad(const char *id) {
+    struct uploadSession *session = sessionNew(id);
+    if(session == NULL) return NULL;
+
+    FILE *f = fopen(session->checkpointName, "r");
+    if(f == NULL) {
+        free(session);
+        return NULL;
+    }
+    unsigned long long size, start, end, progress;
+    unsigned index;
+    int ok = fgets(session->name, sizeof(session->name), f) != NULL;
+    session->name[strcspn(session->name, "\n")] = '\0';
+    if(ok) ok = fscanf(f, "%llu %u", &size, &session->rangeCount) == 2 && session->rangeCount > 0 && session->rangeCount <= UPLOAD_MAX_RANGES;
+    if(ok) session->size = size;
+    while(ok && fscanf(f, "%u %llu %llu %llu", &index, &start, &end, &progress) == 4) {
+        if(index >= session->rangeCount || start > progress || progress > end || end > size) {
+            ok = 0;
+            break;
+        }
+        session->start[index] = start;
+        session->end[index] = end;
+        session->progress[index] = progress;
+        session->startedMask |= 1ULL << index;
+    }
+    fclose(f);
+
+    if(ok) session->fd = open(session->partName, O_WRONLY | O_CLOEXEC);
+    if(!ok || session->fd < 0) {
+        free(session);
+        return NULL;
+    }
+    sessionInsert(session);
+    return session;
+}
+
+static struct uploadSession *sessionInMemory(const char *id) {
+    for(struct uploadSession *session = sessions; session; session = session->next)
+        if(strcmp(session->id, id) == 0) return session;
+    return NULL;
+}
+
+static struct uploadSession *sessionFind(const char *id) {
+    struct uploadSession *session = sessionInMemory(id);
+    return session ? session : sessionLoad(id);
+}
+
+// apaga o arquivo parcial e o checkpoint de uploads fora da memória cujos
+// arquivos não mudam há abandonedAfter segundos (o pwrite atualiza o mtime do
+// parcial, cada checkpoint o do seu arquivo). Sem isso, cada upload nunca
+// retomado ocuparia o tamanho declarado no disco para sempre
+static void sweepAbandoned(struct twTimer *timer, void *arg) {
+    DIR *dir = opendir(".");
+    if(dir != NULL) {
+        time_t now = time(NULL);
+        struct dirent *entry;
+        while((entry = readdir(dir)) != NULL) {
+            // só ".upload-<id>.ckpt" e ".upload-<id>.part"; o parcial sem checkpoint é de um servidor que caiu
+            char id[UPLOAD_ID_MAX + 1];
+            size_t len = strlen(entry->d_name);
+            if(strncmp(entry->d_name, ".upload-", 8) != 0 || len < 8 + 5 || len - 8 - 5 > UPLOAD_ID_MAX) continue;
+            if(strcmp(entry->d_name + len - 5, ".ckpt") != 0 && strcmp(entry->d_name + len - 5, ".part") != 0) continue;
+            memcpy(id, entry->d_name + 8, len - 8 - 5);
+            id[len - 8 - 5] = '\0';
+            if(!validId(id) || sessionInMemory(id) != NULL) continue;
+
+            char partName[UPLOAD_ID_MAX + 16], checkpointName[UPLOAD_ID_MAX + 16];
+            struct stat st;
+            time_t newest = 0;
+            snprintf(partName, sizeof(partName), ".upload-%s.part", id);
+            snprintf(checkpointName, sizeof(checkpointName), ".upload-%s.ckpt", id);
+            if(stat(partName, &st) == 0 && st.st_mtime > newest) newest = st.st_mtime;
+            if(stat(checkpointName, &st) == 0 && st.st_mtime > newest) newest = st.st_mtime;
+            if(newest == 0 || now - newest < (time_t)abandonedAfter) continue;
+
+            printf("[log] upload %s abandoned, removing its files\n", id);
+            unlink(partName);
+            unlink(checkpointName);
+        }
+        closedir(dir);
+    }
+    timerAdd(wheel, &sweepTimer, wheel->now + sweepInterval);
+}
+
+struct uploadSession *uploadAcquire(const char *id, const char *name, uint64_t size,
+                                    unsigned rangeCount, const char **error) {
+    if(!validId(id)) {
+        *error = "invalid upload id";
+        return NULL;
+    }
+    struct uploadSession *session = sessionFind(id);
+    if(session) {
+        // todas as faixas precisam descrever o mesmo arquivo
+        if(strcmp(session->name, name) != 0 || session->size != size || session->rangeCount != rangeCount) {
+            *error = "range does not match upload";
+            if(session->active == 0) sessionFree(session);
+            return NULL;
+        }
+        timerDel(&session->timer);
+        session->active++;
+        return session;
+    }
+    if(rangeCount == 0 || rangeCount > UPLOAD_MAX_RANGES) {
+        *error = "invalid range count";
+        return NULL;
+    }
+    // o tamanho vem do cliente e vira espaço em disco antes de qualquer byte chegar
+    if(size > maxUploadSize) {
+        *error = "file too large";
+        return NULL;
+    }
+
+    session = sessionNew(id);
+    if(session == NULL) {
+        *error = "out of memory";
+        return NULL;
+    }
+    snprintf(session->name, sizeof(session->name), "%s", name);
+    session->size = size;
+    session->rangeCount = rangeCount;
+
+    // pré-aloca o arquivo inteiro: as faixas chegam fora de ordem e o disco
+    // não precisa crescer o arquivo a cada pwrite. Sem espaço é erro (e o que
+    // chegou a ser alocado sai junto com o arquivo); só um sistema de arquivos
+    // sem fallocate fica com um arquivo esparso, que o pwrite preenche
+    session->fd = open(session->partName, O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0644);
+    if(session->fd < 0) {
+        *error = "could not create file";
+        free(session);
+        return NULL;
+    }
+    if(size > 0 && fallocate(session->fd, 0, 0, size) != 0 && (errno != EOPNOTSUPP || ftruncate(session->fd, size) != 0)) {
+        *error = "could not allocate file";
+        close(session->fd);
+        unlink(session->partName);
+        free(session);
+        return NULL;
+    }
+
+    session->active = 1;
+    sessionInsert(session);
+    return session;
+}
+
+void uploadRelease(struct uploadSession *session, uint64_t expires) {
+    if(--session->active > 0) return;
+    timerAdd(wheel, &session->timer, expires);
+}
+
+int uploadResumeOffset(const char *id, unsigned index, uint64_t *offset, uint64_t expires) {
+    if(!validId(id) || index >= UPLOAD_MAX_RANGES) return 0;
+    struct uploadSession *session = sessionFind(id);
+    if(session == NULL) return 0;
+
+    int ret = 1;
+    if(session->writingMask & (1ULL << index)) ret = -1;
+    else if(!(session->startedMask & (1ULL << index))) ret = 0;
+    else *offset = session->progress[index];
+
+    // carregada só para responder: volta a expirar se ninguém a usar
+    if(session->active == 0 && !timerPending(&session->timer)) {
+        session->active = 1;
+        uploadRelease(session, expires);
+    }
+    return ret;
+}
+
+// as faixas, na ordem dos índices, cobrem [0, size) sem buracos nem sobreposição:
+// a faixa index encosta nas vizinhas que já foram vistas
+static int rangeFits(const struct uploadSession *session, unsigned index, uint64_t start, uint64_t end) {
+    if(index == 0 ? start != 0 : (session->startedMask & (1ULL << (index - 1))) && session->end[index - 1] != start)
+        return 0;
+    if(index == session->rangeCount - 1) return end == session->size;
+    return !(session->startedMask & (1ULL << (index + 1))) || session->start[index + 1] == end;
+}
+
+int uploadBeginRange(struct uploadSession *session, unsigned index, uint64_t offset,
+                     uint64_t length, const char **error) {
+    uint64_t bit = 1ULL << index;
+    if(session->writingMask & bit) {
+        *error = "range already in progress";
+        return -1;
+    }
+    if(session->startedMask & bit) {
+        // retomada: continua de qualquer ponto já escrito, mas a faixa não muda de fim
+        if(offset < session->start[index] || offset > session->progress[index] || offset + length != session->end[index]) {
+            *error = "range does not match upload";
+            return -1;
+        }
+    } else {
+        if(!rangeFits(session, index, offset, offset + length)) {
+            *error = "range does not tile the file";
+            return -1;
+        }
+        session->start[index] = offset;
+        session->end[index] = offset + length;
+        session->startedMask |= bit;
+    }
+    session->progress[index] = offset;
+    session->writingMask |= bit;
+    return 0;
+}
+
+int uploadWrite(struct uploadSession *session, unsigned index, const void *data, size_t len) {
+    const char *p = data;
+    while(len > 0) {
+        ssize_t count = pwrite(session->fd, p, len, session->progress[index]);
+        if(count < 0) {
+            if(errno == EINTR) continue;
+            return -1;
+        }
+        p += count;
+        session->progress[index] += count;
+        session->unsynced += count;
+        len -= count;
+    }
+    if(session->unsynced >= UPLOAD_CHECKPOINT_BYTES) checkpointWrite(session);
+    return 0;
+}
+
+int uploadEndRange(struct uploadSession *session, unsigned index) {
+    session->writingMask &= ~(1ULL << index);
+    for(unsigned i = 0; i < session->rangeCount; i++)
+        if(!(session->startedMask & (1ULL << i)) || session->progress[i] != session->end[i]
+           || !rangeFits(session, i, session->start[i], session->end[i])) {
+            // ainda falta alguma faixa: guarda o ponto de retomada desta
+            checkpointWrite(session);
+            return 0;
+        }
+    return 1;
+}
+
+int uploadCommit(struct uploadSession *session, int *overwritten) {
+    *overwritten = access(session->name, F_OK) == 0;
+    int ret = 0;
+    if(close(session->fd) != 0) ret = -1;
+    session->fd = -1;
+    // rename é atômico: quem lê o arquivo vê a versão antiga ou a nova inteira
+    if(ret == 0 && rename(session->partName, session->name) != 0) ret = -1;
+    if(ret != 0) unlink(session->partName);
+    unlink(session->checkpointName);
+    sessionFree(session);
+    return ret;
+}
@@ -0,0 +1,72 @@
+#ifndef UPLOAD_H
+#define UPLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "timerwheel.h"
+
+// upload de um arquivo grande em faixas (ranges) enviadas em paralelo por
+// várias conexões. Cada faixa é escrita com pwrite() direto na sua posição de
+// um arquivo temporário pré-alocado; quando todas chegam, ele é renomeado
+// para o nome final (commit atômico: nunca fica um arquivo truncado no lugar).
+//
+// O progresso de cada faixa é salvo periodicamente em um checkpoint em disco
+// (".upload-<id>.ckpt"), sempre depois de um fdatasync() do arquivo parcial.
+// Se a conexão cair ou o cliente morrer, ele pergunta com "resume" de onde
+// continuar e manda só o que falta, mesmo depois de o servidor reiniciar.
+// Um upload que nunca é retomado tem o arquivo parcial e o checkpoint apagados
+// depois de um prazo bem maior que o da sessão em memória.
+#define UPLOAD_ID_MAX 32
+#define UPLOAD_NAME_MAX 256
+#define UPLOAD_MAX_RANGES 64
+#define UPLOAD_CHECKPOINT_BYTES (8 << 20) // salva o progresso a cada 8 MiB escritos
+
+struct uploadSession {
+    struct uploadSession *next, *prev;
+    char id[UPLOAD_ID_MAX + 1];
+    char name[UPLOAD_NAME_MAX];             // nome final do arquivo
+    char partName[UPLOAD_ID_MAX + 16];       // ".upload-<id>.part"
+    char checkpointName[UPLOAD_ID_MAX + 16]; // ".upload-<id>.ckpt"
+    int fd;
+    uint64_t size;
+    unsigned rangeCount;
+    // por faixa: início, fim (exclusivo) e próximo offset a escrever
+    uint64_t start[UPLOAD_MAX_RANGES], end[UPLOAD_MAX_RANGES], progress[UPLOAD_MAX_RANGES];
+    uint64_t startedMask; // bit i = faixa i já foi vista
+    uint64_t writingMask; // bit i = alguma conexão está enviando a faixa i
+    uint64_t unsynced;    // bytes escritos desde o último checkpoint
+    unsigned active;      // conexões usando esta sessão agora
+    struct twTimer timer; // tira a sessão da memória se ficar abandonada
+};
+
+// roda de timers usada para expirar sessões abandonadas e maior arquivo aceito
+// (o tamanho declarado é pré-alocado em disco assim que a primeira faixa chega).
+// Uploads que ficam abandonedSeconds sem progresso saem também do disco: o
+// diretório é varrido agora e a cada sweepTicks
+void uploadInit(struct timerWheel *wheel, uint64_t maxSize, unsigned abandonedSeconds, uint64_t sweepTicks);
+
+// encontra a sessão pelo id (na memória ou no checkpoint em disco) ou cria
+// uma nova. Retorna NULL e uma mensagem em *error se os parâmetros forem inválidos
+struct uploadSession *uploadAcquire(const char *id, const char *name, uint64_t size,
+                                    unsigned rangeCount, const char **error);
+// a conexão deixou de usar a sessão; se ninguém mais usar, expira em expires
+void uploadRelease(struct uploadSession *session, uint64_t expires);
+
+// resposta ao "resume": de onde a faixa index deve continuar.
+// Retorna 1 com *offset preenchido, 0 se não há progresso salvo, -1 se a faixa
+// ainda está sendo enviada por outra conexão. Uma sessão recarregada do disco
+// só para responder volta a expirar em expires
+int uploadResumeOffset(const char *id, unsigned index, uint64_t *offset, uint64_t expires);
+
+// começa (ou retoma) a faixa index em [offset, offset + length)
+int uploadBeginRange(struct uploadSession *session, unsigned index, uint64_t offset,
+                     uint64_t length, const char **error);
+// escreve os próximos bytes da faixa
+int uploadWrite(struct uploadSession *session, unsigned index, const void *data, size_t len);
+// a conexão parou de enviar a faixa (completa ou não); retorna 1 quando todas as faixas chegaram
+int uploadEndRange(struct uploadSession *session, unsigned index);
+// renomeia o arquivo temporário para o nome final e libera a sessão.
+// *overwritten indica se já existia um arquivo com esse nome
+int uploadCommit(struct uploadSession *session, int *overwritten);
+
+#endif
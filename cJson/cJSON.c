@@ -42,11 +42,13 @@
 #include <math.h>
 #include <stdlib.h>
 #include <limits.h>
-#include <ctype.h>
 #include <float.h>
+#include <stdint.h>
 
-#ifdef ENABLE_LOCALES
-#include <locale.h>
+/* SSE2/AVX2 kernels for the hot scanning loops, selected at runtime; define CJSON_DISABLE_SIMD to only use the scalar code */
+#if !defined(CJSON_DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define CJSON_SIMD_X86
+#include <immintrin.h>
 #endif
 
 #if defined(_MSC_VER)
@@ -116,6 +118,74 @@ CJSON_PUBLIC(double) cJSON_GetNumberValue(const cJSON * const item)
     return item->valuedouble;
 }
 
+#define cJSON_NumberIsInteger (cJSON_NumberIsInt64 | cJSON_NumberIsUint64)
+
+/* valueint64 only counts while it still matches valuedouble, writes to valuedouble (cJSON_SetIntValue) don't clear the flags */
+static cJSON_bool number_is_int64(const cJSON * const item)
+{
+    return ((item->type & cJSON_NumberIsInt64) != 0) && ((double)item->valueint64 == item->valuedouble);
+}
+
+static cJSON_bool number_is_uint64(const cJSON * const item)
+{
+    return ((item->type & cJSON_NumberIsUint64) != 0) && ((double)(uint64_t)item->valueint64 == item->valuedouble);
+}
+
+/* store a uint64_t above INT64_MAX in valueint64 without an implementation defined conversion */
+static int64_t int64_from_uint64(const uint64_t number)
+{
+    return (int64_t)(number - (UINT64_C(1) << 63)) - INT64_MAX - 1;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_GetInt64Value(const cJSON * const item, int64_t * const value)
+{
+    if (!cJSON_IsNumber(item) || (value == NULL) || number_is_uint64(item))
+    {
+        return false;
+    }
+    if (number_is_int64(item))
+    {
+        *value = item->valueint64;
+        return true;
+    }
+
+    /* 2^63 is exact as a double, INT64_MAX is not */
+    if ((item->valuedouble >= -9223372036854775808.0) && (item->valuedouble < 9223372036854775808.0)
+            && (item->valuedouble == (double)(int64_t)item->valuedouble))
+    {
+        *value = (int64_t)item->valuedouble;
+        return true;
+    }
+
+    return false;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_GetUint64Value(const cJSON * const item, uint64_t * const value)
+{
+    if (!cJSON_IsNumber(item) || (value == NULL))
+    {
+        return false;
+    }
+    if (number_is_int64(item) || number_is_uint64(item))
+    {
+        if ((item->type & cJSON_NumberIsInt64) && (item->valueint64 < 0))
+        {
+            return false;
+        }
+        *value = (uint64_t)item->valueint64;
+        return true;
+    }
+
+    if ((item->valuedouble >= 0) && (item->valuedouble < 18446744073709551616.0)
+            && (item->valuedouble == (double)(uint64_t)item->valuedouble))
+    {
+        *value = (uint64_t)item->valuedouble;
+        return true;
+    }
+
+    return false;
+}
+
 /* This is a safeguard to prevent copy-pasters from using incompatible C and header files */
 #if (CJSON_VERSION_MAJOR != 1) || (CJSON_VERSION_MINOR != 7) || (CJSON_VERSION_PATCH != 18)
     #error cJSON.h and cJSON.c have different versions. Make sure that both have the same.
@@ -130,6 +200,17 @@ CJSON_PUBLIC(const char*) cJSON_Version(void)
 }
 
 /* Case insensitive string comparison, doesn't consider two NULL pointers equal though */
+/* only ASCII letters are folded, independent of the locale; object_key_hash folds the same way */
+static unsigned char ascii_tolower(const unsigned char character)
+{
+    if ((character >= 'A') && (character <= 'Z'))
+    {
+        return (unsigned char)(character + ('a' - 'A'));
+    }
+
+    return character;
+}
+
 static int case_insensitive_strcmp(const unsigned char *string1, const unsigned char *string2)
 {
     if ((string1 == NULL) || (string2 == NULL))
@@ -142,7 +223,7 @@ static int case_insensitive_strcmp(const unsigned char *string1, const unsigned
         return 0;
     }
 
-    for(; tolower(*string1) == tolower(*string2); (void)string1++, string2++)
+    for(; ascii_tolower(*string1) == ascii_tolower(*string2); (void)string1++, string2++)
     {
         if (*string1 == '\0')
         {
@@ -150,7 +231,7 @@ static int case_insensitive_strcmp(const unsigned char *string1, const unsigned
         }
     }
 
-    return tolower(*string1) - tolower(*string2);
+    return ascii_tolower(*string1) - ascii_tolower(*string2);
 }
 
 typedef struct internal_hooks
@@ -237,6 +318,27 @@ CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks)
     }
 }
 
+/* Index of the children of a large array or object, see CJSON_INDEX_THRESHOLD.
+ * Objects get a hash table: open addressing with linear probing over the ASCII case folded key hash,
+ * so that case sensitive and case insensitive lookups can both use it.
+ * Arrays get their children in order, which is rebuilt from the list after a change in the middle.
+ * Either one follows the header in the same allocation. */
+typedef struct
+{
+    uint32_t hash;
+    cJSON *item;
+} object_index_entry;
+
+struct cJSON_Index
+{
+    size_t count; /* children */
+    size_t capacity; /* entries, a power of two at least twice the count, or items */
+    cJSON_bool in_arena; /* taken from a cJSON_Arena, which frees it */
+    cJSON_bool stale; /* items no longer follows the list, only until the mutator calls index_sync */
+    object_index_entry *entries; /* objects */
+    cJSON **items; /* arrays */
+};
+
 /* Internal constructor. */
 static cJSON *cJSON_New_Item(const internal_hooks * const hooks)
 {
@@ -256,6 +358,12 @@ CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
     while (item != NULL)
     {
         next = item->next;
+        /* the index is released before the children: it is the largest and usually the most
+         * recent block of a parsed container, freeing it last makes malloc trim the heap */
+        if (!(item->type & cJSON_IsReference) && (item->index != NULL) && !item->index->in_arena)
+        {
+            global_hooks.deallocate(item->index);
+        }
         if (!(item->type & cJSON_IsReference) && (item->child != NULL))
         {
             cJSON_Delete(item->child);
@@ -275,289 +383,2820 @@ CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
     }
 }
 
-/* get the decimal point character of the current locale */
-static unsigned char get_decimal_point(void)
+/* Arena allocation for cJSON_ParseInArena.
+ * An arena is a list of blocks that are filled from front to back. Resetting only rewinds to the
+ * first block, the following blocks are kept and reused by the next documents. */
+typedef union
 {
-#ifdef ENABLE_LOCALES
-    struct lconv *lconv = localeconv();
-    return (unsigned char) lconv->decimal_point[0];
-#else
-    return '.';
-#endif
-}
+    double number;
+    void *pointer;
+    size_t size;
+} arena_alignment;
 
-typedef struct
+#define arena_align(size) ((((size) + sizeof(arena_alignment) - 1) / sizeof(arena_alignment)) * sizeof(arena_alignment))
+
+typedef struct arena_block
 {
-    const unsigned char *content;
-    size_t length;
-    size_t offset;
-    size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
-    internal_hooks hooks;
-} parse_buffer;
+    struct arena_block *next;
+    size_t size; /* usable bytes after the header */
+    size_t used;
+} arena_block;
 
-/* check if the given size is left to read in a given parse buffer (starting with 1) */
-#define can_read(buffer, size) ((buffer != NULL) && (((buffer)->offset + size) <= (buffer)->length))
-/* check if the buffer can be accessed at the given index (starting with 0) */
-#define can_access_at_index(buffer, index) ((buffer != NULL) && (((buffer)->offset + index) < (buffer)->length))
-#define cannot_access_at_index(buffer, index) (!can_access_at_index(buffer, index))
-/* get a pointer to the buffer at the position */
-#define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
+struct cJSON_Arena
+{
+    arena_block *first;
+    arena_block *current;
+    /* false when the arena lives in a buffer supplied by the caller */
+    cJSON_bool growable;
+};
 
-/* Parse the input text to generate a number, and populate the result into item. */
-static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_buffer)
+#define arena_header_size arena_align(sizeof(arena_block))
+#define arena_block_data(block) ((unsigned char*)(block) + arena_header_size)
+
+CJSON_PUBLIC(cJSON_Arena *) cJSON_CreateArena(size_t initial_size)
 {
-    double number = 0;
-    unsigned char *after_end = NULL;
-    unsigned char number_c_string[64];
-    unsigned char decimal_point = get_decimal_point();
-    size_t i = 0;
+    cJSON_Arena *arena = NULL;
+    arena_block *block = NULL;
+    size_t head_size = arena_align(sizeof(cJSON_Arena)) + arena_header_size;
 
-    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+    initial_size = arena_align(initial_size);
+    if ((initial_size == 0) || (initial_size > ((size_t)-1 - head_size)))
     {
-        return false;
+        return NULL;
     }
 
-    /* copy the number into a temporary buffer and replace '.' with the decimal point
-     * of the current locale (for strtod)
-     * This also takes care of '\0' not necessarily being available for marking the end of the input */
-    for (i = 0; (i < (sizeof(number_c_string) - 1)) && can_access_at_index(input_buffer, i); i++)
-    {
-        switch (buffer_at_offset(input_buffer)[i])
-        {
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-            case '+':
-            case '-':
-            case 'e':
-            case 'E':
-                number_c_string[i] = buffer_at_offset(input_buffer)[i];
-                break;
+    arena = (cJSON_Arena*)global_hooks.allocate(head_size + initial_size);
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    block = (arena_block*)((unsigned char*)arena + arena_align(sizeof(cJSON_Arena)));
+    block->next = NULL;
+    block->size = initial_size;
+    block->used = 0;
 
-            case '.':
-                number_c_string[i] = decimal_point;
-                break;
+    arena->first = block;
+    arena->current = block;
+    arena->growable = true;
 
-            default:
-                goto loop_end;
-        }
+    return arena;
+}
+
+CJSON_PUBLIC(cJSON_Arena *) cJSON_CreateArenaInBuffer(void *buffer, size_t length)
+{
+    cJSON_Arena *arena = NULL;
+    arena_block *block = NULL;
+    size_t head_size = arena_align(sizeof(cJSON_Arena)) + arena_header_size;
+    /* the buffer is only guaranteed to be aligned for its own type, so skip to the next boundary */
+    size_t padding = (sizeof(arena_alignment) - ((size_t)buffer % sizeof(arena_alignment))) % sizeof(arena_alignment);
+
+    if ((buffer == NULL) || (length < (padding + head_size + sizeof(arena_alignment))))
+    {
+        return NULL;
     }
-loop_end:
-    number_c_string[i] = '\0';
 
-    number = strtod((const char*)number_c_string, (char**)&after_end);
-    if (number_c_string == after_end)
+    arena = (cJSON_Arena*)((unsigned char*)buffer + padding);
+    block = (arena_block*)((unsigned char*)arena + arena_align(sizeof(cJSON_Arena)));
+    block->next = NULL;
+    block->size = ((length - padding - head_size) / sizeof(arena_alignment)) * sizeof(arena_alignment);
+    block->used = 0;
+
+    arena->first = block;
+    arena->current = block;
+    arena->growable = false;
+
+    return arena;
+}
+
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena)
+{
+    if (arena == NULL)
     {
-        return false; /* parse_error */
+        return;
     }
 
-    item->valuedouble = number;
+    arena->first->used = 0;
+    arena->current = arena->first;
+}
 
-    /* use saturation in case of overflow */
-    if (number >= INT_MAX)
+CJSON_PUBLIC(void) cJSON_DeleteArena(cJSON_Arena *arena)
+{
+    arena_block *block = NULL;
+    arena_block *next = NULL;
+
+    if (arena == NULL)
     {
-        item->valueint = INT_MAX;
+        return;
     }
-    else if (number <= (double)INT_MIN)
+
+    /* the first block is part of the arena's own allocation */
+    for (block = arena->first->next; block != NULL; block = next)
     {
-        item->valueint = INT_MIN;
+        next = block->next;
+        global_hooks.deallocate(block);
     }
-    else
+    if (arena->growable)
     {
-        item->valueint = (int)number;
+        global_hooks.deallocate(arena);
     }
-
-    item->type = cJSON_Number;
-
-    input_buffer->offset += (size_t)(after_end - number_c_string);
-    return true;
 }
 
-/* don't ask me, but the original cJSON_SetNumberValue returns an integer or double */
-CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number)
+static void *arena_allocate(cJSON_Arena * const arena, size_t size)
 {
-    if (number >= INT_MAX)
+    arena_block *block = arena->current;
+    unsigned char *memory = NULL;
+
+    if (size > ((size_t)-1 - sizeof(arena_alignment)))
     {
-        object->valueint = INT_MAX;
+        return NULL;
     }
-    else if (number <= (double)INT_MIN)
+    size = arena_align(size);
+
+    while ((block->size - block->used) < size)
     {
-        object->valueint = INT_MIN;
+        if (block->next == NULL)
+        {
+            /* grow geometrically, so a large document needs only a few blocks */
+            arena_block *new_block = NULL;
+            size_t new_size = block->size * 2;
+
+            if (!arena->growable)
+            {
+                return NULL;
+            }
+            if (new_size < size)
+            {
+                new_size = size;
+            }
+            if (new_size > ((size_t)-1 - arena_header_size))
+            {
+                return NULL;
+            }
+            new_block = (arena_block*)global_hooks.allocate(arena_header_size + new_size);
+            if (new_block == NULL)
+            {
+                return NULL;
+            }
+            new_block->next = NULL;
+            new_block->size = new_size;
+            block->next = new_block;
+        }
+        /* blocks after the current one only hold data from before the last reset */
+        block = block->next;
+        block->used = 0;
+        arena->current = block;
     }
-    else
+
+    memory = arena_block_data(block) + block->used;
+    block->used += size;
+
+    return memory;
+}
+
+/* FNV-1a over the key with ASCII letters folded to lower case */
+static uint32_t object_key_hash(const unsigned char *key)
+{
+    uint32_t hash = 2166136261U;
+
+    for (; *key != '\0'; key++)
     {
-        object->valueint = (int)number;
+        hash = (hash ^ ascii_tolower(*key)) * 16777619U;
     }
 
-    return object->valuedouble = number;
+    return hash;
 }
 
-/* Note: when passing a NULL valuestring, cJSON_SetValuestring treats this as an error and return NULL */
-CJSON_PUBLIC(char*) cJSON_SetValuestring(cJSON *object, const char *valuestring)
+static void object_index_put(struct cJSON_Index * const index, cJSON * const item, const uint32_t hash)
 {
-    char *copy = NULL;
-    size_t v1_len;
-    size_t v2_len;
-    /* if object's type is not cJSON_String or is cJSON_IsReference, it should not set valuestring */
-    if ((object == NULL) || !(object->type & cJSON_String) || (object->type & cJSON_IsReference))
+    size_t mask = index->capacity - 1;
+    size_t slot = hash & mask;
+
+    while (index->entries[slot].item != NULL)
     {
-        return NULL;
+        slot = (slot + 1) & mask;
     }
-    /* return NULL if the object is corrupted or valuestring is NULL */
-    if (object->valuestring == NULL || valuestring == NULL)
+    index->entries[slot].hash = hash;
+    index->entries[slot].item = item;
+    index->count++;
+}
+
+static void index_delete(cJSON * const node)
+{
+    if ((node->index != NULL) && !node->index->in_arena)
     {
-        return NULL;
+        global_hooks.deallocate(node->index);
     }
+    node->index = NULL;
+}
 
-    v1_len = strlen(valuestring);
-    v2_len = strlen(object->valuestring);
+/* (Re)build the index of an array or object, from the arena if there is one. Objects with unnamed children
+ * (added with cJSON_AddItemToArray) keep the linear search, which stops at them. */
+static cJSON_bool index_build(cJSON * const node, cJSON_Arena * const arena, const internal_hooks * const hooks)
+{
+    struct cJSON_Index *index = NULL;
+    cJSON *child = NULL;
+    cJSON_bool object = ((node->type & 0xFF) == cJSON_Object);
+    size_t count = 0;
+    size_t capacity = 1;
+    size_t size = 0;
 
-    if (v1_len <= v2_len)
+    index_delete(node);
+
+    for (child = node->child; child != NULL; child = child->next)
     {
-        /* strcpy does not handle overlapping string: [X1, X2] [Y1, Y2] => X2 < Y1 or Y2 < X1 */
-        if (!( valuestring + v1_len < object->valuestring || object->valuestring + v2_len < valuestring ))
+        if (object && (child->string == NULL))
         {
-            return NULL;
+            return false;
         }
-        strcpy(object->valuestring, valuestring);
-        return object->valuestring;
+        count++;
     }
-    copy = (char*) cJSON_strdup((const unsigned char*)valuestring, &global_hooks);
-    if (copy == NULL)
+    if (object)
     {
-        return NULL;
+        while (capacity < (2 * count))
+        {
+            capacity *= 2;
+        }
+        size = capacity * sizeof(object_index_entry);
     }
-    if (object->valuestring != NULL)
+    else
     {
-        cJSON_free(object->valuestring);
+        /* room to append a third more before the next rebuild */
+        capacity = count + (count / 2) + 1;
+        size = capacity * sizeof(cJSON*);
     }
-    object->valuestring = copy;
 
-    return copy;
+    size += sizeof(struct cJSON_Index);
+    index = (struct cJSON_Index*)((arena != NULL) ? arena_allocate(arena, size) : hooks->allocate(size));
+    if (index == NULL)
+    {
+        return false;
+    }
+    index->count = 0;
+    index->capacity = capacity;
+    index->in_arena = (arena != NULL);
+    index->stale = false;
+    index->entries = NULL;
+    index->items = NULL;
+
+    if (object)
+    {
+        index->entries = (object_index_entry*)(index + 1);
+        memset(index->entries, '\0', capacity * sizeof(object_index_entry));
+        for (child = node->child; child != NULL; child = child->next)
+        {
+            object_index_put(index, child, object_key_hash((const unsigned char*)child->string));
+        }
+    }
+    else
+    {
+        index->items = (cJSON**)(index + 1);
+        for (child = node->child; child != NULL; child = child->next)
+        {
+            index->items[index->count++] = child;
+        }
+    }
+    node->index = index;
+
+    return true;
 }
 
-typedef struct
+/* give an array or object without index one once it has CJSON_INDEX_THRESHOLD children */
+static void index_consider(cJSON * const node, cJSON_Arena * const arena, const internal_hooks * const hooks)
 {
-    unsigned char *buffer;
-    size_t length;
-    size_t offset;
-    size_t depth; /* current nesting depth (for formatted printing) */
-    cJSON_bool noalloc;
-    cJSON_bool format; /* is this print a formatted print */
-    internal_hooks hooks;
-} printbuffer;
+    size_t count = 0;
+    cJSON *child = NULL;
 
-/* realloc printbuffer if necessary to have at least "needed" bytes more */
-static unsigned char* ensure(printbuffer * const p, size_t needed)
+    if ((node->index != NULL) || (((node->type & 0xFF) != cJSON_Object) && ((node->type & 0xFF) != cJSON_Array)))
+    {
+        return;
+    }
+    for (child = node->child; (child != NULL) && (count < CJSON_INDEX_THRESHOLD); child = child->next)
+    {
+        count++;
+    }
+    if (count == CJSON_INDEX_THRESHOLD)
+    {
+        index_build(node, arena, hooks);
+    }
+}
+
+/* refill the items of an array after changes in the middle. Only mutators call it:
+ * lookups take a const array and may run concurrently on a shared tree */
+static void array_index_refresh(cJSON * const array)
 {
-    unsigned char *newbuffer = NULL;
-    size_t newsize = 0;
+    struct cJSON_Index *index = array->index;
+    cJSON *child = NULL;
+    size_t count = 0;
 
-    if ((p == NULL) || (p->buffer == NULL))
+    for (child = array->child; child != NULL; child = child->next)
     {
-        return NULL;
+        if (count == index->capacity)
+        {
+            /* it has grown, or fall back to walking the list if that fails */
+            index_build(array, NULL, &global_hooks);
+            return;
+        }
+        index->items[count++] = child;
     }
+    index->count = count;
+    index->stale = false;
+}
 
-    if ((p->length > 0) && (p->offset >= p->length))
+/* bring a stale array index back in line once the list change is done */
+static void index_sync(cJSON * const node)
+{
+    if ((node->index != NULL) && (node->index->items != NULL) && node->index->stale)
     {
-        /* make sure that offset is valid */
-        return NULL;
+        array_index_refresh(node);
     }
+}
 
-    if (needed > INT_MAX)
+/* item was just linked into node */
+static void index_add(cJSON * const node, cJSON * const item)
+{
+    struct cJSON_Index *index = node->index;
+
+    if (index == NULL)
     {
-        /* sizes bigger than INT_MAX are currently not supported */
-        return NULL;
+        index_consider(node, NULL, &global_hooks);
+        return;
     }
 
-    needed += p->offset + 1;
-    if (needed <= p->length)
+    if (index->items != NULL)
     {
-        return p->buffer + p->offset;
+        if (index->stale || (item->next != NULL))
+        {
+            /* inserted in the middle, or replacing an item */
+            array_index_refresh(node);
+        }
+        else if (index->count < index->capacity)
+        {
+            index->items[index->count++] = item;
+        }
+        else
+        {
+            index_build(node, NULL, &global_hooks);
+        }
+        return;
+    }
+
+    if (item->string == NULL)
+    {
+        index_delete(node);
+        return;
+    }
+    if ((2 * (index->count + 1)) > index->capacity)
+    {
+        /* grow, or fall back to the linear search if that fails */
+        index_build(node, NULL, &global_hooks);
+        return;
+    }
+    object_index_put(index, item, object_key_hash((const unsigned char*)item->string));
+}
+
+/* item is about to be unlinked from node */
+static void index_remove(cJSON * const node, const cJSON * const item)
+{
+    struct cJSON_Index *index = node->index;
+    size_t mask = 0;
+    size_t slot = 0;
+    size_t next = 0;
+
+    if (index == NULL)
+    {
+        return;
+    }
+
+    if (index->items != NULL)
+    {
+        /* only taking the last one keeps the items in order */
+        if (index->stale || (index->count == 0) || (index->items[index->count - 1] != item))
+        {
+            index->stale = true;
+        }
+        if (index->count > 0)
+        {
+            index->count--;
+        }
+        return;
+    }
+
+    if (item->string == NULL)
+    {
+        return;
+    }
+    mask = index->capacity - 1;
+    slot = object_key_hash((const unsigned char*)item->string) & mask;
+    while ((index->entries[slot].item != NULL) && (index->entries[slot].item != item))
+    {
+        slot = (slot + 1) & mask;
+    }
+    if (index->entries[slot].item == NULL)
+    {
+        return;
+    }
+
+    /* shift the following entries of the run back, so that no probe sequence is cut short */
+    next = slot;
+    for (;;)
+    {
+        size_t home = 0;
+        next = (next + 1) & mask;
+        if (index->entries[next].item == NULL)
+        {
+            break;
+        }
+        home = index->entries[next].hash & mask;
+        /* the entry can move into the hole unless its home slot lies cyclically in (slot, next] */
+        if (((next > slot) && ((home <= slot) || (home > next))) || ((next < slot) && ((home <= slot) && (home > next))))
+        {
+            index->entries[slot] = index->entries[next];
+            slot = next;
+        }
+    }
+    index->entries[slot].item = NULL;
+    index->count--;
+}
+
+/* Key pool for cJSON_ParseWithKeyPool: every distinct key is stored once in an arena of its own and found
+ * again through an open addressing table, which doubles whenever it gets half full. */
+typedef struct
+{
+    uint32_t hash;
+    size_t length;
+    char *key;
+} key_pool_entry;
+
+struct cJSON_KeyPool
+{
+    cJSON_Arena *strings;
+    size_t count;
+    size_t capacity; /* a power of two */
+    key_pool_entry *entries;
+};
+
+#define key_pool_initial_capacity 64
+#define key_pool_block_size 4096
+
+CJSON_PUBLIC(cJSON_KeyPool *) cJSON_CreateKeyPool(void)
+{
+    cJSON_KeyPool *pool = (cJSON_KeyPool*)global_hooks.allocate(sizeof(cJSON_KeyPool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    pool->strings = cJSON_CreateArena(key_pool_block_size);
+    pool->entries = (key_pool_entry*)global_hooks.allocate(key_pool_initial_capacity * sizeof(key_pool_entry));
+    if ((pool->strings == NULL) || (pool->entries == NULL))
+    {
+        cJSON_DeleteArena(pool->strings);
+        if (pool->entries != NULL)
+        {
+            global_hooks.deallocate(pool->entries);
+        }
+        global_hooks.deallocate(pool);
+        return NULL;
+    }
+    memset(pool->entries, '\0', key_pool_initial_capacity * sizeof(key_pool_entry));
+    pool->count = 0;
+    pool->capacity = key_pool_initial_capacity;
+
+    return pool;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteKeyPool(cJSON_KeyPool *pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    cJSON_DeleteArena(pool->strings);
+    global_hooks.deallocate(pool->entries);
+    global_hooks.deallocate(pool);
+}
+
+/* FNV-1a over the exact bytes, keys that only differ in case are different keys here */
+static uint32_t key_pool_hash(const unsigned char * const key, const size_t length)
+{
+    uint32_t hash = 2166136261U;
+    size_t position = 0;
+
+    for (position = 0; position < length; position++)
+    {
+        hash = (hash ^ key[position]) * 16777619U;
+    }
+
+    return hash;
+}
+
+static cJSON_bool key_pool_grow(cJSON_KeyPool * const pool)
+{
+    key_pool_entry *entries = NULL;
+    size_t capacity = pool->capacity * 2;
+    size_t mask = capacity - 1;
+    size_t position = 0;
+
+    if (capacity > ((size_t)-1 / sizeof(key_pool_entry)))
+    {
+        return false;
+    }
+    entries = (key_pool_entry*)global_hooks.allocate(capacity * sizeof(key_pool_entry));
+    if (entries == NULL)
+    {
+        return false;
+    }
+    memset(entries, '\0', capacity * sizeof(key_pool_entry));
+
+    for (position = 0; position < pool->capacity; position++)
+    {
+        size_t slot = 0;
+        if (pool->entries[position].key == NULL)
+        {
+            continue;
+        }
+        slot = pool->entries[position].hash & mask;
+        while (entries[slot].key != NULL)
+        {
+            slot = (slot + 1) & mask;
+        }
+        entries[slot] = pool->entries[position];
+    }
+
+    global_hooks.deallocate(pool->entries);
+    pool->entries = entries;
+    pool->capacity = capacity;
+
+    return true;
+}
+
+/* the pooled copy of key, which has length bytes and no terminator */
+static char *key_pool_intern(cJSON_KeyPool * const pool, const unsigned char * const key, const size_t length)
+{
+    uint32_t hash = key_pool_hash(key, length);
+    size_t mask = pool->capacity - 1;
+    size_t slot = hash & mask;
+    char *copy = NULL;
+
+    for (; pool->entries[slot].key != NULL; slot = (slot + 1) & mask)
+    {
+        if ((pool->entries[slot].hash == hash) && (pool->entries[slot].length == length) && (memcmp(pool->entries[slot].key, key, length) == 0))
+        {
+            return pool->entries[slot].key;
+        }
+    }
+
+    if ((pool->count + 1) > (pool->capacity / 2))
+    {
+        if (!key_pool_grow(pool))
+        {
+            return NULL;
+        }
+        mask = pool->capacity - 1;
+        slot = hash & mask;
+        while (pool->entries[slot].key != NULL)
+        {
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    copy = (char*)arena_allocate(pool->strings, length + sizeof(""));
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    memcpy(copy, key, length);
+    copy[length] = '\0';
+
+    pool->entries[slot].hash = hash;
+    pool->entries[slot].length = length;
+    pool->entries[slot].key = copy;
+    pool->count++;
+
+    return copy;
+}
+
+typedef struct
+{
+    const unsigned char *content;
+    size_t length;
+    size_t offset;
+    size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
+    internal_hooks hooks;
+    cJSON_Arena *arena; /* if not NULL, nodes and strings are taken from here instead of hooks */
+    cJSON_KeyPool *keys; /* if not NULL, object keys are interned here */
+} parse_buffer;
+
+static void *parse_allocate(parse_buffer * const buffer, size_t size)
+{
+    if (buffer->arena != NULL)
+    {
+        return arena_allocate(buffer->arena, size);
+    }
+
+    return buffer->hooks.allocate(size);
+}
+
+static cJSON *parse_new_item(parse_buffer * const buffer)
+{
+    cJSON *node = NULL;
+
+    if (buffer->arena == NULL)
+    {
+        return cJSON_New_Item(&buffer->hooks);
+    }
+
+    node = (cJSON*)arena_allocate(buffer->arena, sizeof(cJSON));
+    if (node != NULL)
+    {
+        memset(node, '\0', sizeof(cJSON));
+    }
+
+    return node;
+}
+
+/* arena memory is released all at once, so a failed parse only frees what came from hooks */
+static void parse_deallocate(parse_buffer * const buffer, void *pointer)
+{
+    if (buffer->arena == NULL)
+    {
+        buffer->hooks.deallocate(pointer);
+    }
+}
+
+static void parse_delete(parse_buffer * const buffer, cJSON *item)
+{
+    if (buffer->arena == NULL)
+    {
+        cJSON_Delete(item);
+    }
+}
+
+/* check if the given size is left to read in a given parse buffer (starting with 1) */
+#define can_read(buffer, size) ((buffer != NULL) && (((buffer)->offset + size) <= (buffer)->length))
+/* check if the buffer can be accessed at the given index (starting with 0) */
+#define can_access_at_index(buffer, index) ((buffer != NULL) && (((buffer)->offset + index) < (buffer)->length))
+#define cannot_access_at_index(buffer, index) (!can_access_at_index(buffer, index))
+/* get a pointer to the buffer at the position */
+#define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
+
+#ifdef CJSON_SIMD_X86
+#define SIMD_SSE2 1
+#define SIMD_AVX2 2
+
+/* best instruction set of this CPU; detecting it more than once in a race is harmless */
+static int simd_level(void)
+{
+    static int level = -1;
+
+    if (level < 0)
+    {
+        __builtin_cpu_init();
+        level = __builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_SSE2;
+    }
+
+    return level;
+}
+
+/* bytes up to and including space count as whitespace, as in the scalar loop: max(c, 32) == 32 */
+static size_t skip_whitespace_sse2(const unsigned char * const input, const size_t length)
+{
+    const __m128i space = _mm_set1_epi8(32);
+    size_t skipped = 0;
+
+    for (; (skipped + 16) <= length; skipped += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)(input + skipped));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, space), space));
+        if (mask != 0xFFFF)
+        {
+            return skipped + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    while ((skipped < length) && (input[skipped] <= 32))
+    {
+        skipped++;
+    }
+
+    return skipped;
+}
+
+__attribute__((target("avx2")))
+static size_t skip_whitespace_avx2(const unsigned char * const input, const size_t length)
+{
+    const __m256i space = _mm256_set1_epi8(32);
+    size_t skipped = 0;
+
+    for (; (skipped + 32) <= length; skipped += 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)(const void*)(input + skipped));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(chunk, space), space));
+        if (mask != 0xFFFFFFFFU)
+        {
+            return skipped + (size_t)__builtin_ctz(~mask);
+        }
+    }
+
+    /* no call into the SSE2 kernel for the tail: legacy SSE code after dirty upper halves pays a transition penalty */
+    while ((skipped < length) && (input[skipped] <= 32))
+    {
+        skipped++;
+    }
+
+    return skipped;
+}
+
+/* the quote or backslash that ends a clean run of string content */
+static size_t find_string_special_sse2(const unsigned char * const input, const size_t length)
+{
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    size_t offset = 0;
+
+    for (; (offset + 16) <= length; offset += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)(input + offset));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+        if (mask != 0)
+        {
+            return offset + (size_t)__builtin_ctz(mask);
+        }
+    }
+    while ((offset < length) && (input[offset] != '\"') && (input[offset] != '\\'))
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+__attribute__((target("avx2")))
+static size_t find_string_special_avx2(const unsigned char * const input, const size_t length)
+{
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    size_t offset = 0;
+
+    for (; (offset + 32) <= length; offset += 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)(const void*)(input + offset));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)));
+        if (mask != 0)
+        {
+            return offset + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    while ((offset < length) && (input[offset] != '\"') && (input[offset] != '\\'))
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+/* bytes that print_string_ptr has to escape: '"', '\\' and control characters (max(c, 31) == 31) */
+static size_t find_escape_sse2(const unsigned char * const input, const size_t length)
+{
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(31);
+    size_t offset = 0;
+
+    for (; (offset + 16) <= length; offset += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(const void*)(input + offset));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(special, _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control)));
+        if (mask != 0)
+        {
+            return offset + (size_t)__builtin_ctz(mask);
+        }
+    }
+    while ((offset < length) && (input[offset] > 31) && (input[offset] != '\"') && (input[offset] != '\\'))
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+__attribute__((target("avx2")))
+static size_t find_escape_avx2(const unsigned char * const input, const size_t length)
+{
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(31);
+    size_t offset = 0;
+
+    for (; (offset + 32) <= length; offset += 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)(const void*)(input + offset));
+        __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(special, _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control)));
+        if (mask != 0)
+        {
+            return offset + (size_t)__builtin_ctz(mask);
+        }
+    }
+
+    while ((offset < length) && (input[offset] > 31) && (input[offset] != '\"') && (input[offset] != '\\'))
+    {
+        offset++;
+    }
+
+    return offset;
+}
+#endif
+
+/* offset of the first '"' or '\\' in input, length if there is none */
+static size_t find_string_special(const unsigned char * const input, const size_t length)
+{
+    size_t offset = 0;
+
+#ifdef CJSON_SIMD_X86
+    if (length >= 16)
+    {
+        if (simd_level() == SIMD_AVX2)
+        {
+            return find_string_special_avx2(input, length);
+        }
+        return find_string_special_sse2(input, length);
+    }
+#endif
+    while ((offset < length) && (input[offset] != '\"') && (input[offset] != '\\'))
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+/* offset of the first byte in input that needs an escape when printed, length if there is none */
+static size_t find_escape(const unsigned char * const input, const size_t length)
+{
+    size_t offset = 0;
+
+#ifdef CJSON_SIMD_X86
+    if (length >= 16)
+    {
+        if (simd_level() == SIMD_AVX2)
+        {
+            return find_escape_avx2(input, length);
+        }
+        return find_escape_sse2(input, length);
+    }
+#endif
+    while ((offset < length) && (input[offset] > 31) && (input[offset] != '\"') && (input[offset] != '\\'))
+    {
+        offset++;
+    }
+
+    return offset;
+}
+
+/* Number parsing without strtod: locale independent, allocation free and correctly rounded.
+ * Up to 19 significant digits are gathered into a 64-bit mantissa w with value w * 10^q,
+ * then the first of these that applies produces the double:
+ * - Clinger's fast path: w and 10^|q| are both exact doubles, so one multiplication or division rounds correctly,
+ * - the Eisel-Lemire algorithm: a 128-bit product with a table of powers of five, which decides almost every other case,
+ * - a big decimal (up to 800 digits) that is shifted by powers of two, for the rare cases Eisel-Lemire cannot decide. */
+
+typedef struct
+{
+    uint64_t high;
+    uint64_t low;
+} number_uint128;
+
+static number_uint128 number_multiply(const uint64_t a, const uint64_t b)
+{
+    number_uint128 product;
+#ifdef __SIZEOF_INT128__
+    __extension__ unsigned __int128 full = (unsigned __int128)a * b;
+    product.high = (uint64_t)(full >> 64);
+    product.low = (uint64_t)full;
+#else
+    uint64_t a_low = a & 0xFFFFFFFFU;
+    uint64_t a_high = a >> 32;
+    uint64_t b_low = b & 0xFFFFFFFFU;
+    uint64_t b_high = b >> 32;
+    uint64_t low_low = a_low * b_low;
+    uint64_t high_low = a_high * b_low;
+    uint64_t low_high = a_low * b_high;
+    uint64_t middle = high_low + (low_low >> 32) + (low_high & 0xFFFFFFFFU);
+    product.high = (a_high * b_high) + (middle >> 32) + (low_high >> 32);
+    product.low = (middle << 32) | (low_low & 0xFFFFFFFFU);
+#endif
+    return product;
+}
+
+static int number_leading_zeros(uint64_t value)
+{
+#ifdef __GNUC__
+    return __builtin_clzll(value);
+#else
+    int zeros = 0;
+    while ((value & (UINT64_C(1) << 63)) == 0)
+    {
+        value <<= 1;
+        zeros++;
+    }
+    return zeros;
+#endif
+}
+
+static double number_from_bits(const uint64_t bits)
+{
+    double number = 0;
+    memcpy(&number, &bits, sizeof(number));
+    return number;
+}
+
+#define number_mantissa_bits 52
+#define number_infinite_power 0x7FF
+
+/* 128-bit approximations of 5^q for q in [-342, 324], normalized so that the top bit is set (high word first).
+ * Negative powers are rounded up, positive ones truncated, as the Eisel-Lemire algorithm expects.
+ * Parsing stops at 10^308 (anything larger is infinite), the powers above it are for print_number. */
+#define number_smallest_power_of_ten (-342)
+#define number_largest_power_of_ten 308
+#define number_largest_power_of_five 324
+static const uint64_t number_powers_of_five[2 * (number_largest_power_of_five - number_smallest_power_of_ten + 1)] =
+{
+    UINT64_C(0xeef453d6923bd65a), UINT64_C(0x113faa2906a13b3f),
+    UINT64_C(0x9558b4661b6565f8), UINT64_C(0x4ac7ca59a424c507),
+    UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x5d79bcf00d2df649),
+    UINT64_C(0xe95a99df8ace6f53), UINT64_C(0xf4d82c2c107973dc),
+    UINT64_C(0x91d8a02bb6c10594), UINT64_C(0x79071b9b8a4be869),
+    UINT64_C(0xb64ec836a47146f9), UINT64_C(0x9748e2826cdee284),
+    UINT64_C(0xe3e27a444d8d98b7), UINT64_C(0xfd1b1b2308169b25),
+    UINT64_C(0x8e6d8c6ab0787f72), UINT64_C(0xfe30f0f5e50e20f7),
+    UINT64_C(0xb208ef855c969f4f), UINT64_C(0xbdbd2d335e51a935),
+    UINT64_C(0xde8b2b66b3bc4723), UINT64_C(0xad2c788035e61382),
+    UINT64_C(0x8b16fb203055ac76), UINT64_C(0x4c3bcb5021afcc31),
+    UINT64_C(0xaddcb9e83c6b1793), UINT64_C(0xdf4abe242a1bbf3d),
+    UINT64_C(0xd953e8624b85dd78), UINT64_C(0xd71d6dad34a2af0d),
+    UINT64_C(0x87d4713d6f33aa6b), UINT64_C(0x8672648c40e5ad68),
+    UINT64_C(0xa9c98d8ccb009506), UINT64_C(0x680efdaf511f18c2),
+    UINT64_C(0xd43bf0effdc0ba48), UINT64_C(0x0212bd1b2566def2),
+    UINT64_C(0x84a57695fe98746d), UINT64_C(0x014bb630f7604b57),
+    UINT64_C(0xa5ced43b7e3e9188), UINT64_C(0x419ea3bd35385e2d),
+    UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x52064cac828675b9),
+    UINT64_C(0x818995ce7aa0e1b2), UINT64_C(0x7343efebd1940993),
+    UINT64_C(0xa1ebfb4219491a1f), UINT64_C(0x1014ebe6c5f90bf8),
+    UINT64_C(0xca66fa129f9b60a6), UINT64_C(0xd41a26e077774ef6),
+    UINT64_C(0xfd00b897478238d0), UINT64_C(0x8920b098955522b4),
+    UINT64_C(0x9e20735e8cb16382), UINT64_C(0x55b46e5f5d5535b0),
+    UINT64_C(0xc5a890362fddbc62), UINT64_C(0xeb2189f734aa831d),
+    UINT64_C(0xf712b443bbd52b7b), UINT64_C(0xa5e9ec7501d523e4),
+    UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0x47b233c92125366e),
+    UINT64_C(0xc1069cd4eabe89f8), UINT64_C(0x999ec0bb696e840a),
+    UINT64_C(0xf148440a256e2c76), UINT64_C(0xc00670ea43ca250d),
+    UINT64_C(0x96cd2a865764dbca), UINT64_C(0x380406926a5e5728),
+    UINT64_C(0xbc807527ed3e12bc), UINT64_C(0xc605083704f5ecf2),
+    UINT64_C(0xeba09271e88d976b), UINT64_C(0xf7864a44c633682e),
+    UINT64_C(0x93445b8731587ea3), UINT64_C(0x7ab3ee6afbe0211d),
+    UINT64_C(0xb8157268fdae9e4c), UINT64_C(0x5960ea05bad82964),
+    UINT64_C(0xe61acf033d1a45df), UINT64_C(0x6fb92487298e33bd),
+    UINT64_C(0x8fd0c16206306bab), UINT64_C(0xa5d3b6d479f8e056),
+    UINT64_C(0xb3c4f1ba87bc8696), UINT64_C(0x8f48a4899877186c),
+    UINT64_C(0xe0b62e2929aba83c), UINT64_C(0x331acdabfe94de87),
+    UINT64_C(0x8c71dcd9ba0b4925), UINT64_C(0x9ff0c08b7f1d0b14),
+    UINT64_C(0xaf8e5410288e1b6f), UINT64_C(0x07ecf0ae5ee44dd9),
+    UINT64_C(0xdb71e91432b1a24a), UINT64_C(0xc9e82cd9f69d6150),
+    UINT64_C(0x892731ac9faf056e), UINT64_C(0xbe311c083a225cd2),
+    UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0x6dbd630a48aaf406),
+    UINT64_C(0xd64d3d9db981787d), UINT64_C(0x092cbbccdad5b108),
+    UINT64_C(0x85f0468293f0eb4e), UINT64_C(0x25bbf56008c58ea5),
+    UINT64_C(0xa76c582338ed2621), UINT64_C(0xaf2af2b80af6f24e),
+    UINT64_C(0xd1476e2c07286faa), UINT64_C(0x1af5af660db4aee1),
+    UINT64_C(0x82cca4db847945ca), UINT64_C(0x50d98d9fc890ed4d),
+    UINT64_C(0xa37fce126597973c), UINT64_C(0xe50ff107bab528a0),
+    UINT64_C(0xcc5fc196fefd7d0c), UINT64_C(0x1e53ed49a96272c8),
+    UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0x25e8e89c13bb0f7a),
+    UINT64_C(0x9faacf3df73609b1), UINT64_C(0x77b191618c54e9ac),
+    UINT64_C(0xc795830d75038c1d), UINT64_C(0xd59df5b9ef6a2417),
+    UINT64_C(0xf97ae3d0d2446f25), UINT64_C(0x4b0573286b44ad1d),
+    UINT64_C(0x9becce62836ac577), UINT64_C(0x4ee367f9430aec32),
+    UINT64_C(0xc2e801fb244576d5), UINT64_C(0x229c41f793cda73f),
+    UINT64_C(0xf3a20279ed56d48a), UINT64_C(0x6b43527578c1110f),
+    UINT64_C(0x9845418c345644d6), UINT64_C(0x830a13896b78aaa9),
+    UINT64_C(0xbe5691ef416bd60c), UINT64_C(0x23cc986bc656d553),
+    UINT64_C(0xedec366b11c6cb8f), UINT64_C(0x2cbfbe86b7ec8aa8),
+    UINT64_C(0x94b3a202eb1c3f39), UINT64_C(0x7bf7d71432f3d6a9),
+    UINT64_C(0xb9e08a83a5e34f07), UINT64_C(0xdaf5ccd93fb0cc53),
+    UINT64_C(0xe858ad248f5c22c9), UINT64_C(0xd1b3400f8f9cff68),
+    UINT64_C(0x91376c36d99995be), UINT64_C(0x23100809b9c21fa1),
+    UINT64_C(0xb58547448ffffb2d), UINT64_C(0xabd40a0c2832a78a),
+    UINT64_C(0xe2e69915b3fff9f9), UINT64_C(0x16c90c8f323f516c),
+    UINT64_C(0x8dd01fad907ffc3b), UINT64_C(0xae3da7d97f6792e3),
+    UINT64_C(0xb1442798f49ffb4a), UINT64_C(0x99cd11cfdf41779c),
+    UINT64_C(0xdd95317f31c7fa1d), UINT64_C(0x40405643d711d583),
+    UINT64_C(0x8a7d3eef7f1cfc52), UINT64_C(0x482835ea666b2572),
+    UINT64_C(0xad1c8eab5ee43b66), UINT64_C(0xda3243650005eecf),
+    UINT64_C(0xd863b256369d4a40), UINT64_C(0x90bed43e40076a82),
+    UINT64_C(0x873e4f75e2224e68), UINT64_C(0x5a7744a6e804a291),
+    UINT64_C(0xa90de3535aaae202), UINT64_C(0x711515d0a205cb36),
+    UINT64_C(0xd3515c2831559a83), UINT64_C(0x0d5a5b44ca873e03),
+    UINT64_C(0x8412d9991ed58091), UINT64_C(0xe858790afe9486c2),
+    UINT64_C(0xa5178fff668ae0b6), UINT64_C(0x626e974dbe39a872),
+    UINT64_C(0xce5d73ff402d98e3), UINT64_C(0xfb0a3d212dc8128f),
+    UINT64_C(0x80fa687f881c7f8e), UINT64_C(0x7ce66634bc9d0b99),
+    UINT64_C(0xa139029f6a239f72), UINT64_C(0x1c1fffc1ebc44e80),
+    UINT64_C(0xc987434744ac874e), UINT64_C(0xa327ffb266b56220),
+    UINT64_C(0xfbe9141915d7a922), UINT64_C(0x4bf1ff9f0062baa8),
+    UINT64_C(0x9d71ac8fada6c9b5), UINT64_C(0x6f773fc3603db4a9),
+    UINT64_C(0xc4ce17b399107c22), UINT64_C(0xcb550fb4384d21d3),
+    UINT64_C(0xf6019da07f549b2b), UINT64_C(0x7e2a53a146606a48),
+    UINT64_C(0x99c102844f94e0fb), UINT64_C(0x2eda7444cbfc426d),
+    UINT64_C(0xc0314325637a1939), UINT64_C(0xfa911155fefb5308),
+    UINT64_C(0xf03d93eebc589f88), UINT64_C(0x793555ab7eba27ca),
+    UINT64_C(0x96267c7535b763b5), UINT64_C(0x4bc1558b2f3458de),
+    UINT64_C(0xbbb01b9283253ca2), UINT64_C(0x9eb1aaedfb016f16),
+    UINT64_C(0xea9c227723ee8bcb), UINT64_C(0x465e15a979c1cadc),
+    UINT64_C(0x92a1958a7675175f), UINT64_C(0x0bfacd89ec191ec9),
+    UINT64_C(0xb749faed14125d36), UINT64_C(0xcef980ec671f667b),
+    UINT64_C(0xe51c79a85916f484), UINT64_C(0x82b7e12780e7401a),
+    UINT64_C(0x8f31cc0937ae58d2), UINT64_C(0xd1b2ecb8b0908810),
+    UINT64_C(0xb2fe3f0b8599ef07), UINT64_C(0x861fa7e6dcb4aa15),
+    UINT64_C(0xdfbdcece67006ac9), UINT64_C(0x67a791e093e1d49a),
+    UINT64_C(0x8bd6a141006042bd), UINT64_C(0xe0c8bb2c5c6d24e0),
+    UINT64_C(0xaecc49914078536d), UINT64_C(0x58fae9f773886e18),
+    UINT64_C(0xda7f5bf590966848), UINT64_C(0xaf39a475506a899e),
+    UINT64_C(0x888f99797a5e012d), UINT64_C(0x6d8406c952429603),
+    UINT64_C(0xaab37fd7d8f58178), UINT64_C(0xc8e5087ba6d33b83),
+    UINT64_C(0xd5605fcdcf32e1d6), UINT64_C(0xfb1e4a9a90880a64),
+    UINT64_C(0x855c3be0a17fcd26), UINT64_C(0x5cf2eea09a55067f),
+    UINT64_C(0xa6b34ad8c9dfc06f), UINT64_C(0xf42faa48c0ea481e),
+    UINT64_C(0xd0601d8efc57b08b), UINT64_C(0xf13b94daf124da26),
+    UINT64_C(0x823c12795db6ce57), UINT64_C(0x76c53d08d6b70858),
+    UINT64_C(0xa2cb1717b52481ed), UINT64_C(0x54768c4b0c64ca6e),
+    UINT64_C(0xcb7ddcdda26da268), UINT64_C(0xa9942f5dcf7dfd09),
+    UINT64_C(0xfe5d54150b090b02), UINT64_C(0xd3f93b35435d7c4c),
+    UINT64_C(0x9efa548d26e5a6e1), UINT64_C(0xc47bc5014a1a6daf),
+    UINT64_C(0xc6b8e9b0709f109a), UINT64_C(0x359ab6419ca1091b),
+    UINT64_C(0xf867241c8cc6d4c0), UINT64_C(0xc30163d203c94b62),
+    UINT64_C(0x9b407691d7fc44f8), UINT64_C(0x79e0de63425dcf1d),
+    UINT64_C(0xc21094364dfb5636), UINT64_C(0x985915fc12f542e4),
+    UINT64_C(0xf294b943e17a2bc4), UINT64_C(0x3e6f5b7b17b2939d),
+    UINT64_C(0x979cf3ca6cec5b5a), UINT64_C(0xa705992ceecf9c42),
+    UINT64_C(0xbd8430bd08277231), UINT64_C(0x50c6ff782a838353),
+    UINT64_C(0xece53cec4a314ebd), UINT64_C(0xa4f8bf5635246428),
+    UINT64_C(0x940f4613ae5ed136), UINT64_C(0x871b7795e136be99),
+    UINT64_C(0xb913179899f68584), UINT64_C(0x28e2557b59846e3f),
+    UINT64_C(0xe757dd7ec07426e5), UINT64_C(0x331aeada2fe589cf),
+    UINT64_C(0x9096ea6f3848984f), UINT64_C(0x3ff0d2c85def7621),
+    UINT64_C(0xb4bca50b065abe63), UINT64_C(0x0fed077a756b53a9),
+    UINT64_C(0xe1ebce4dc7f16dfb), UINT64_C(0xd3e8495912c62894),
+    UINT64_C(0x8d3360f09cf6e4bd), UINT64_C(0x64712dd7abbbd95c),
+    UINT64_C(0xb080392cc4349dec), UINT64_C(0xbd8d794d96aacfb3),
+    UINT64_C(0xdca04777f541c567), UINT64_C(0xecf0d7a0fc5583a0),
+    UINT64_C(0x89e42caaf9491b60), UINT64_C(0xf41686c49db57244),
+    UINT64_C(0xac5d37d5b79b6239), UINT64_C(0x311c2875c522ced5),
+    UINT64_C(0xd77485cb25823ac7), UINT64_C(0x7d633293366b828b),
+    UINT64_C(0x86a8d39ef77164bc), UINT64_C(0xae5dff9c02033197),
+    UINT64_C(0xa8530886b54dbdeb), UINT64_C(0xd9f57f830283fdfc),
+    UINT64_C(0xd267caa862a12d66), UINT64_C(0xd072df63c324fd7b),
+    UINT64_C(0x8380dea93da4bc60), UINT64_C(0x4247cb9e59f71e6d),
+    UINT64_C(0xa46116538d0deb78), UINT64_C(0x52d9be85f074e608),
+    UINT64_C(0xcd795be870516656), UINT64_C(0x67902e276c921f8b),
+    UINT64_C(0x806bd9714632dff6), UINT64_C(0x00ba1cd8a3db53b6),
+    UINT64_C(0xa086cfcd97bf97f3), UINT64_C(0x80e8a40eccd228a4),
+    UINT64_C(0xc8a883c0fdaf7df0), UINT64_C(0x6122cd128006b2cd),
+    UINT64_C(0xfad2a4b13d1b5d6c), UINT64_C(0x796b805720085f81),
+    UINT64_C(0x9cc3a6eec6311a63), UINT64_C(0xcbe3303674053bb0),
+    UINT64_C(0xc3f490aa77bd60fc), UINT64_C(0xbedbfc4411068a9c),
+    UINT64_C(0xf4f1b4d515acb93b), UINT64_C(0xee92fb5515482d44),
+    UINT64_C(0x991711052d8bf3c5), UINT64_C(0x751bdd152d4d1c4a),
+    UINT64_C(0xbf5cd54678eef0b6), UINT64_C(0xd262d45a78a0635d),
+    UINT64_C(0xef340a98172aace4), UINT64_C(0x86fb897116c87c34),
+    UINT64_C(0x9580869f0e7aac0e), UINT64_C(0xd45d35e6ae3d4da0),
+    UINT64_C(0xbae0a846d2195712), UINT64_C(0x8974836059cca109),
+    UINT64_C(0xe998d258869facd7), UINT64_C(0x2bd1a438703fc94b),
+    UINT64_C(0x91ff83775423cc06), UINT64_C(0x7b6306a34627ddcf),
+    UINT64_C(0xb67f6455292cbf08), UINT64_C(0x1a3bc84c17b1d542),
+    UINT64_C(0xe41f3d6a7377eeca), UINT64_C(0x20caba5f1d9e4a93),
+    UINT64_C(0x8e938662882af53e), UINT64_C(0x547eb47b7282ee9c),
+    UINT64_C(0xb23867fb2a35b28d), UINT64_C(0xe99e619a4f23aa43),
+    UINT64_C(0xdec681f9f4c31f31), UINT64_C(0x6405fa00e2ec94d4),
+    UINT64_C(0x8b3c113c38f9f37e), UINT64_C(0xde83bc408dd3dd04),
+    UINT64_C(0xae0b158b4738705e), UINT64_C(0x9624ab50b148d445),
+    UINT64_C(0xd98ddaee19068c76), UINT64_C(0x3badd624dd9b0957),
+    UINT64_C(0x87f8a8d4cfa417c9), UINT64_C(0xe54ca5d70a80e5d6),
+    UINT64_C(0xa9f6d30a038d1dbc), UINT64_C(0x5e9fcf4ccd211f4c),
+    UINT64_C(0xd47487cc8470652b), UINT64_C(0x7647c3200069671f),
+    UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0x29ecd9f40041e073),
+    UINT64_C(0xa5fb0a17c777cf09), UINT64_C(0xf468107100525890),
+    UINT64_C(0xcf79cc9db955c2cc), UINT64_C(0x7182148d4066eeb4),
+    UINT64_C(0x81ac1fe293d599bf), UINT64_C(0xc6f14cd848405530),
+    UINT64_C(0xa21727db38cb002f), UINT64_C(0xb8ada00e5a506a7c),
+    UINT64_C(0xca9cf1d206fdc03b), UINT64_C(0xa6d90811f0e4851c),
+    UINT64_C(0xfd442e4688bd304a), UINT64_C(0x908f4a166d1da663),
+    UINT64_C(0x9e4a9cec15763e2e), UINT64_C(0x9a598e4e043287fe),
+    UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x40eff1e1853f29fd),
+    UINT64_C(0xf7549530e188c128), UINT64_C(0xd12bee59e68ef47c),
+    UINT64_C(0x9a94dd3e8cf578b9), UINT64_C(0x82bb74f8301958ce),
+    UINT64_C(0xc13a148e3032d6e7), UINT64_C(0xe36a52363c1faf01),
+    UINT64_C(0xf18899b1bc3f8ca1), UINT64_C(0xdc44e6c3cb279ac1),
+    UINT64_C(0x96f5600f15a7b7e5), UINT64_C(0x29ab103a5ef8c0b9),
+    UINT64_C(0xbcb2b812db11a5de), UINT64_C(0x7415d448f6b6f0e7),
+    UINT64_C(0xebdf661791d60f56), UINT64_C(0x111b495b3464ad21),
+    UINT64_C(0x936b9fcebb25c995), UINT64_C(0xcab10dd900beec34),
+    UINT64_C(0xb84687c269ef3bfb), UINT64_C(0x3d5d514f40eea742),
+    UINT64_C(0xe65829b3046b0afa), UINT64_C(0x0cb4a5a3112a5112),
+    UINT64_C(0x8ff71a0fe2c2e6dc), UINT64_C(0x47f0e785eaba72ab),
+    UINT64_C(0xb3f4e093db73a093), UINT64_C(0x59ed216765690f56),
+    UINT64_C(0xe0f218b8d25088b8), UINT64_C(0x306869c13ec3532c),
+    UINT64_C(0x8c974f7383725573), UINT64_C(0x1e414218c73a13fb),
+    UINT64_C(0xafbd2350644eeacf), UINT64_C(0xe5d1929ef90898fa),
+    UINT64_C(0xdbac6c247d62a583), UINT64_C(0xdf45f746b74abf39),
+    UINT64_C(0x894bc396ce5da772), UINT64_C(0x6b8bba8c328eb783),
+    UINT64_C(0xab9eb47c81f5114f), UINT64_C(0x066ea92f3f326564),
+    UINT64_C(0xd686619ba27255a2), UINT64_C(0xc80a537b0efefebd),
+    UINT64_C(0x8613fd0145877585), UINT64_C(0xbd06742ce95f5f36),
+    UINT64_C(0xa798fc4196e952e7), UINT64_C(0x2c48113823b73704),
+    UINT64_C(0xd17f3b51fca3a7a0), UINT64_C(0xf75a15862ca504c5),
+    UINT64_C(0x82ef85133de648c4), UINT64_C(0x9a984d73dbe722fb),
+    UINT64_C(0xa3ab66580d5fdaf5), UINT64_C(0xc13e60d0d2e0ebba),
+    UINT64_C(0xcc963fee10b7d1b3), UINT64_C(0x318df905079926a8),
+    UINT64_C(0xffbbcfe994e5c61f), UINT64_C(0xfdf17746497f7052),
+    UINT64_C(0x9fd561f1fd0f9bd3), UINT64_C(0xfeb6ea8bedefa633),
+    UINT64_C(0xc7caba6e7c5382c8), UINT64_C(0xfe64a52ee96b8fc0),
+    UINT64_C(0xf9bd690a1b68637b), UINT64_C(0x3dfdce7aa3c673b0),
+    UINT64_C(0x9c1661a651213e2d), UINT64_C(0x06bea10ca65c084e),
+    UINT64_C(0xc31bfa0fe5698db8), UINT64_C(0x486e494fcff30a62),
+    UINT64_C(0xf3e2f893dec3f126), UINT64_C(0x5a89dba3c3efccfa),
+    UINT64_C(0x986ddb5c6b3a76b7), UINT64_C(0xf89629465a75e01c),
+    UINT64_C(0xbe89523386091465), UINT64_C(0xf6bbb397f1135823),
+    UINT64_C(0xee2ba6c0678b597f), UINT64_C(0x746aa07ded582e2c),
+    UINT64_C(0x94db483840b717ef), UINT64_C(0xa8c2a44eb4571cdc),
+    UINT64_C(0xba121a4650e4ddeb), UINT64_C(0x92f34d62616ce413),
+    UINT64_C(0xe896a0d7e51e1566), UINT64_C(0x77b020baf9c81d17),
+    UINT64_C(0x915e2486ef32cd60), UINT64_C(0x0ace1474dc1d122e),
+    UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x0d819992132456ba),
+    UINT64_C(0xe3231912d5bf60e6), UINT64_C(0x10e1fff697ed6c69),
+    UINT64_C(0x8df5efabc5979c8f), UINT64_C(0xca8d3ffa1ef463c1),
+    UINT64_C(0xb1736b96b6fd83b3), UINT64_C(0xbd308ff8a6b17cb2),
+    UINT64_C(0xddd0467c64bce4a0), UINT64_C(0xac7cb3f6d05ddbde),
+    UINT64_C(0x8aa22c0dbef60ee4), UINT64_C(0x6bcdf07a423aa96b),
+    UINT64_C(0xad4ab7112eb3929d), UINT64_C(0x86c16c98d2c953c6),
+    UINT64_C(0xd89d64d57a607744), UINT64_C(0xe871c7bf077ba8b7),
+    UINT64_C(0x87625f056c7c4a8b), UINT64_C(0x11471cd764ad4972),
+    UINT64_C(0xa93af6c6c79b5d2d), UINT64_C(0xd598e40d3dd89bcf),
+    UINT64_C(0xd389b47879823479), UINT64_C(0x4aff1d108d4ec2c3),
+    UINT64_C(0x843610cb4bf160cb), UINT64_C(0xcedf722a585139ba),
+    UINT64_C(0xa54394fe1eedb8fe), UINT64_C(0xc2974eb4ee658828),
+    UINT64_C(0xce947a3da6a9273e), UINT64_C(0x733d226229feea32),
+    UINT64_C(0x811ccc668829b887), UINT64_C(0x0806357d5a3f525f),
+    UINT64_C(0xa163ff802a3426a8), UINT64_C(0xca07c2dcb0cf26f7),
+    UINT64_C(0xc9bcff6034c13052), UINT64_C(0xfc89b393dd02f0b5),
+    UINT64_C(0xfc2c3f3841f17c67), UINT64_C(0xbbac2078d443ace2),
+    UINT64_C(0x9d9ba7832936edc0), UINT64_C(0xd54b944b84aa4c0d),
+    UINT64_C(0xc5029163f384a931), UINT64_C(0x0a9e795e65d4df11),
+    UINT64_C(0xf64335bcf065d37d), UINT64_C(0x4d4617b5ff4a16d5),
+    UINT64_C(0x99ea0196163fa42e), UINT64_C(0x504bced1bf8e4e45),
+    UINT64_C(0xc06481fb9bcf8d39), UINT64_C(0xe45ec2862f71e1d6),
+    UINT64_C(0xf07da27a82c37088), UINT64_C(0x5d767327bb4e5a4c),
+    UINT64_C(0x964e858c91ba2655), UINT64_C(0x3a6a07f8d510f86f),
+    UINT64_C(0xbbe226efb628afea), UINT64_C(0x890489f70a55368b),
+    UINT64_C(0xeadab0aba3b2dbe5), UINT64_C(0x2b45ac74ccea842e),
+    UINT64_C(0x92c8ae6b464fc96f), UINT64_C(0x3b0b8bc90012929d),
+    UINT64_C(0xb77ada0617e3bbcb), UINT64_C(0x09ce6ebb40173744),
+    UINT64_C(0xe55990879ddcaabd), UINT64_C(0xcc420a6a101d0515),
+    UINT64_C(0x8f57fa54c2a9eab6), UINT64_C(0x9fa946824a12232d),
+    UINT64_C(0xb32df8e9f3546564), UINT64_C(0x47939822dc96abf9),
+    UINT64_C(0xdff9772470297ebd), UINT64_C(0x59787e2b93bc56f7),
+    UINT64_C(0x8bfbea76c619ef36), UINT64_C(0x57eb4edb3c55b65a),
+    UINT64_C(0xaefae51477a06b03), UINT64_C(0xede622920b6b23f1),
+    UINT64_C(0xdab99e59958885c4), UINT64_C(0xe95fab368e45eced),
+    UINT64_C(0x88b402f7fd75539b), UINT64_C(0x11dbcb0218ebb414),
+    UINT64_C(0xaae103b5fcd2a881), UINT64_C(0xd652bdc29f26a119),
+    UINT64_C(0xd59944a37c0752a2), UINT64_C(0x4be76d3346f0495f),
+    UINT64_C(0x857fcae62d8493a5), UINT64_C(0x6f70a4400c562ddb),
+    UINT64_C(0xa6dfbd9fb8e5b88e), UINT64_C(0xcb4ccd500f6bb952),
+    UINT64_C(0xd097ad07a71f26b2), UINT64_C(0x7e2000a41346a7a7),
+    UINT64_C(0x825ecc24c873782f), UINT64_C(0x8ed400668c0c28c8),
+    UINT64_C(0xa2f67f2dfa90563b), UINT64_C(0x728900802f0f32fa),
+    UINT64_C(0xcbb41ef979346bca), UINT64_C(0x4f2b40a03ad2ffb9),
+    UINT64_C(0xfea126b7d78186bc), UINT64_C(0xe2f610c84987bfa8),
+    UINT64_C(0x9f24b832e6b0f436), UINT64_C(0x0dd9ca7d2df4d7c9),
+    UINT64_C(0xc6ede63fa05d3143), UINT64_C(0x91503d1c79720dbb),
+    UINT64_C(0xf8a95fcf88747d94), UINT64_C(0x75a44c6397ce912a),
+    UINT64_C(0x9b69dbe1b548ce7c), UINT64_C(0xc986afbe3ee11aba),
+    UINT64_C(0xc24452da229b021b), UINT64_C(0xfbe85badce996168),
+    UINT64_C(0xf2d56790ab41c2a2), UINT64_C(0xfae27299423fb9c3),
+    UINT64_C(0x97c560ba6b0919a5), UINT64_C(0xdccd879fc967d41a),
+    UINT64_C(0xbdb6b8e905cb600f), UINT64_C(0x5400e987bbc1c920),
+    UINT64_C(0xed246723473e3813), UINT64_C(0x290123e9aab23b68),
+    UINT64_C(0x9436c0760c86e30b), UINT64_C(0xf9a0b6720aaf6521),
+    UINT64_C(0xb94470938fa89bce), UINT64_C(0xf808e40e8d5b3e69),
+    UINT64_C(0xe7958cb87392c2c2), UINT64_C(0xb60b1d1230b20e04),
+    UINT64_C(0x90bd77f3483bb9b9), UINT64_C(0xb1c6f22b5e6f48c2),
+    UINT64_C(0xb4ecd5f01a4aa828), UINT64_C(0x1e38aeb6360b1af3),
+    UINT64_C(0xe2280b6c20dd5232), UINT64_C(0x25c6da63c38de1b0),
+    UINT64_C(0x8d590723948a535f), UINT64_C(0x579c487e5a38ad0e),
+    UINT64_C(0xb0af48ec79ace837), UINT64_C(0x2d835a9df0c6d851),
+    UINT64_C(0xdcdb1b2798182244), UINT64_C(0xf8e431456cf88e65),
+    UINT64_C(0x8a08f0f8bf0f156b), UINT64_C(0x1b8e9ecb641b58ff),
+    UINT64_C(0xac8b2d36eed2dac5), UINT64_C(0xe272467e3d222f3f),
+    UINT64_C(0xd7adf884aa879177), UINT64_C(0x5b0ed81dcc6abb0f),
+    UINT64_C(0x86ccbb52ea94baea), UINT64_C(0x98e947129fc2b4e9),
+    UINT64_C(0xa87fea27a539e9a5), UINT64_C(0x3f2398d747b36224),
+    UINT64_C(0xd29fe4b18e88640e), UINT64_C(0x8eec7f0d19a03aad),
+    UINT64_C(0x83a3eeeef9153e89), UINT64_C(0x1953cf68300424ac),
+    UINT64_C(0xa48ceaaab75a8e2b), UINT64_C(0x5fa8c3423c052dd7),
+    UINT64_C(0xcdb02555653131b6), UINT64_C(0x3792f412cb06794d),
+    UINT64_C(0x808e17555f3ebf11), UINT64_C(0xe2bbd88bbee40bd0),
+    UINT64_C(0xa0b19d2ab70e6ed6), UINT64_C(0x5b6aceaeae9d0ec4),
+    UINT64_C(0xc8de047564d20a8b), UINT64_C(0xf245825a5a445275),
+    UINT64_C(0xfb158592be068d2e), UINT64_C(0xeed6e2f0f0d56712),
+    UINT64_C(0x9ced737bb6c4183d), UINT64_C(0x55464dd69685606b),
+    UINT64_C(0xc428d05aa4751e4c), UINT64_C(0xaa97e14c3c26b886),
+    UINT64_C(0xf53304714d9265df), UINT64_C(0xd53dd99f4b3066a8),
+    UINT64_C(0x993fe2c6d07b7fab), UINT64_C(0xe546a8038efe4029),
+    UINT64_C(0xbf8fdb78849a5f96), UINT64_C(0xde98520472bdd033),
+    UINT64_C(0xef73d256a5c0f77c), UINT64_C(0x963e66858f6d4440),
+    UINT64_C(0x95a8637627989aad), UINT64_C(0xdde7001379a44aa8),
+    UINT64_C(0xbb127c53b17ec159), UINT64_C(0x5560c018580d5d52),
+    UINT64_C(0xe9d71b689dde71af), UINT64_C(0xaab8f01e6e10b4a6),
+    UINT64_C(0x9226712162ab070d), UINT64_C(0xcab3961304ca70e8),
+    UINT64_C(0xb6b00d69bb55c8d1), UINT64_C(0x3d607b97c5fd0d22),
+    UINT64_C(0xe45c10c42a2b3b05), UINT64_C(0x8cb89a7db77c506a),
+    UINT64_C(0x8eb98a7a9a5b04e3), UINT64_C(0x77f3608e92adb242),
+    UINT64_C(0xb267ed1940f1c61c), UINT64_C(0x55f038b237591ed3),
+    UINT64_C(0xdf01e85f912e37a3), UINT64_C(0x6b6c46dec52f6688),
+    UINT64_C(0x8b61313bbabce2c6), UINT64_C(0x2323ac4b3b3da015),
+    UINT64_C(0xae397d8aa96c1b77), UINT64_C(0xabec975e0a0d081a),
+    UINT64_C(0xd9c7dced53c72255), UINT64_C(0x96e7bd358c904a21),
+    UINT64_C(0x881cea14545c7575), UINT64_C(0x7e50d64177da2e54),
+    UINT64_C(0xaa242499697392d2), UINT64_C(0xdde50bd1d5d0b9e9),
+    UINT64_C(0xd4ad2dbfc3d07787), UINT64_C(0x955e4ec64b44e864),
+    UINT64_C(0x84ec3c97da624ab4), UINT64_C(0xbd5af13bef0b113e),
+    UINT64_C(0xa6274bbdd0fadd61), UINT64_C(0xecb1ad8aeacdd58e),
+    UINT64_C(0xcfb11ead453994ba), UINT64_C(0x67de18eda5814af2),
+    UINT64_C(0x81ceb32c4b43fcf4), UINT64_C(0x80eacf948770ced7),
+    UINT64_C(0xa2425ff75e14fc31), UINT64_C(0xa1258379a94d028d),
+    UINT64_C(0xcad2f7f5359a3b3e), UINT64_C(0x096ee45813a04330),
+    UINT64_C(0xfd87b5f28300ca0d), UINT64_C(0x8bca9d6e188853fc),
+    UINT64_C(0x9e74d1b791e07e48), UINT64_C(0x775ea264cf55347e),
+    UINT64_C(0xc612062576589dda), UINT64_C(0x95364afe032a819e),
+    UINT64_C(0xf79687aed3eec551), UINT64_C(0x3a83ddbd83f52205),
+    UINT64_C(0x9abe14cd44753b52), UINT64_C(0xc4926a9672793543),
+    UINT64_C(0xc16d9a0095928a27), UINT64_C(0x75b7053c0f178294),
+    UINT64_C(0xf1c90080baf72cb1), UINT64_C(0x5324c68b12dd6339),
+    UINT64_C(0x971da05074da7bee), UINT64_C(0xd3f6fc16ebca5e04),
+    UINT64_C(0xbce5086492111aea), UINT64_C(0x88f4bb1ca6bcf585),
+    UINT64_C(0xec1e4a7db69561a5), UINT64_C(0x2b31e9e3d06c32e6),
+    UINT64_C(0x9392ee8e921d5d07), UINT64_C(0x3aff322e62439fd0),
+    UINT64_C(0xb877aa3236a4b449), UINT64_C(0x09befeb9fad487c3),
+    UINT64_C(0xe69594bec44de15b), UINT64_C(0x4c2ebe687989a9b4),
+    UINT64_C(0x901d7cf73ab0acd9), UINT64_C(0x0f9d37014bf60a11),
+    UINT64_C(0xb424dc35095cd80f), UINT64_C(0x538484c19ef38c95),
+    UINT64_C(0xe12e13424bb40e13), UINT64_C(0x2865a5f206b06fba),
+    UINT64_C(0x8cbccc096f5088cb), UINT64_C(0xf93f87b7442e45d4),
+    UINT64_C(0xafebff0bcb24aafe), UINT64_C(0xf78f69a51539d749),
+    UINT64_C(0xdbe6fecebdedd5be), UINT64_C(0xb573440e5a884d1c),
+    UINT64_C(0x89705f4136b4a597), UINT64_C(0x31680a88f8953031),
+    UINT64_C(0xabcc77118461cefc), UINT64_C(0xfdc20d2b36ba7c3e),
+    UINT64_C(0xd6bf94d5e57a42bc), UINT64_C(0x3d32907604691b4d),
+    UINT64_C(0x8637bd05af6c69b5), UINT64_C(0xa63f9a49c2c1b110),
+    UINT64_C(0xa7c5ac471b478423), UINT64_C(0x0fcf80dc33721d54),
+    UINT64_C(0xd1b71758e219652b), UINT64_C(0xd3c36113404ea4a9),
+    UINT64_C(0x83126e978d4fdf3b), UINT64_C(0x645a1cac083126ea),
+    UINT64_C(0xa3d70a3d70a3d70a), UINT64_C(0x3d70a3d70a3d70a4),
+    UINT64_C(0xcccccccccccccccc), UINT64_C(0xcccccccccccccccd),
+    UINT64_C(0x8000000000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xa000000000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xc800000000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xfa00000000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0x9c40000000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xc350000000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xf424000000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0x9896800000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xbebc200000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xee6b280000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0x9502f90000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xba43b74000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xe8d4a51000000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0x9184e72a00000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xb5e620f480000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xe35fa931a0000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0x8e1bc9bf04000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xb1a2bc2ec5000000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xde0b6b3a76400000), UINT64_C(0x0000000000000000),
+    UINT64_C(0x8ac7230489e80000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xad78ebc5ac620000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xd8d726b7177a8000), UINT64_C(0x0000000000000000),
+    UINT64_C(0x878678326eac9000), UINT64_C(0x0000000000000000),
+    UINT64_C(0xa968163f0a57b400), UINT64_C(0x0000000000000000),
+    UINT64_C(0xd3c21bcecceda100), UINT64_C(0x0000000000000000),
+    UINT64_C(0x84595161401484a0), UINT64_C(0x0000000000000000),
+    UINT64_C(0xa56fa5b99019a5c8), UINT64_C(0x0000000000000000),
+    UINT64_C(0xcecb8f27f4200f3a), UINT64_C(0x0000000000000000),
+    UINT64_C(0x813f3978f8940984), UINT64_C(0x4000000000000000),
+    UINT64_C(0xa18f07d736b90be5), UINT64_C(0x5000000000000000),
+    UINT64_C(0xc9f2c9cd04674ede), UINT64_C(0xa400000000000000),
+    UINT64_C(0xfc6f7c4045812296), UINT64_C(0x4d00000000000000),
+    UINT64_C(0x9dc5ada82b70b59d), UINT64_C(0xf020000000000000),
+    UINT64_C(0xc5371912364ce305), UINT64_C(0x6c28000000000000),
+    UINT64_C(0xf684df56c3e01bc6), UINT64_C(0xc732000000000000),
+    UINT64_C(0x9a130b963a6c115c), UINT64_C(0x3c7f400000000000),
+    UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x4b9f100000000000),
+    UINT64_C(0xf0bdc21abb48db20), UINT64_C(0x1e86d40000000000),
+    UINT64_C(0x96769950b50d88f4), UINT64_C(0x1314448000000000),
+    UINT64_C(0xbc143fa4e250eb31), UINT64_C(0x17d955a000000000),
+    UINT64_C(0xeb194f8e1ae525fd), UINT64_C(0x5dcfab0800000000),
+    UINT64_C(0x92efd1b8d0cf37be), UINT64_C(0x5aa1cae500000000),
+    UINT64_C(0xb7abc627050305ad), UINT64_C(0xf14a3d9e40000000),
+    UINT64_C(0xe596b7b0c643c719), UINT64_C(0x6d9ccd05d0000000),
+    UINT64_C(0x8f7e32ce7bea5c6f), UINT64_C(0xe4820023a2000000),
+    UINT64_C(0xb35dbf821ae4f38b), UINT64_C(0xdda2802c8a800000),
+    UINT64_C(0xe0352f62a19e306e), UINT64_C(0xd50b2037ad200000),
+    UINT64_C(0x8c213d9da502de45), UINT64_C(0x4526f422cc340000),
+    UINT64_C(0xaf298d050e4395d6), UINT64_C(0x9670b12b7f410000),
+    UINT64_C(0xdaf3f04651d47b4c), UINT64_C(0x3c0cdd765f114000),
+    UINT64_C(0x88d8762bf324cd0f), UINT64_C(0xa5880a69fb6ac800),
+    UINT64_C(0xab0e93b6efee0053), UINT64_C(0x8eea0d047a457a00),
+    UINT64_C(0xd5d238a4abe98068), UINT64_C(0x72a4904598d6d880),
+    UINT64_C(0x85a36366eb71f041), UINT64_C(0x47a6da2b7f864750),
+    UINT64_C(0xa70c3c40a64e6c51), UINT64_C(0x999090b65f67d924),
+    UINT64_C(0xd0cf4b50cfe20765), UINT64_C(0xfff4b4e3f741cf6d),
+    UINT64_C(0x82818f1281ed449f), UINT64_C(0xbff8f10e7a8921a4),
+    UINT64_C(0xa321f2d7226895c7), UINT64_C(0xaff72d52192b6a0d),
+    UINT64_C(0xcbea6f8ceb02bb39), UINT64_C(0x9bf4f8a69f764490),
+    UINT64_C(0xfee50b7025c36a08), UINT64_C(0x02f236d04753d5b4),
+    UINT64_C(0x9f4f2726179a2245), UINT64_C(0x01d762422c946590),
+    UINT64_C(0xc722f0ef9d80aad6), UINT64_C(0x424d3ad2b7b97ef5),
+    UINT64_C(0xf8ebad2b84e0d58b), UINT64_C(0xd2e0898765a7deb2),
+    UINT64_C(0x9b934c3b330c8577), UINT64_C(0x63cc55f49f88eb2f),
+    UINT64_C(0xc2781f49ffcfa6d5), UINT64_C(0x3cbf6b71c76b25fb),
+    UINT64_C(0xf316271c7fc3908a), UINT64_C(0x8bef464e3945ef7a),
+    UINT64_C(0x97edd871cfda3a56), UINT64_C(0x97758bf0e3cbb5ac),
+    UINT64_C(0xbde94e8e43d0c8ec), UINT64_C(0x3d52eeed1cbea317),
+    UINT64_C(0xed63a231d4c4fb27), UINT64_C(0x4ca7aaa863ee4bdd),
+    UINT64_C(0x945e455f24fb1cf8), UINT64_C(0x8fe8caa93e74ef6a),
+    UINT64_C(0xb975d6b6ee39e436), UINT64_C(0xb3e2fd538e122b44),
+    UINT64_C(0xe7d34c64a9c85d44), UINT64_C(0x60dbbca87196b616),
+    UINT64_C(0x90e40fbeea1d3a4a), UINT64_C(0xbc8955e946fe31cd),
+    UINT64_C(0xb51d13aea4a488dd), UINT64_C(0x6babab6398bdbe41),
+    UINT64_C(0xe264589a4dcdab14), UINT64_C(0xc696963c7eed2dd1),
+    UINT64_C(0x8d7eb76070a08aec), UINT64_C(0xfc1e1de5cf543ca2),
+    UINT64_C(0xb0de65388cc8ada8), UINT64_C(0x3b25a55f43294bcb),
+    UINT64_C(0xdd15fe86affad912), UINT64_C(0x49ef0eb713f39ebe),
+    UINT64_C(0x8a2dbf142dfcc7ab), UINT64_C(0x6e3569326c784337),
+    UINT64_C(0xacb92ed9397bf996), UINT64_C(0x49c2c37f07965404),
+    UINT64_C(0xd7e77a8f87daf7fb), UINT64_C(0xdc33745ec97be906),
+    UINT64_C(0x86f0ac99b4e8dafd), UINT64_C(0x69a028bb3ded71a3),
+    UINT64_C(0xa8acd7c0222311bc), UINT64_C(0xc40832ea0d68ce0c),
+    UINT64_C(0xd2d80db02aabd62b), UINT64_C(0xf50a3fa490c30190),
+    UINT64_C(0x83c7088e1aab65db), UINT64_C(0x792667c6da79e0fa),
+    UINT64_C(0xa4b8cab1a1563f52), UINT64_C(0x577001b891185938),
+    UINT64_C(0xcde6fd5e09abcf26), UINT64_C(0xed4c0226b55e6f86),
+    UINT64_C(0x80b05e5ac60b6178), UINT64_C(0x544f8158315b05b4),
+    UINT64_C(0xa0dc75f1778e39d6), UINT64_C(0x696361ae3db1c721),
+    UINT64_C(0xc913936dd571c84c), UINT64_C(0x03bc3a19cd1e38e9),
+    UINT64_C(0xfb5878494ace3a5f), UINT64_C(0x04ab48a04065c723),
+    UINT64_C(0x9d174b2dcec0e47b), UINT64_C(0x62eb0d64283f9c76),
+    UINT64_C(0xc45d1df942711d9a), UINT64_C(0x3ba5d0bd324f8394),
+    UINT64_C(0xf5746577930d6500), UINT64_C(0xca8f44ec7ee36479),
+    UINT64_C(0x9968bf6abbe85f20), UINT64_C(0x7e998b13cf4e1ecb),
+    UINT64_C(0xbfc2ef456ae276e8), UINT64_C(0x9e3fedd8c321a67e),
+    UINT64_C(0xefb3ab16c59b14a2), UINT64_C(0xc5cfe94ef3ea101e),
+    UINT64_C(0x95d04aee3b80ece5), UINT64_C(0xbba1f1d158724a12),
+    UINT64_C(0xbb445da9ca61281f), UINT64_C(0x2a8a6e45ae8edc97),
+    UINT64_C(0xea1575143cf97226), UINT64_C(0xf52d09d71a3293bd),
+    UINT64_C(0x924d692ca61be758), UINT64_C(0x593c2626705f9c56),
+    UINT64_C(0xb6e0c377cfa2e12e), UINT64_C(0x6f8b2fb00c77836c),
+    UINT64_C(0xe498f455c38b997a), UINT64_C(0x0b6dfb9c0f956447),
+    UINT64_C(0x8edf98b59a373fec), UINT64_C(0x4724bd4189bd5eac),
+    UINT64_C(0xb2977ee300c50fe7), UINT64_C(0x58edec91ec2cb657),
+    UINT64_C(0xdf3d5e9bc0f653e1), UINT64_C(0x2f2967b66737e3ed),
+    UINT64_C(0x8b865b215899f46c), UINT64_C(0xbd79e0d20082ee74),
+    UINT64_C(0xae67f1e9aec07187), UINT64_C(0xecd8590680a3aa11),
+    UINT64_C(0xda01ee641a708de9), UINT64_C(0xe80e6f4820cc9495),
+    UINT64_C(0x884134fe908658b2), UINT64_C(0x3109058d147fdcdd),
+    UINT64_C(0xaa51823e34a7eede), UINT64_C(0xbd4b46f0599fd415),
+    UINT64_C(0xd4e5e2cdc1d1ea96), UINT64_C(0x6c9e18ac7007c91a),
+    UINT64_C(0x850fadc09923329e), UINT64_C(0x03e2cf6bc604ddb0),
+    UINT64_C(0xa6539930bf6bff45), UINT64_C(0x84db8346b786151c),
+    UINT64_C(0xcfe87f7cef46ff16), UINT64_C(0xe612641865679a63),
+    UINT64_C(0x81f14fae158c5f6e), UINT64_C(0x4fcb7e8f3f60c07e),
+    UINT64_C(0xa26da3999aef7749), UINT64_C(0xe3be5e330f38f09d),
+    UINT64_C(0xcb090c8001ab551c), UINT64_C(0x5cadf5bfd3072cc5),
+    UINT64_C(0xfdcb4fa002162a63), UINT64_C(0x73d9732fc7c8f7f6),
+    UINT64_C(0x9e9f11c4014dda7e), UINT64_C(0x2867e7fddcdd9afa),
+    UINT64_C(0xc646d63501a1511d), UINT64_C(0xb281e1fd541501b8),
+    UINT64_C(0xf7d88bc24209a565), UINT64_C(0x1f225a7ca91a4226),
+    UINT64_C(0x9ae757596946075f), UINT64_C(0x3375788de9b06958),
+    UINT64_C(0xc1a12d2fc3978937), UINT64_C(0x0052d6b1641c83ae),
+    UINT64_C(0xf209787bb47d6b84), UINT64_C(0xc0678c5dbd23a49a),
+    UINT64_C(0x9745eb4d50ce6332), UINT64_C(0xf840b7ba963646e0),
+    UINT64_C(0xbd176620a501fbff), UINT64_C(0xb650e5a93bc3d898),
+    UINT64_C(0xec5d3fa8ce427aff), UINT64_C(0xa3e51f138ab4cebe),
+    UINT64_C(0x93ba47c980e98cdf), UINT64_C(0xc66f336c36b10137),
+    UINT64_C(0xb8a8d9bbe123f017), UINT64_C(0xb80b0047445d4184),
+    UINT64_C(0xe6d3102ad96cec1d), UINT64_C(0xa60dc059157491e5),
+    UINT64_C(0x9043ea1ac7e41392), UINT64_C(0x87c89837ad68db2f),
+    UINT64_C(0xb454e4a179dd1877), UINT64_C(0x29babe4598c311fb),
+    UINT64_C(0xe16a1dc9d8545e94), UINT64_C(0xf4296dd6fef3d67a),
+    UINT64_C(0x8ce2529e2734bb1d), UINT64_C(0x1899e4a65f58660c),
+    UINT64_C(0xb01ae745b101e9e4), UINT64_C(0x5ec05dcff72e7f8f),
+    UINT64_C(0xdc21a1171d42645d), UINT64_C(0x76707543f4fa1f73),
+    UINT64_C(0x899504ae72497eba), UINT64_C(0x6a06494a791c53a8),
+    UINT64_C(0xabfa45da0edbde69), UINT64_C(0x0487db9d17636892),
+    UINT64_C(0xd6f8d7509292d603), UINT64_C(0x45a9d2845d3c42b6),
+    UINT64_C(0x865b86925b9bc5c2), UINT64_C(0x0b8a2392ba45a9b2),
+    UINT64_C(0xa7f26836f282b732), UINT64_C(0x8e6cac7768d7141e),
+    UINT64_C(0xd1ef0244af2364ff), UINT64_C(0x3207d795430cd926),
+    UINT64_C(0x8335616aed761f1f), UINT64_C(0x7f44e6bd49e807b8),
+    UINT64_C(0xa402b9c5a8d3a6e7), UINT64_C(0x5f16206c9c6209a6),
+    UINT64_C(0xcd036837130890a1), UINT64_C(0x36dba887c37a8c0f),
+    UINT64_C(0x802221226be55a64), UINT64_C(0xc2494954da2c9789),
+    UINT64_C(0xa02aa96b06deb0fd), UINT64_C(0xf2db9baa10b7bd6c),
+    UINT64_C(0xc83553c5c8965d3d), UINT64_C(0x6f92829494e5acc7),
+    UINT64_C(0xfa42a8b73abbf48c), UINT64_C(0xcb772339ba1f17f9),
+    UINT64_C(0x9c69a97284b578d7), UINT64_C(0xff2a760414536efb),
+    UINT64_C(0xc38413cf25e2d70d), UINT64_C(0xfef5138519684aba),
+    UINT64_C(0xf46518c2ef5b8cd1), UINT64_C(0x7eb258665fc25d69),
+    UINT64_C(0x98bf2f79d5993802), UINT64_C(0xef2f773ffbd97a61),
+    UINT64_C(0xbeeefb584aff8603), UINT64_C(0xaafb550ffacfd8fa),
+    UINT64_C(0xeeaaba2e5dbf6784), UINT64_C(0x95ba2a53f983cf38),
+    UINT64_C(0x952ab45cfa97a0b2), UINT64_C(0xdd945a747bf26183),
+    UINT64_C(0xba756174393d88df), UINT64_C(0x94f971119aeef9e4),
+    UINT64_C(0xe912b9d1478ceb17), UINT64_C(0x7a37cd5601aab85d),
+    UINT64_C(0x91abb422ccb812ee), UINT64_C(0xac62e055c10ab33a),
+    UINT64_C(0xb616a12b7fe617aa), UINT64_C(0x577b986b314d6009),
+    UINT64_C(0xe39c49765fdf9d94), UINT64_C(0xed5a7e85fda0b80b),
+    UINT64_C(0x8e41ade9fbebc27d), UINT64_C(0x14588f13be847307),
+    UINT64_C(0xb1d219647ae6b31c), UINT64_C(0x596eb2d8ae258fc8),
+    UINT64_C(0xde469fbd99a05fe3), UINT64_C(0x6fca5f8ed9aef3bb),
+    UINT64_C(0x8aec23d680043bee), UINT64_C(0x25de7bb9480d5854),
+    UINT64_C(0xada72ccc20054ae9), UINT64_C(0xaf561aa79a10ae6a),
+    UINT64_C(0xd910f7ff28069da4), UINT64_C(0x1b2ba1518094da04),
+    UINT64_C(0x87aa9aff79042286), UINT64_C(0x90fb44d2f05d0842),
+    UINT64_C(0xa99541bf57452b28), UINT64_C(0x353a1607ac744a53),
+    UINT64_C(0xd3fa922f2d1675f2), UINT64_C(0x42889b8997915ce8),
+    UINT64_C(0x847c9b5d7c2e09b7), UINT64_C(0x69956135febada11),
+    UINT64_C(0xa59bc234db398c25), UINT64_C(0x43fab9837e699095),
+    UINT64_C(0xcf02b2c21207ef2e), UINT64_C(0x94f967e45e03f4bb),
+    UINT64_C(0x8161afb94b44f57d), UINT64_C(0x1d1be0eebac278f5),
+    UINT64_C(0xa1ba1ba79e1632dc), UINT64_C(0x6462d92a69731732),
+    UINT64_C(0xca28a291859bbf93), UINT64_C(0x7d7b8f7503cfdcfe),
+    UINT64_C(0xfcb2cb35e702af78), UINT64_C(0x5cda735244c3d43e),
+    UINT64_C(0x9defbf01b061adab), UINT64_C(0x3a0888136afa64a7),
+    UINT64_C(0xc56baec21c7a1916), UINT64_C(0x088aaa1845b8fdd0),
+    UINT64_C(0xf6c69a72a3989f5b), UINT64_C(0x8aad549e57273d45),
+    UINT64_C(0x9a3c2087a63f6399), UINT64_C(0x36ac54e2f678864b),
+    UINT64_C(0xc0cb28a98fcf3c7f), UINT64_C(0x84576a1bb416a7dd),
+    UINT64_C(0xf0fdf2d3f3c30b9f), UINT64_C(0x656d44a2a11c51d5),
+    UINT64_C(0x969eb7c47859e743), UINT64_C(0x9f644ae5a4b1b325),
+    UINT64_C(0xbc4665b596706114), UINT64_C(0x873d5d9f0dde1fee),
+    UINT64_C(0xeb57ff22fc0c7959), UINT64_C(0xa90cb506d155a7ea),
+    UINT64_C(0x9316ff75dd87cbd8), UINT64_C(0x09a7f12442d588f2),
+    UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x0c11ed6d538aeb2f),
+    UINT64_C(0xe5d3ef282a242e81), UINT64_C(0x8f1668c8a86da5fa),
+    UINT64_C(0x8fa475791a569d10), UINT64_C(0xf96e017d694487bc),
+    UINT64_C(0xb38d92d760ec4455), UINT64_C(0x37c981dcc395a9ac),
+    UINT64_C(0xe070f78d3927556a), UINT64_C(0x85bbe253f47b1417),
+    UINT64_C(0x8c469ab843b89562), UINT64_C(0x93956d7478ccec8e),
+    UINT64_C(0xaf58416654a6babb), UINT64_C(0x387ac8d1970027b2),
+    UINT64_C(0xdb2e51bfe9d0696a), UINT64_C(0x06997b05fcc0319e),
+    UINT64_C(0x88fcf317f22241e2), UINT64_C(0x441fece3bdf81f03),
+    UINT64_C(0xab3c2fddeeaad25a), UINT64_C(0xd527e81cad7626c3),
+    UINT64_C(0xd60b3bd56a5586f1), UINT64_C(0x8a71e223d8d3b074),
+    UINT64_C(0x85c7056562757456), UINT64_C(0xf6872d5667844e49),
+    UINT64_C(0xa738c6bebb12d16c), UINT64_C(0xb428f8ac016561db),
+    UINT64_C(0xd106f86e69d785c7), UINT64_C(0xe13336d701beba52),
+    UINT64_C(0x82a45b450226b39c), UINT64_C(0xecc0024661173473),
+    UINT64_C(0xa34d721642b06084), UINT64_C(0x27f002d7f95d0190),
+    UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x31ec038df7b441f4),
+    UINT64_C(0xff290242c83396ce), UINT64_C(0x7e67047175a15271),
+    UINT64_C(0x9f79a169bd203e41), UINT64_C(0x0f0062c6e984d386),
+    UINT64_C(0xc75809c42c684dd1), UINT64_C(0x52c07b78a3e60868),
+    UINT64_C(0xf92e0c3537826145), UINT64_C(0xa7709a56ccdf8a82),
+    UINT64_C(0x9bbcc7a142b17ccb), UINT64_C(0x88a66076400bb691),
+    UINT64_C(0xc2abf989935ddbfe), UINT64_C(0x6acff893d00ea435),
+    UINT64_C(0xf356f7ebf83552fe), UINT64_C(0x0583f6b8c4124d43),
+    UINT64_C(0x98165af37b2153de), UINT64_C(0xc3727a337a8b704a),
+    UINT64_C(0xbe1bf1b059e9a8d6), UINT64_C(0x744f18c0592e4c5c),
+    UINT64_C(0xeda2ee1c7064130c), UINT64_C(0x1162def06f79df73),
+    UINT64_C(0x9485d4d1c63e8be7), UINT64_C(0x8addcb5645ac2ba8),
+    UINT64_C(0xb9a74a0637ce2ee1), UINT64_C(0x6d953e2bd7173692),
+    UINT64_C(0xe8111c87c5c1ba99), UINT64_C(0xc8fa8db6ccdd0437),
+    UINT64_C(0x910ab1d4db9914a0), UINT64_C(0x1d9c9892400a22a2),
+    UINT64_C(0xb54d5e4a127f59c8), UINT64_C(0x2503beb6d00cab4b),
+    UINT64_C(0xe2a0b5dc971f303a), UINT64_C(0x2e44ae64840fd61d),
+    UINT64_C(0x8da471a9de737e24), UINT64_C(0x5ceaecfed289e5d2),
+    UINT64_C(0xb10d8e1456105dad), UINT64_C(0x7425a83e872c5f47),
+    UINT64_C(0xdd50f1996b947518), UINT64_C(0xd12f124e28f77719),
+    UINT64_C(0x8a5296ffe33cc92f), UINT64_C(0x82bd6b70d99aaa6f),
+    UINT64_C(0xace73cbfdc0bfb7b), UINT64_C(0x636cc64d1001550b),
+    UINT64_C(0xd8210befd30efa5a), UINT64_C(0x3c47f7e05401aa4e),
+    UINT64_C(0x8714a775e3e95c78), UINT64_C(0x65acfaec34810a71),
+    UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0x7f1839a741a14d0d),
+    UINT64_C(0xd31045a8341ca07c), UINT64_C(0x1ede48111209a050),
+    UINT64_C(0x83ea2b892091e44d), UINT64_C(0x934aed0aab460432),
+    UINT64_C(0xa4e4b66b68b65d60), UINT64_C(0xf81da84d5617853f),
+    UINT64_C(0xce1de40642e3f4b9), UINT64_C(0x36251260ab9d668e),
+    UINT64_C(0x80d2ae83e9ce78f3), UINT64_C(0xc1d72b7c6b426019),
+    UINT64_C(0xa1075a24e4421730), UINT64_C(0xb24cf65b8612f81f),
+    UINT64_C(0xc94930ae1d529cfc), UINT64_C(0xdee033f26797b627),
+    UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0x169840ef017da3b1),
+    UINT64_C(0x9d412e0806e88aa5), UINT64_C(0x8e1f289560ee864e),
+    UINT64_C(0xc491798a08a2ad4e), UINT64_C(0xf1a6f2bab92a27e2),
+    UINT64_C(0xf5b5d7ec8acb58a2), UINT64_C(0xae10af696774b1db),
+    UINT64_C(0x9991a6f3d6bf1765), UINT64_C(0xacca6da1e0a8ef29),
+    UINT64_C(0xbff610b0cc6edd3f), UINT64_C(0x17fd090a58d32af3),
+    UINT64_C(0xeff394dcff8a948e), UINT64_C(0xddfc4b4cef07f5b0),
+    UINT64_C(0x95f83d0a1fb69cd9), UINT64_C(0x4abdaf101564f98e),
+    UINT64_C(0xbb764c4ca7a4440f), UINT64_C(0x9d6d1ad41abe37f1),
+    UINT64_C(0xea53df5fd18d5513), UINT64_C(0x84c86189216dc5ed),
+    UINT64_C(0x92746b9be2f8552c), UINT64_C(0x32fd3cf5b4e49bb4),
+    UINT64_C(0xb7118682dbb66a77), UINT64_C(0x3fbc8c33221dc2a1),
+    UINT64_C(0xe4d5e82392a40515), UINT64_C(0x0fabaf3feaa5334a),
+    UINT64_C(0x8f05b1163ba6832d), UINT64_C(0x29cb4d87f2a7400e),
+    UINT64_C(0xb2c71d5bca9023f8), UINT64_C(0x743e20e9ef511012),
+    UINT64_C(0xdf78e4b2bd342cf6), UINT64_C(0x914da9246b255416),
+    UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0x1ad089b6c2f7548e),
+    UINT64_C(0xae9672aba3d0c320), UINT64_C(0xa184ac2473b529b1),
+    UINT64_C(0xda3c0f568cc4f3e8), UINT64_C(0xc9e5d72d90a2741e),
+    UINT64_C(0x8865899617fb1871), UINT64_C(0x7e2fa67c7a658892),
+    UINT64_C(0xaa7eebfb9df9de8d), UINT64_C(0xddbb901b98feeab7),
+    UINT64_C(0xd51ea6fa85785631), UINT64_C(0x552a74227f3ea565),
+    UINT64_C(0x8533285c936b35de), UINT64_C(0xd53a88958f87275f),
+    UINT64_C(0xa67ff273b8460356), UINT64_C(0x8a892abaf368f137),
+    UINT64_C(0xd01fef10a657842c), UINT64_C(0x2d2b7569b0432d85),
+    UINT64_C(0x8213f56a67f6b29b), UINT64_C(0x9c3b29620e29fc73),
+    UINT64_C(0xa298f2c501f45f42), UINT64_C(0x8349f3ba91b47b8f),
+    UINT64_C(0xcb3f2f7642717713), UINT64_C(0x241c70a936219a73),
+    UINT64_C(0xfe0efb53d30dd4d7), UINT64_C(0xed238cd383aa0110),
+    UINT64_C(0x9ec95d1463e8a506), UINT64_C(0xf4363804324a40aa),
+    UINT64_C(0xc67bb4597ce2ce48), UINT64_C(0xb143c6053edcd0d5),
+    UINT64_C(0xf81aa16fdc1b81da), UINT64_C(0xdd94b7868e94050a),
+    UINT64_C(0x9b10a4e5e9913128), UINT64_C(0xca7cf2b4191c8326),
+    UINT64_C(0xc1d4ce1f63f57d72), UINT64_C(0xfd1c2f611f63a3f0),
+    UINT64_C(0xf24a01a73cf2dccf), UINT64_C(0xbc633b39673c8cec),
+    UINT64_C(0x976e41088617ca01), UINT64_C(0xd5be0503e085d813),
+    UINT64_C(0xbd49d14aa79dbc82), UINT64_C(0x4b2d8644d8a74e18),
+    UINT64_C(0xec9c459d51852ba2), UINT64_C(0xddf8e7d60ed1219e),
+    UINT64_C(0x93e1ab8252f33b45), UINT64_C(0xcabb90e5c942b503),
+    UINT64_C(0xb8da1662e7b00a17), UINT64_C(0x3d6a751f3b936243),
+    UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0x0cc512670a783ad4),
+    UINT64_C(0x906a617d450187e2), UINT64_C(0x27fb2b80668b24c5),
+    UINT64_C(0xb484f9dc9641e9da), UINT64_C(0xb1f9f660802dedf6),
+    UINT64_C(0xe1a63853bbd26451), UINT64_C(0x5e7873f8a0396973),
+    UINT64_C(0x8d07e33455637eb2), UINT64_C(0xdb0b487b6423e1e8),
+    UINT64_C(0xb049dc016abc5e5f), UINT64_C(0x91ce1a9a3d2cda62),
+    UINT64_C(0xdc5c5301c56b75f7), UINT64_C(0x7641a140cc7810fb),
+    UINT64_C(0x89b9b3e11b6329ba), UINT64_C(0xa9e904c87fcb0a9d),
+    UINT64_C(0xac2820d9623bf429), UINT64_C(0x546345fa9fbdcd44),
+    UINT64_C(0xd732290fbacaf133), UINT64_C(0xa97c177947ad4095),
+    UINT64_C(0x867f59a9d4bed6c0), UINT64_C(0x49ed8eabcccc485d),
+    UINT64_C(0xa81f301449ee8c70), UINT64_C(0x5c68f256bfff5a74),
+    UINT64_C(0xd226fc195c6a2f8c), UINT64_C(0x73832eec6fff3111),
+    UINT64_C(0x83585d8fd9c25db7), UINT64_C(0xc831fd53c5ff7eab),
+    UINT64_C(0xa42e74f3d032f525), UINT64_C(0xba3e7ca8b77f5e55),
+    UINT64_C(0xcd3a1230c43fb26f), UINT64_C(0x28ce1bd2e55f35eb),
+    UINT64_C(0x80444b5e7aa7cf85), UINT64_C(0x7980d163cf5b81b3),
+    UINT64_C(0xa0555e361951c366), UINT64_C(0xd7e105bcc332621f),
+    UINT64_C(0xc86ab5c39fa63440), UINT64_C(0x8dd9472bf3fefaa7),
+    UINT64_C(0xfa856334878fc150), UINT64_C(0xb14f98f6f0feb951),
+    UINT64_C(0x9c935e00d4b9d8d2), UINT64_C(0x6ed1bf9a569f33d3),
+    UINT64_C(0xc3b8358109e84f07), UINT64_C(0x0a862f80ec4700c8),
+    UINT64_C(0xf4a642e14c6262c8), UINT64_C(0xcd27bb612758c0fa),
+    UINT64_C(0x98e7e9cccfbd7dbd), UINT64_C(0x8038d51cb897789c),
+    UINT64_C(0xbf21e44003acdd2c), UINT64_C(0xe0470a63e6bd56c3),
+    UINT64_C(0xeeea5d5004981478), UINT64_C(0x1858ccfce06cac74),
+    UINT64_C(0x95527a5202df0ccb), UINT64_C(0x0f37801e0c43ebc8),
+    UINT64_C(0xbaa718e68396cffd), UINT64_C(0xd30560258f54e6ba),
+    UINT64_C(0xe950df20247c83fd), UINT64_C(0x47c6b82ef32a2069),
+    UINT64_C(0x91d28b7416cdd27e), UINT64_C(0x4cdc331d57fa5441),
+    UINT64_C(0xb6472e511c81471d), UINT64_C(0xe0133fe4adf8e952),
+    UINT64_C(0xe3d8f9e563a198e5), UINT64_C(0x58180fddd97723a6),
+    UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0x570f09eaa7ea7648),
+    UINT64_C(0xb201833b35d63f73), UINT64_C(0x2cd2cc6551e513da),
+    UINT64_C(0xde81e40a034bcf4f), UINT64_C(0xf8077f7ea65e58d1),
+    UINT64_C(0x8b112e86420f6191), UINT64_C(0xfb04afaf27faf782),
+    UINT64_C(0xadd57a27d29339f6), UINT64_C(0x79c5db9af1f9b563),
+    UINT64_C(0xd94ad8b1c7380874), UINT64_C(0x18375281ae7822bc),
+    UINT64_C(0x87cec76f1c830548), UINT64_C(0x8f2293910d0b15b5),
+    UINT64_C(0xa9c2794ae3a3c69a), UINT64_C(0xb2eb3875504ddb22),
+    UINT64_C(0xd433179d9c8cb841), UINT64_C(0x5fa60692a46151eb),
+    UINT64_C(0x849feec281d7f328), UINT64_C(0xdbc7c41ba6bcd333),
+    UINT64_C(0xa5c7ea73224deff3), UINT64_C(0x12b9b522906c0800),
+    UINT64_C(0xcf39e50feae16bef), UINT64_C(0xd768226b34870a00),
+    UINT64_C(0x81842f29f2cce375), UINT64_C(0xe6a1158300d46640),
+    UINT64_C(0xa1e53af46f801c53), UINT64_C(0x60495ae3c1097fd0),
+    UINT64_C(0xca5e89b18b602368), UINT64_C(0x385bb19cb14bdfc4),
+    UINT64_C(0xfcf62c1dee382c42), UINT64_C(0x46729e03dd9ed7b5),
+    UINT64_C(0x9e19db92b4e31ba9), UINT64_C(0x6c07a2c26a8346d1)
+};
+
+/* digits added when shifting a decimal left by k bits, one less if its leading digits are below 5^k */
+static const struct
+{
+    int delta;
+    const char *cutoff;
+} decimal_left_shifts[61] =
+{
+    { 0, "" },
+    { 1, "5" },
+    { 1, "25" },
+    { 1, "125" },
+    { 2, "625" },
+    { 2, "3125" },
+    { 2, "15625" },
+    { 3, "78125" },
+    { 3, "390625" },
+    { 3, "1953125" },
+    { 4, "9765625" },
+    { 4, "48828125" },
+    { 4, "244140625" },
+    { 4, "1220703125" },
+    { 5, "6103515625" },
+    { 5, "30517578125" },
+    { 5, "152587890625" },
+    { 6, "762939453125" },
+    { 6, "3814697265625" },
+    { 6, "19073486328125" },
+    { 7, "95367431640625" },
+    { 7, "476837158203125" },
+    { 7, "2384185791015625" },
+    { 7, "11920928955078125" },
+    { 8, "59604644775390625" },
+    { 8, "298023223876953125" },
+    { 8, "1490116119384765625" },
+    { 9, "7450580596923828125" },
+    { 9, "37252902984619140625" },
+    { 9, "186264514923095703125" },
+    { 10, "931322574615478515625" },
+    { 10, "4656612873077392578125" },
+    { 10, "23283064365386962890625" },
+    { 10, "116415321826934814453125" },
+    { 11, "582076609134674072265625" },
+    { 11, "2910383045673370361328125" },
+    { 11, "14551915228366851806640625" },
+    { 12, "72759576141834259033203125" },
+    { 12, "363797880709171295166015625" },
+    { 12, "1818989403545856475830078125" },
+    { 13, "9094947017729282379150390625" },
+    { 13, "45474735088646411895751953125" },
+    { 13, "227373675443232059478759765625" },
+    { 13, "1136868377216160297393798828125" },
+    { 14, "5684341886080801486968994140625" },
+    { 14, "28421709430404007434844970703125" },
+    { 14, "142108547152020037174224853515625" },
+    { 15, "710542735760100185871124267578125" },
+    { 15, "3552713678800500929355621337890625" },
+    { 15, "17763568394002504646778106689453125" },
+    { 16, "88817841970012523233890533447265625" },
+    { 16, "444089209850062616169452667236328125" },
+    { 16, "2220446049250313080847263336181640625" },
+    { 16, "11102230246251565404236316680908203125" },
+    { 17, "55511151231257827021181583404541015625" },
+    { 17, "277555756156289135105907917022705078125" },
+    { 17, "1387778780781445675529539585113525390625" },
+    { 18, "6938893903907228377647697925567626953125" },
+    { 18, "34694469519536141888238489627838134765625" },
+    { 18, "173472347597680709441192448139190673828125" },
+    { 19, "867361737988403547205962240695953369140625" }
+};
+
+/* Eisel-Lemire: the binary exponent and mantissa (implicit bit included for subnormals only) of w * 10^q.
+ * Returns false in the rare cases where the truncated product cannot decide the rounding. */
+static cJSON_bool number_eisel_lemire(const long q, uint64_t w, uint64_t * const mantissa, int * const power2)
+{
+    number_uint128 product;
+    int leading_zeros = 0;
+    int upper_bit = 0;
+    int shift = 0;
+    size_t index = 0;
+
+    if ((w == 0) || (q < number_smallest_power_of_ten))
+    {
+        *mantissa = 0;
+        *power2 = 0;
+        return true;
+    }
+    if (q > number_largest_power_of_ten)
+    {
+        *mantissa = 0;
+        *power2 = number_infinite_power;
+        return true;
+    }
+
+    leading_zeros = number_leading_zeros(w);
+    w <<= leading_zeros;
+
+    index = 2 * (size_t)(q - number_smallest_power_of_ten);
+    product = number_multiply(w, number_powers_of_five[index]);
+    /* the low 9 bits below the 55 that matter are all ones: the lower half of the power can still carry into them */
+    if ((product.high & 0x1FF) == 0x1FF)
+    {
+        number_uint128 second = number_multiply(w, number_powers_of_five[index + 1]);
+        product.low += second.high;
+        if (second.high > product.low)
+        {
+            product.high++;
+        }
+    }
+    /* 5^q is exact in 128 bits for q in [-27, 55], outside of that an all ones low word is ambiguous */
+    if ((product.low == UINT64_C(0xFFFFFFFFFFFFFFFF)) && ((q < -27) || (q > 55)))
+    {
+        return false;
+    }
+
+    upper_bit = (int)(product.high >> 63);
+    shift = upper_bit + 64 - number_mantissa_bits - 3;
+    *mantissa = product.high >> shift;
+    /* floor(log2(10^q)) + 63 is (217706 * q >> 16) + 63, then biased by 1023 */
+    *power2 = (int)(((217706 * q) >> 16) + 63) + upper_bit - leading_zeros + 1023;
+
+    if (*power2 <= 0)
+    {
+        /* subnormal */
+        if ((-*power2 + 1) >= 64)
+        {
+            *mantissa = 0;
+            *power2 = 0;
+            return true;
+        }
+        *mantissa >>= -*power2 + 1;
+        *mantissa += (*mantissa & 1);
+        *mantissa >>= 1;
+        /* rounding up can make it the smallest normal number */
+        *power2 = (*mantissa < (UINT64_C(1) << number_mantissa_bits)) ? 0 : 1;
+        return true;
+    }
+
+    /* exactly halfway between two doubles is only possible for small q, round to even then */
+    if ((product.low <= 1) && (q >= -4) && (q <= 23) && ((*mantissa & 3) == 1))
+    {
+        if ((*mantissa << shift) == product.high)
+        {
+            *mantissa &= ~(uint64_t)1;
+        }
+    }
+    *mantissa += (*mantissa & 1);
+    *mantissa >>= 1;
+    if (*mantissa >= (UINT64_C(2) << number_mantissa_bits))
+    {
+        *mantissa = UINT64_C(1) << number_mantissa_bits;
+        (*power2)++;
+    }
+    *mantissa &= ~(UINT64_C(1) << number_mantissa_bits);
+    if (*power2 >= number_infinite_power)
+    {
+        *mantissa = 0;
+        *power2 = number_infinite_power;
+    }
+
+    return true;
+}
+
+/* the slow path: the number as a decimal with up to 800 digits, which are exact for any double */
+#define decimal_max_digits 800
+/* the largest shift that cannot overflow 9 << shift in 64 bits */
+#define decimal_max_shift 60
+
+typedef struct
+{
+    unsigned char digits[decimal_max_digits]; /* big-endian, as characters */
+    int count;
+    long point; /* position of the decimal point relative to digits[0] */
+    cJSON_bool truncated; /* nonzero digits beyond digits[count - 1] were dropped */
+} number_decimal;
+
+static void decimal_trim(number_decimal * const decimal)
+{
+    while ((decimal->count > 0) && (decimal->digits[decimal->count - 1] == '0'))
+    {
+        decimal->count--;
+    }
+    if (decimal->count == 0)
+    {
+        decimal->point = 0;
+    }
+}
+
+/* the digits and exponent of an already validated number */
+static void decimal_read(number_decimal * const decimal, const unsigned char *input, const unsigned char * const end)
+{
+    cJSON_bool seen_point = false;
+    long exponent = 0;
+    cJSON_bool negative_exponent = false;
+
+    decimal->count = 0;
+    decimal->point = 0;
+    decimal->truncated = false;
+
+    for (; input < end; input++)
+    {
+        if (*input == '.')
+        {
+            seen_point = true;
+            decimal->point = decimal->count;
+        }
+        else if ((*input >= '0') && (*input <= '9'))
+        {
+            if ((*input == '0') && (decimal->count == 0))
+            {
+                /* leading zeros only move the decimal point */
+                decimal->point--;
+            }
+            else if (decimal->count < decimal_max_digits)
+            {
+                decimal->digits[decimal->count++] = *input;
+            }
+            else if (*input != '0')
+            {
+                decimal->truncated = true;
+            }
+        }
+        else if ((*input == 'e') || (*input == 'E'))
+        {
+            break;
+        }
+    }
+    if (!seen_point)
+    {
+        decimal->point = decimal->count;
+    }
+
+    if (input < end)
+    {
+        input++;
+        if ((*input == '+') || (*input == '-'))
+        {
+            negative_exponent = (*input == '-');
+            input++;
+        }
+        for (; input < end; input++)
+        {
+            if (exponent < 100000)
+            {
+                exponent = exponent * 10 + (*input - '0');
+            }
+        }
+        decimal->point += negative_exponent ? -exponent : exponent;
+    }
+
+    decimal_trim(decimal);
+}
+
+/* multiply by 2^shift */
+static void decimal_left_shift(number_decimal * const decimal, const unsigned int shift)
+{
+    int delta = decimal_left_shifts[shift].delta;
+    const char *cutoff = decimal_left_shifts[shift].cutoff;
+    int read = 0;
+    int write = 0;
+    uint64_t accumulator = 0;
+    int i = 0;
+
+    /* one digit less if the leading digits are below the cutoff */
+    for (i = 0; cutoff[i] != '\0'; i++)
+    {
+        if (i >= decimal->count)
+        {
+            delta--;
+            break;
+        }
+        if (decimal->digits[i] != (unsigned char)cutoff[i])
+        {
+            if (decimal->digits[i] < (unsigned char)cutoff[i])
+            {
+                delta--;
+            }
+            break;
+        }
+    }
+
+    read = decimal->count;
+    write = decimal->count + delta;
+    for (read--; read >= 0; read--)
+    {
+        uint64_t quotient = 0;
+        accumulator += (uint64_t)(decimal->digits[read] - '0') << shift;
+        quotient = accumulator / 10;
+        write--;
+        if (write < decimal_max_digits)
+        {
+            decimal->digits[write] = (unsigned char)('0' + (accumulator - 10 * quotient));
+        }
+        else if ((accumulator - 10 * quotient) != 0)
+        {
+            decimal->truncated = true;
+        }
+        accumulator = quotient;
+    }
+    while (accumulator > 0)
+    {
+        uint64_t quotient = accumulator / 10;
+        write--;
+        if (write < decimal_max_digits)
+        {
+            decimal->digits[write] = (unsigned char)('0' + (accumulator - 10 * quotient));
+        }
+        else if ((accumulator - 10 * quotient) != 0)
+        {
+            decimal->truncated = true;
+        }
+        accumulator = quotient;
+    }
+
+    decimal->count += delta;
+    if (decimal->count > decimal_max_digits)
+    {
+        decimal->count = decimal_max_digits;
+    }
+    decimal->point += delta;
+    decimal_trim(decimal);
+}
+
+/* divide by 2^shift */
+static void decimal_right_shift(number_decimal * const decimal, const unsigned int shift)
+{
+    int read = 0;
+    int write = 0;
+    uint64_t accumulator = 0;
+    const uint64_t mask = (UINT64_C(1) << shift) - 1;
+
+    /* pick up enough leading digits to cover the first shift */
+    for (; (accumulator >> shift) == 0; read++)
+    {
+        if (read >= decimal->count)
+        {
+            if (accumulator == 0)
+            {
+                decimal->count = 0;
+                decimal->point = 0;
+                return;
+            }
+            while ((accumulator >> shift) == 0)
+            {
+                accumulator *= 10;
+                read++;
+            }
+            break;
+        }
+        accumulator = accumulator * 10 + (uint64_t)(decimal->digits[read] - '0');
+    }
+    decimal->point -= read - 1;
+
+    for (; read < decimal->count; read++)
+    {
+        unsigned char digit = (unsigned char)(accumulator >> shift);
+        accumulator &= mask;
+        decimal->digits[write++] = (unsigned char)('0' + digit);
+        accumulator = accumulator * 10 + (uint64_t)(decimal->digits[read] - '0');
+    }
+    while (accumulator > 0)
+    {
+        unsigned char digit = (unsigned char)(accumulator >> shift);
+        accumulator &= mask;
+        if (write < decimal_max_digits)
+        {
+            decimal->digits[write++] = (unsigned char)('0' + digit);
+        }
+        else if (digit > 0)
+        {
+            decimal->truncated = true;
+        }
+        accumulator *= 10;
+    }
+
+    decimal->count = write;
+    decimal_trim(decimal);
+}
+
+static void decimal_shift(number_decimal * const decimal, int shift)
+{
+    if (decimal->count == 0)
+    {
+        return;
+    }
+    for (; shift > decimal_max_shift; shift -= decimal_max_shift)
+    {
+        decimal_left_shift(decimal, decimal_max_shift);
+    }
+    for (; shift < -decimal_max_shift; shift += decimal_max_shift)
+    {
+        decimal_right_shift(decimal, decimal_max_shift);
+    }
+    if (shift > 0)
+    {
+        decimal_left_shift(decimal, (unsigned int)shift);
+    }
+    else if (shift < 0)
+    {
+        decimal_right_shift(decimal, (unsigned int)-shift);
+    }
+}
+
+/* the integer part, rounded half to even */
+static uint64_t decimal_rounded_integer(const number_decimal * const decimal)
+{
+    uint64_t integer = 0;
+    int i = 0;
+    cJSON_bool round_up = false;
+
+    if (decimal->point > 20)
+    {
+        return UINT64_C(0xFFFFFFFFFFFFFFFF);
+    }
+    for (i = 0; (i < decimal->point) && (i < decimal->count); i++)
+    {
+        integer = integer * 10 + (uint64_t)(decimal->digits[i] - '0');
+    }
+    for (; i < decimal->point; i++)
+    {
+        integer *= 10;
+    }
+
+    if ((decimal->point >= 0) && (decimal->point < decimal->count))
+    {
+        if ((decimal->digits[decimal->point] == '5') && ((decimal->point + 1) == decimal->count))
+        {
+            /* exactly halfway, unless digits were dropped */
+            round_up = decimal->truncated || ((decimal->point > 0) && (((decimal->digits[decimal->point - 1] - '0') % 2) == 1));
+        }
+        else
+        {
+            round_up = decimal->digits[decimal->point] >= '5';
+        }
+    }
+    if (round_up)
+    {
+        integer++;
+    }
+
+    return integer;
+}
+
+/* bits of the double closest to the decimal, without the sign */
+static uint64_t decimal_to_bits(number_decimal * const decimal)
+{
+    /* binary shifts that move a decimal point at 0..8 by at most that many digits */
+    static const int shifts[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    int exponent = 0;
+    uint64_t mantissa = 0;
+
+    if (decimal->count == 0)
+    {
+        return 0;
+    }
+    if (decimal->point > 310)
+    {
+        return (uint64_t)number_infinite_power << number_mantissa_bits;
+    }
+    if (decimal->point < -330)
+    {
+        return 0;
+    }
+
+    /* scale into [0.5, 1) */
+    while (decimal->point > 0)
+    {
+        int shift = (decimal->point >= 9) ? 27 : shifts[decimal->point];
+        decimal_shift(decimal, -shift);
+        exponent += shift;
+    }
+    while ((decimal->point < 0) || ((decimal->point == 0) && (decimal->digits[0] < '5')))
+    {
+        int shift = (-decimal->point >= 9) ? 27 : shifts[-decimal->point];
+        decimal_shift(decimal, shift);
+        exponent -= shift;
+    }
+
+    /* [0.5, 1) is [1, 2) one exponent lower */
+    exponent--;
+    if (exponent < -1022)
+    {
+        /* subnormal: shift the mantissa down to the smallest exponent */
+        decimal_shift(decimal, exponent + 1022);
+        exponent = -1022;
+    }
+    if ((exponent + 1023) >= number_infinite_power)
+    {
+        return (uint64_t)number_infinite_power << number_mantissa_bits;
+    }
+
+    decimal_shift(decimal, number_mantissa_bits + 1);
+    mantissa = decimal_rounded_integer(decimal);
+    if (mantissa == (UINT64_C(2) << number_mantissa_bits))
+    {
+        /* rounding carried into the next power of two */
+        mantissa >>= 1;
+        exponent++;
+        if ((exponent + 1023) >= number_infinite_power)
+        {
+            return (uint64_t)number_infinite_power << number_mantissa_bits;
+        }
+    }
+    if ((mantissa & (UINT64_C(1) << number_mantissa_bits)) == 0)
+    {
+        exponent = -1023;
+    }
+
+    return (mantissa & ((UINT64_C(1) << number_mantissa_bits) - 1)) | ((uint64_t)(exponent + 1023) << number_mantissa_bits);
+}
+
+/* Parse the input text to generate a number, and populate the result into item.
+ * Accepts what strtod accepted from the characters cJSON used to copy for it: [+-]digits[.digits][(e|E)[+-]digits],
+ * where either the integer or the fraction digits may be missing and an incomplete exponent is left unparsed. */
+static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_buffer)
+{
+    /* exactly representable powers of ten */
+    static const double powers_of_ten[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    double number = 0;
+    const unsigned char *start = NULL;
+    const unsigned char *end = NULL;
+    const unsigned char *pointer = NULL;
+    const unsigned char *integer_start = NULL;
+    cJSON_bool negative = false;
+    uint64_t w = 0;
+    size_t significant = 0; /* significant digits seen, leading zeros excluded */
+    size_t digits = 0; /* all mantissa digits */
+    long point = 0; /* decimal point relative to the first significant digit */
+    long q = 0;
+    long exponent = 0;
+    cJSON_bool integral = true; /* no fraction and no exponent */
+
+    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+    {
+        return false;
+    }
+
+    start = buffer_at_offset(input_buffer);
+    end = input_buffer->content + input_buffer->length;
+    pointer = start;
+
+    if ((pointer < end) && ((*pointer == '-') || (*pointer == '+')))
+    {
+        negative = (*pointer == '-');
+        pointer++;
+    }
+
+    integer_start = pointer;
+    for (; (pointer < end) && (*pointer >= '0') && (*pointer <= '9'); pointer++)
+    {
+        if ((significant == 0) && (*pointer == '0'))
+        {
+            continue;
+        }
+        if (significant < 19)
+        {
+            w = w * 10 + (uint64_t)(*pointer - '0');
+        }
+        significant++;
+    }
+    digits = (size_t)(pointer - integer_start);
+    /* digits counts are capped so that the exponent arithmetic below cannot overflow */
+    point = (long)((significant < 100000000) ? significant : 100000000);
+
+    if ((pointer < end) && (*pointer == '.'))
+    {
+        const unsigned char *fraction_start = ++pointer;
+        integral = false;
+        for (; (pointer < end) && (*pointer >= '0') && (*pointer <= '9'); pointer++)
+        {
+            if ((significant == 0) && (*pointer == '0'))
+            {
+                /* zeros right after the point only move it */
+                if (point > -100000000)
+                {
+                    point--;
+                }
+                continue;
+            }
+            if (significant < 19)
+            {
+                w = w * 10 + (uint64_t)(*pointer - '0');
+            }
+            significant++;
+        }
+        digits += (size_t)(pointer - fraction_start);
+    }
+    if (digits == 0)
+    {
+        return false; /* parse_error */
+    }
+
+    if ((pointer < end) && ((*pointer == 'e') || (*pointer == 'E')))
+    {
+        const unsigned char *exponent_pointer = pointer + 1;
+        cJSON_bool negative_exponent = false;
+        if ((exponent_pointer < end) && ((*exponent_pointer == '+') || (*exponent_pointer == '-')))
+        {
+            negative_exponent = (*exponent_pointer == '-');
+            exponent_pointer++;
+        }
+        if ((exponent_pointer < end) && (*exponent_pointer >= '0') && (*exponent_pointer <= '9'))
+        {
+            for (; (exponent_pointer < end) && (*exponent_pointer >= '0') && (*exponent_pointer <= '9'); exponent_pointer++)
+            {
+                if (exponent < 100000000)
+                {
+                    exponent = exponent * 10 + (*exponent_pointer - '0');
+                }
+            }
+            if (negative_exponent)
+            {
+                exponent = -exponent;
+            }
+            pointer = exponent_pointer;
+            integral = false;
+        }
+    }
+
+    /* w holds the first min(significant, 19) digits */
+    q = point + exponent - (long)((significant < 19) ? significant : 19);
+
+    if (significant == 0)
+    {
+        number = 0;
+    }
+#if !defined(FLT_EVAL_METHOD) || (FLT_EVAL_METHOD == 0)
+    else if ((significant <= 19) && (w <= (UINT64_C(1) << 53)) && (q >= -22) && (q <= 22))
+    {
+        number = (double)w;
+        number = (q < 0) ? (number / powers_of_ten[-q]) : (number * powers_of_ten[q]);
+    }
+#endif
+    else
+    {
+        uint64_t mantissa = 0;
+        int power2 = 0;
+        cJSON_bool decided = number_eisel_lemire(q, w, &mantissa, &power2);
+
+        /* with dropped digits the value lies between w and w + 1, both have to round the same way */
+        if (decided && (significant > 19))
+        {
+            uint64_t upper_mantissa = 0;
+            int upper_power2 = 0;
+            decided = number_eisel_lemire(q, w + 1, &upper_mantissa, &upper_power2) && (upper_mantissa == mantissa) && (upper_power2 == power2);
+        }
+
+        if (decided)
+        {
+            number = number_from_bits(mantissa | ((uint64_t)power2 << number_mantissa_bits));
+        }
+        else
+        {
+            number_decimal decimal;
+            decimal_read(&decimal, start, pointer);
+            number = number_from_bits(decimal_to_bits(&decimal));
+        }
+    }
+    if (negative)
+    {
+        number = -number;
+    }
+
+    item->valuedouble = number;
+
+    /* use saturation in case of overflow */
+    if (number >= INT_MAX)
+    {
+        item->valueint = INT_MAX;
+    }
+    else if (number <= (double)INT_MIN)
+    {
+        item->valueint = INT_MIN;
+    }
+    else
+    {
+        item->valueint = (int)number;
+    }
+
+    item->type = cJSON_Number;
+
+    /* integers that fit 64 bits are kept exactly, w holds up to 19 digits and the 20th is the last one */
+    if (integral && (significant <= 20))
+    {
+        uint64_t integer = w;
+        cJSON_bool fits = true;
+        if (significant == 20)
+        {
+            uint64_t digit = (uint64_t)(*(pointer - 1) - '0');
+            fits = (w < UINT64_C(1844674407370955161)) || ((w == UINT64_C(1844674407370955161)) && (digit <= 5));
+            integer = w * 10 + digit;
+        }
+        if (fits && !negative)
+        {
+            item->valueint64 = (integer <= (uint64_t)INT64_MAX) ? (int64_t)integer : int64_from_uint64(integer);
+            item->type |= (integer <= (uint64_t)INT64_MAX) ? cJSON_NumberIsInt64 : cJSON_NumberIsUint64;
+        }
+        else if (fits && (integer <= (UINT64_C(1) << 63)))
+        {
+            item->valueint64 = (integer == (UINT64_C(1) << 63)) ? INT64_MIN : -(int64_t)integer;
+            item->type |= cJSON_NumberIsInt64;
+        }
+    }
+
+    input_buffer->offset += (size_t)(pointer - start);
+    return true;
+}
+
+/* don't ask me, but the original cJSON_SetNumberValue returns an integer or double */
+CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number)
+{
+    object->type &= ~cJSON_NumberIsInteger;
+    if (number >= INT_MAX)
+    {
+        object->valueint = INT_MAX;
+    }
+    else if (number <= (double)INT_MIN)
+    {
+        object->valueint = INT_MIN;
+    }
+    else
+    {
+        object->valueint = (int)number;
+    }
+
+    return object->valuedouble = number;
+}
+
+/* Note: when passing a NULL valuestring, cJSON_SetValuestring treats this as an error and return NULL */
+CJSON_PUBLIC(char*) cJSON_SetValuestring(cJSON *object, const char *valuestring)
+{
+    char *copy = NULL;
+    size_t v1_len;
+    size_t v2_len;
+    /* if object's type is not cJSON_String or is cJSON_IsReference, it should not set valuestring */
+    if ((object == NULL) || !(object->type & cJSON_String) || (object->type & cJSON_IsReference))
+    {
+        return NULL;
+    }
+    /* return NULL if the object is corrupted or valuestring is NULL */
+    if (object->valuestring == NULL || valuestring == NULL)
+    {
+        return NULL;
+    }
+
+    v1_len = strlen(valuestring);
+    v2_len = strlen(object->valuestring);
+
+    if (v1_len <= v2_len)
+    {
+        /* strcpy does not handle overlapping string: [X1, X2] [Y1, Y2] => X2 < Y1 or Y2 < X1 */
+        if (!( valuestring + v1_len < object->valuestring || object->valuestring + v2_len < valuestring ))
+        {
+            return NULL;
+        }
+        strcpy(object->valuestring, valuestring);
+        return object->valuestring;
+    }
+    copy = (char*) cJSON_strdup((const unsigned char*)valuestring, &global_hooks);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    if (object->valuestring != NULL)
+    {
+        cJSON_free(object->valuestring);
+    }
+    object->valuestring = copy;
+
+    return copy;
+}
+
+typedef struct
+{
+    unsigned char *buffer;
+    size_t length;
+    size_t offset;
+    size_t depth; /* current nesting depth (for formatted printing) */
+    cJSON_bool noalloc;
+    cJSON_bool format; /* is this print a formatted print */
+    internal_hooks hooks;
+} printbuffer;
+
+/* realloc printbuffer if necessary to have at least "needed" bytes more */
+static unsigned char* ensure(printbuffer * const p, size_t needed)
+{
+    unsigned char *newbuffer = NULL;
+    size_t newsize = 0;
+
+    if ((p == NULL) || (p->buffer == NULL))
+    {
+        return NULL;
+    }
+
+    if ((p->length > 0) && (p->offset >= p->length))
+    {
+        /* make sure that offset is valid */
+        return NULL;
+    }
+
+    if (needed > INT_MAX)
+    {
+        /* sizes bigger than INT_MAX are currently not supported */
+        return NULL;
+    }
+
+    needed += p->offset + 1;
+    if (needed <= p->length)
+    {
+        return p->buffer + p->offset;
+    }
+
+    if (p->noalloc) {
+        return NULL;
+    }
+
+    /* calculate new buffer size */
+    if (needed > (INT_MAX / 2))
+    {
+        /* overflow of int, use INT_MAX if possible */
+        if (needed <= INT_MAX)
+        {
+            newsize = INT_MAX;
+        }
+        else
+        {
+            return NULL;
+        }
+    }
+    else
+    {
+        newsize = needed * 2;
+    }
+
+    if (p->hooks.reallocate != NULL)
+    {
+        /* reallocate with realloc if available */
+        newbuffer = (unsigned char*)p->hooks.reallocate(p->buffer, newsize);
+        if (newbuffer == NULL)
+        {
+            p->hooks.deallocate(p->buffer);
+            p->length = 0;
+            p->buffer = NULL;
+
+            return NULL;
+        }
+    }
+    else
+    {
+        /* otherwise reallocate manually */
+        newbuffer = (unsigned char*)p->hooks.allocate(newsize);
+        if (!newbuffer)
+        {
+            p->hooks.deallocate(p->buffer);
+            p->length = 0;
+            p->buffer = NULL;
+
+            return NULL;
+        }
+
+        memcpy(newbuffer, p->buffer, p->offset + 1);
+        p->hooks.deallocate(p->buffer);
+    }
+    p->length = newsize;
+    p->buffer = newbuffer;
+
+    return newbuffer + p->offset;
+}
+
+/* calculate the new length of the string in a printbuffer and update the offset */
+static void update_offset(printbuffer * const buffer)
+{
+    const unsigned char *buffer_pointer = NULL;
+    if ((buffer == NULL) || (buffer->buffer == NULL))
+    {
+        return;
+    }
+    buffer_pointer = buffer->buffer + buffer->offset;
+
+    buffer->offset += strlen((const char*)buffer_pointer);
+}
+
+/* securely comparison of floating-point variables */
+static cJSON_bool compare_double(double a, double b)
+{
+    double maxVal = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+    return (fabs(a - b) <= maxVal * DBL_EPSILON);
+}
+
+/* Shortest round-trip number printing with the Grisu2 algorithm (Florian Loitsch, "Printing Floating-Point
+ * Numbers Quickly and Accurately with Integers"). The double and the halfway points to its neighbours are
+ * scaled by a cached power of ten into 64-bit fixed point, and digits are generated until they fall between
+ * the halfway points. The digits always parse back to the same double and are the shortest ones that do in
+ * all but a tiny fraction of cases, where a 17th digit may be printed that was not needed. */
+
+typedef struct
+{
+    uint64_t f;
+    int e;
+} grisu_fp; /* f * 2^e */
+
+/* the scaled numbers have their binary exponent in [grisu_alpha, -32], so the integral part fits in 32 bits */
+#define grisu_alpha (-60)
+
+static grisu_fp grisu_normalize(grisu_fp x)
+{
+    int shift = number_leading_zeros(x.f);
+    x.f <<= shift;
+    x.e -= shift;
+    return x;
+}
+
+/* product rounded to the upper 64 bits */
+static grisu_fp grisu_multiply(const grisu_fp x, const grisu_fp y)
+{
+    grisu_fp product;
+    number_uint128 full = number_multiply(x.f, y.f);
+    product.f = full.high + (full.low >> 63);
+    product.e = x.e + y.e + 64;
+    return product;
+}
+
+/* 10^k rounded to 64 bits, for the k that moves the binary exponent e into [grisu_alpha, -32] */
+static grisu_fp grisu_cached_power(const int e, int * const k)
+{
+    grisu_fp power;
+    long x = (long)(grisu_alpha - e - 1);
+    long q = 0;
+    size_t index = 0;
+
+    /* 78913 / 2^18 is log10(2), one more than the floor still lands below -32 */
+    q = ((x * 78913) >> 18) + 1;
+    index = 2 * (size_t)(q - number_smallest_power_of_ten);
+    /* 5^q and 10^q only differ in the binary exponent */
+    power.f = number_powers_of_five[index] + (number_powers_of_five[index + 1] >> 63);
+    power.e = (int)((217706 * q) >> 16) - 63;
+    *k = (int)q;
+
+    return power;
+}
+
+/* step the last digit down while that moves closer to the scaled double and stays above the lower bound */
+static void grisu_round(unsigned char * const digits, const int length, const uint64_t distance, const uint64_t delta, uint64_t rest, const uint64_t ten_k)
+{
+    while ((rest < distance)
+            && ((delta - rest) >= ten_k)
+            && (((rest + ten_k) < distance) || ((distance - rest) > (rest + ten_k - distance))))
+    {
+        digits[length - 1]--;
+        rest += ten_k;
+    }
+}
+
+/* digits of a positive finite double, returns their count and sets value = digits * 10^decimal_exponent */
+static int grisu_shortest(const double value, unsigned char * const digits, int * const decimal_exponent)
+{
+    uint64_t bits = 0;
+    uint64_t fraction = 0;
+    int biased_exponent = 0;
+    int k = 0;
+    int length = 0;
+    int shift = 0;
+    uint32_t integral = 0;
+    uint32_t power = 1;
+    uint64_t fractional = 0;
+    uint64_t delta = 0;
+    uint64_t distance = 0;
+    uint64_t one = 0;
+    grisu_fp v;
+    grisu_fp lower;
+    grisu_fp upper;
+    grisu_fp cached;
+
+    memcpy(&bits, &value, sizeof(bits));
+    fraction = bits & ((UINT64_C(1) << number_mantissa_bits) - 1);
+    biased_exponent = (int)(bits >> number_mantissa_bits);
+    if (biased_exponent == 0)
+    {
+        v.f = fraction;
+        v.e = 1 - 1075;
+    }
+    else
+    {
+        v.f = fraction | (UINT64_C(1) << number_mantissa_bits);
+        v.e = biased_exponent - 1075;
+    }
+
+    /* halfway points to the neighbours, the lower one is closer at powers of two */
+    upper.f = (2 * v.f) + 1;
+    upper.e = v.e - 1;
+    if ((fraction == 0) && (biased_exponent > 1))
+    {
+        lower.f = (4 * v.f) - 1;
+        lower.e = v.e - 2;
+    }
+    else
+    {
+        lower.f = (2 * v.f) - 1;
+        lower.e = v.e - 1;
+    }
+    upper = grisu_normalize(upper);
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+    v = grisu_normalize(v);
+
+    cached = grisu_cached_power(upper.e, &k);
+    v = grisu_multiply(v, cached);
+    lower = grisu_multiply(lower, cached);
+    upper = grisu_multiply(upper, cached);
+    /* the products can be off by one ulp, stay inside the interval */
+    lower.f++;
+    upper.f--;
+    *decimal_exponent = -k;
+
+    delta = upper.f - lower.f;
+    distance = upper.f - v.f;
+    shift = -upper.e;
+    one = UINT64_C(1) << shift;
+    integral = (uint32_t)(upper.f >> shift);
+    fractional = upper.f & (one - 1);
+
+    while ((integral / power) >= 10)
+    {
+        power *= 10;
+    }
+
+    /* digits of the integral part, stopping as soon as the rest is within delta */
+    while (power > 0)
+    {
+        uint64_t rest = 0;
+        digits[length++] = (unsigned char)('0' + (integral / power));
+        integral %= power;
+        rest = ((uint64_t)integral << shift) + fractional;
+        if (rest <= delta)
+        {
+            /* power <= integral < 2^(64 - shift), the shift cannot overflow */
+            grisu_round(digits, length, distance, delta, rest, (uint64_t)power << shift);
+            /* the remaining integral digits are zeros that go to the exponent */
+            while (power > 1)
+            {
+                (*decimal_exponent)++;
+                power /= 10;
+            }
+            return length;
+        }
+        power /= 10;
+    }
+
+    /* digits of the fractional part */
+    for (;;)
+    {
+        fractional *= 10;
+        digits[length++] = (unsigned char)('0' + (fractional >> shift));
+        fractional &= one - 1;
+        (*decimal_exponent)--;
+        delta *= 10;
+        distance *= 10;
+        if (fractional <= delta)
+        {
+            grisu_round(digits, length, distance, delta, fractional, one);
+            return length;
+        }
+    }
+}
+/* "-", 17 digits, "." and "e-308" (or "0.0000" in front of the digits) fit, with the terminator, as do 64-bit integers */
+#define number_max_length 25
+
+/* write the decimal digits of an unsigned integer, two at a time, returns how many */
+static size_t print_unsigned(unsigned char * const output, uint64_t number)
+{
+    static const char digit_pairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859606162636465666768697071727374757677787980"
+        "81828384858687888990919293949596979899";
+    unsigned char reversed[20];
+    size_t length = 0;
+    size_t i = 0;
+
+    while (number >= 100)
+    {
+        size_t pair = (size_t)(number % 100) * 2;
+        number /= 100;
+        reversed[i++] = (unsigned char)digit_pairs[pair + 1];
+        reversed[i++] = (unsigned char)digit_pairs[pair];
+    }
+    if (number >= 10)
+    {
+        size_t pair = (size_t)number * 2;
+        reversed[i++] = (unsigned char)digit_pairs[pair + 1];
+        reversed[i++] = (unsigned char)digit_pairs[pair];
+    }
+    else
+    {
+        reversed[i++] = (unsigned char)('0' + number);
+    }
+    while (i > 0)
+    {
+        output[length++] = reversed[--i];
+    }
+
+    return length;
+}
+
+static size_t print_integer(unsigned char * const output, const int64_t number)
+{
+    if (number < 0)
+    {
+        output[0] = '-';
+        return print_unsigned(output + 1, 0 - (uint64_t)number) + 1;
+    }
+
+    return print_unsigned(output, (uint64_t)number);
+}
+
+/* write a finite double the way printf's %1.15g did, falling back to %1.17g for numbers that need more digits,
+ * but with the digits from grisu_shortest. Returns the length. */
+static size_t print_double(unsigned char * const output, double number)
+{
+    unsigned char digits[20];
+    unsigned char *output_pointer = output;
+    int decimal_exponent = 0;
+    int exponent = 0;
+    int precision = 0;
+    int length = 0;
+    int i = 0;
+
+    /* integers up to 15 digits are printed in full by %g as well, without the detour over the digits */
+    if ((number > -1e15) && (number < 1e15) && (number == (double)(int64_t)number))
+    {
+        return print_integer(output, (int64_t)number);
     }
 
-    if (p->noalloc) {
-        return NULL;
+    if (number < 0)
+    {
+        *output_pointer++ = '-';
+        number = -number;
+    }
+    length = grisu_shortest(number, digits, &decimal_exponent);
+    while ((length > 1) && (digits[length - 1] == '0'))
+    {
+        length--;
+        decimal_exponent++;
     }
 
-    /* calculate new buffer size */
-    if (needed > (INT_MAX / 2))
+    precision = (length <= 15) ? 15 : 17;
+    exponent = length + decimal_exponent - 1;
+    if ((exponent < -4) || (exponent >= precision))
     {
-        /* overflow of int, use INT_MAX if possible */
-        if (needed <= INT_MAX)
+        /* d.ddde+xx */
+        *output_pointer++ = digits[0];
+        if (length > 1)
         {
-            newsize = INT_MAX;
+            *output_pointer++ = '.';
+            memcpy(output_pointer, digits + 1, (size_t)(length - 1));
+            output_pointer += length - 1;
         }
-        else
+        *output_pointer++ = 'e';
+        *output_pointer++ = (exponent < 0) ? '-' : '+';
+        if (exponent < 0)
         {
-            return NULL;
+            exponent = -exponent;
         }
+        if (exponent >= 100)
+        {
+            *output_pointer++ = (unsigned char)('0' + (exponent / 100));
+        }
+        *output_pointer++ = (unsigned char)('0' + ((exponent / 10) % 10));
+        *output_pointer++ = (unsigned char)('0' + (exponent % 10));
     }
-    else
-    {
-        newsize = needed * 2;
-    }
-
-    if (p->hooks.reallocate != NULL)
+    else if (decimal_exponent >= 0)
     {
-        /* reallocate with realloc if available */
-        newbuffer = (unsigned char*)p->hooks.reallocate(p->buffer, newsize);
-        if (newbuffer == NULL)
+        /* ddd000 */
+        memcpy(output_pointer, digits, (size_t)length);
+        output_pointer += length;
+        for (i = 0; i < decimal_exponent; i++)
         {
-            p->hooks.deallocate(p->buffer);
-            p->length = 0;
-            p->buffer = NULL;
-
-            return NULL;
+            *output_pointer++ = '0';
         }
     }
+    else if (exponent >= 0)
+    {
+        /* dd.ddd */
+        memcpy(output_pointer, digits, (size_t)exponent + 1);
+        output_pointer += exponent + 1;
+        *output_pointer++ = '.';
+        memcpy(output_pointer, digits + exponent + 1, (size_t)(length - exponent - 1));
+        output_pointer += length - exponent - 1;
+    }
     else
     {
-        /* otherwise reallocate manually */
-        newbuffer = (unsigned char*)p->hooks.allocate(newsize);
-        if (!newbuffer)
+        /* 0.000ddd */
+        *output_pointer++ = '0';
+        *output_pointer++ = '.';
+        for (i = -1; i > exponent; i--)
         {
-            p->hooks.deallocate(p->buffer);
-            p->length = 0;
-            p->buffer = NULL;
-
-            return NULL;
+            *output_pointer++ = '0';
         }
-
-        memcpy(newbuffer, p->buffer, p->offset + 1);
-        p->hooks.deallocate(p->buffer);
-    }
-    p->length = newsize;
-    p->buffer = newbuffer;
-
-    return newbuffer + p->offset;
-}
-
-/* calculate the new length of the string in a printbuffer and update the offset */
-static void update_offset(printbuffer * const buffer)
-{
-    const unsigned char *buffer_pointer = NULL;
-    if ((buffer == NULL) || (buffer->buffer == NULL))
-    {
-        return;
+        memcpy(output_pointer, digits, (size_t)length);
+        output_pointer += length;
     }
-    buffer_pointer = buffer->buffer + buffer->offset;
 
-    buffer->offset += strlen((const char*)buffer_pointer);
-}
-
-/* securely comparison of floating-point variables */
-static cJSON_bool compare_double(double a, double b)
-{
-    double maxVal = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
-    return (fabs(a - b) <= maxVal * DBL_EPSILON);
+    return (size_t)(output_pointer - output);
 }
 
 /* Render the number nicely from the given item into a string. */
@@ -565,67 +3204,60 @@ static cJSON_bool print_number(const cJSON * const item, printbuffer * const out
 {
     unsigned char *output_pointer = NULL;
     double d = item->valuedouble;
-    int length = 0;
-    size_t i = 0;
-    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
-    unsigned char decimal_point = get_decimal_point();
-    double test = 0.0;
+    size_t length = 0;
+    unsigned char number_buffer[number_max_length + 1]; /* for preallocated buffers with less room left */
 
     if (output_buffer == NULL)
     {
         return false;
     }
 
+    /* print straight into the output, unless a preallocated buffer only has room for this number */
+    output_pointer = ensure(output_buffer, number_max_length);
+    if (output_pointer == NULL)
+    {
+        if (!output_buffer->noalloc)
+        {
+            return false;
+        }
+        output_pointer = number_buffer;
+    }
+
     /* This checks for NaN and Infinity */
     if (isnan(d) || isinf(d))
     {
-        length = sprintf((char*)number_buffer, "null");
+        memcpy(output_pointer, "null", sizeof("null") - 1);
+        length = sizeof("null") - 1;
     }
-    else if(d == (double)item->valueint)
+    else if (number_is_int64(item))
     {
-        length = sprintf((char*)number_buffer, "%d", item->valueint);
+        length = print_integer(output_pointer, item->valueint64);
     }
-    else
+    else if (number_is_uint64(item))
     {
-        /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
-        length = sprintf((char*)number_buffer, "%1.15g", d);
-
-        /* Check whether the original double can be recovered */
-        if ((sscanf((char*)number_buffer, "%lg", &test) != 1) || !compare_double((double)test, d))
-        {
-            /* If not, print with 17 decimal places of precision */
-            length = sprintf((char*)number_buffer, "%1.17g", d);
-        }
+        length = print_unsigned(output_pointer, (uint64_t)item->valueint64);
     }
-
-    /* sprintf failed or buffer overrun occurred */
-    if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
+    else if (d == (double)item->valueint)
     {
-        return false;
+        length = print_integer(output_pointer, item->valueint);
     }
-
-    /* reserve appropriate space in the output */
-    output_pointer = ensure(output_buffer, (size_t)length + sizeof(""));
-    if (output_pointer == NULL)
+    else
     {
-        return false;
+        length = print_double(output_pointer, d);
     }
 
-    /* copy the printed number to the output and replace locale
-     * dependent decimal point with '.' */
-    for (i = 0; i < ((size_t)length); i++)
+    if (output_pointer == number_buffer)
     {
-        if (number_buffer[i] == decimal_point)
+        output_pointer = ensure(output_buffer, length + sizeof(""));
+        if (output_pointer == NULL)
         {
-            output_pointer[i] = '.';
-            continue;
+            return false;
         }
-
-        output_pointer[i] = number_buffer[i];
+        memcpy(output_pointer, number_buffer, length);
     }
-    output_pointer[i] = '\0';
+    output_pointer[length] = '\0';
 
-    output_buffer->offset += (size_t)length;
+    output_buffer->offset += length;
 
     return true;
 }
@@ -795,6 +3427,7 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     const unsigned char *input_end = buffer_at_offset(input_buffer) + 1;
     unsigned char *output_pointer = NULL;
     unsigned char *output = NULL;
+    size_t skipped_bytes = 0;
 
     /* not a string */
     if (buffer_at_offset(input_buffer)[0] != '\"')
@@ -805,21 +3438,23 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     {
         /* calculate approximate size of the output (overestimate) */
         size_t allocation_length = 0;
-        size_t skipped_bytes = 0;
         while (((size_t)(input_end - input_buffer->content) < input_buffer->length) && (*input_end != '\"'))
         {
+            /* jump over the clean run up to the next quote or escape */
+            input_end += find_string_special(input_end, input_buffer->length - (size_t)(input_end - input_buffer->content));
+            if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end == '\"'))
+            {
+                break;
+            }
+
             /* is escape sequence */
-            if (input_end[0] == '\\')
+            if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
             {
-                if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
-                {
-                    /* prevent buffer overflow when last input character is a backslash */
-                    goto fail;
-                }
-                skipped_bytes++;
-                input_end++;
+                /* prevent buffer overflow when last input character is a backslash */
+                goto fail;
             }
-            input_end++;
+            skipped_bytes++;
+            input_end += 2;
         }
         if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end != '\"'))
         {
@@ -828,7 +3463,7 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
 
         /* This is at most how much we need for the output */
         allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char*)input_buffer->hooks.allocate(allocation_length + sizeof(""));
+        output = (unsigned char*)parse_allocate(input_buffer, allocation_length + sizeof(""));
         if (output == NULL)
         {
             goto fail; /* allocation failure */
@@ -836,12 +3471,23 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
     }
 
     output_pointer = output;
+    /* without escapes the string is a plain copy */
+    if (skipped_bytes == 0)
+    {
+        memcpy(output_pointer, input_pointer, (size_t)(input_end - input_pointer));
+        output_pointer += input_end - input_pointer;
+        input_pointer = input_end;
+    }
     /* loop through the string literal */
     while (input_pointer < input_end)
     {
         if (*input_pointer != '\\')
         {
-            *output_pointer++ = *input_pointer++;
+            /* copy the run up to the next escape at once */
+            size_t run = find_string_special(input_pointer, (size_t)(input_end - input_pointer));
+            memcpy(output_pointer, input_pointer, run);
+            output_pointer += run;
+            input_pointer += run;
         }
         /* escape sequence */
         else
@@ -906,7 +3552,7 @@ static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_bu
 fail:
     if (output != NULL)
     {
-        input_buffer->hooks.deallocate(output);
+        parse_deallocate(input_buffer, output);
         output = NULL;
     }
 
@@ -918,12 +3564,66 @@ fail:
     return false;
 }
 
+/* Parse the name of an object member into item->string, shared through the key pool if there is one. */
+static cJSON_bool parse_key(cJSON * const item, parse_buffer * const input_buffer)
+{
+    const unsigned char *key = NULL;
+    char *interned = NULL;
+    size_t remaining = 0;
+    size_t length = 0;
+
+    if ((input_buffer->keys == NULL) || cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '\"'))
+    {
+        if (!parse_string(item, input_buffer))
+        {
+            return false;
+        }
+        item->string = item->valuestring;
+        item->valuestring = NULL;
+        return true;
+    }
+
+    key = buffer_at_offset(input_buffer) + 1;
+    remaining = input_buffer->length - input_buffer->offset - 1;
+    length = find_string_special(key, remaining);
+    if ((length < remaining) && (key[length] == '\"'))
+    {
+        /* no escapes: the key is interned straight from the input */
+        interned = key_pool_intern(input_buffer->keys, key, length);
+        if (interned == NULL)
+        {
+            return false; /* allocation failure */
+        }
+        input_buffer->offset += length + 2;
+    }
+    else
+    {
+        if (!parse_string(item, input_buffer))
+        {
+            return false;
+        }
+        interned = key_pool_intern(input_buffer->keys, (const unsigned char*)item->valuestring, strlen(item->valuestring));
+        parse_deallocate(input_buffer, item->valuestring);
+        item->valuestring = NULL;
+        if (interned == NULL)
+        {
+            return false; /* allocation failure */
+        }
+    }
+
+    item->string = interned;
+    item->type |= cJSON_StringIsConst;
+
+    return true;
+}
+
 /* Render the cstring provided to an escaped version that can be printed. */
 static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer)
 {
     const unsigned char *input_pointer = NULL;
     unsigned char *output = NULL;
     unsigned char *output_pointer = NULL;
+    size_t input_length = 0;
     size_t output_length = 0;
     /* numbers of additional characters needed for escaping */
     size_t escape_characters = 0;
@@ -946,8 +3646,10 @@ static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffe
         return true;
     }
 
-    /* set "flag" to 1 if something needs to be escaped */
-    for (input_pointer = input; *input_pointer; input_pointer++)
+    /* count the additional characters, jumping over the runs that need no escaping */
+    input_length = strlen((const char*)input);
+    input_pointer = input + find_escape(input, input_length);
+    while (input_pointer < (input + input_length))
     {
         switch (*input_pointer)
         {
@@ -969,8 +3671,10 @@ static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffe
                 }
                 break;
         }
+        input_pointer++;
+        input_pointer += find_escape(input_pointer, input_length - (size_t)(input_pointer - input));
     }
-    output_length = (size_t)(input_pointer - input) + escape_characters;
+    output_length = input_length + escape_characters;
 
     output = ensure(output_buffer, output_length + sizeof("\"\""));
     if (output == NULL)
@@ -994,10 +3698,13 @@ static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffe
     /* copy the string */
     for (input_pointer = input; *input_pointer != '\0'; (void)input_pointer++, output_pointer++)
     {
-        if ((*input_pointer > 31) && (*input_pointer != '\"') && (*input_pointer != '\\'))
+        size_t run = find_escape(input_pointer, input_length - (size_t)(input_pointer - input));
+        if (run > 0)
         {
-            /* normal character, copy */
-            *output_pointer = *input_pointer;
+            /* normal characters, copy the whole run */
+            memcpy(output_pointer, input_pointer, run);
+            input_pointer += run - 1;
+            output_pointer += run - 1;
         }
         else
         {
@@ -1067,6 +3774,21 @@ static parse_buffer *buffer_skip_whitespace(parse_buffer * const buffer)
         return buffer;
     }
 
+#ifdef CJSON_SIMD_X86
+    /* most calls find no whitespace or a single space, only indentation runs are worth a vector loop */
+    if ((buffer_at_offset(buffer)[0] <= 32) && can_access_at_index(buffer, 16) && (buffer_at_offset(buffer)[1] <= 32))
+    {
+        size_t remaining = buffer->length - buffer->offset;
+        if (simd_level() == SIMD_AVX2)
+        {
+            buffer->offset += skip_whitespace_avx2(buffer_at_offset(buffer), remaining);
+        }
+        else
+        {
+            buffer->offset += skip_whitespace_sse2(buffer_at_offset(buffer), remaining);
+        }
+    }
+#endif
     while (can_access_at_index(buffer, 0) && (buffer_at_offset(buffer)[0] <= 32))
     {
        buffer->offset++;
@@ -1112,10 +3834,13 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return
 }
 
 /* Parse an object - create a new root, and populate. */
-CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+static cJSON *parse_document(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated, cJSON_Arena * const arena, cJSON_KeyPool * const keys)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 }, NULL, NULL };
     cJSON *item = NULL;
+    /* where the arena stood before this document, to give the memory of a failed parse back */
+    arena_block *arena_block_mark = NULL;
+    size_t arena_used_mark = 0;
 
     /* reset error position */
     global_error.json = NULL;
@@ -1130,8 +3855,15 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer
     buffer.length = buffer_length;
     buffer.offset = 0;
     buffer.hooks = global_hooks;
+    buffer.arena = arena;
+    buffer.keys = keys;
+    if (arena != NULL)
+    {
+        arena_block_mark = arena->current;
+        arena_used_mark = arena->current->used;
+    }
 
-    item = cJSON_New_Item(&global_hooks);
+    item = parse_new_item(&buffer);
     if (item == NULL) /* memory fail */
     {
         goto fail;
@@ -1162,7 +3894,12 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer
 fail:
     if (item != NULL)
     {
-        cJSON_Delete(item);
+        parse_delete(&buffer, item);
+    }
+    if (arena_block_mark != NULL)
+    {
+        arena->current = arena_block_mark;
+        arena->current->used = arena_used_mark;
     }
 
     if (value != NULL)
@@ -1191,6 +3928,31 @@ fail:
     return NULL;
 }
 
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    return parse_document(value, buffer_length, return_parse_end, require_null_terminated, NULL, NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInArena(cJSON_Arena *arena, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    return parse_document(value, buffer_length, return_parse_end, require_null_terminated, arena, NULL);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithKeyPool(cJSON_KeyPool *pool, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    return parse_document(value, buffer_length, return_parse_end, require_null_terminated, NULL, pool);
+}
+
 /* Default options for cJSON_Parse */
 CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
 {
@@ -1500,7 +4262,7 @@ static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buf
     do
     {
         /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
+        cJSON *new_item = parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1545,6 +4307,7 @@ success:
 
     item->type = cJSON_Array;
     item->child = head;
+    index_consider(item, input_buffer->arena, &input_buffer->hooks);
 
     input_buffer->offset++;
 
@@ -1553,7 +4316,7 @@ success:
 fail:
     if (head != NULL)
     {
-        cJSON_Delete(head);
+        parse_delete(input_buffer, head);
     }
 
     return false;
@@ -1626,6 +4389,7 @@ static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_bu
 {
     cJSON *head = NULL; /* linked list head */
     cJSON *current_item = NULL;
+    cJSON_bool parsed = false;
 
     if (input_buffer->depth >= CJSON_NESTING_LIMIT)
     {
@@ -1658,7 +4422,7 @@ static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_bu
     do
     {
         /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
+        cJSON *new_item = parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1686,16 +4450,12 @@ static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_bu
         /* parse the name of the child */
         input_buffer->offset++;
         buffer_skip_whitespace(input_buffer);
-        if (!parse_string(current_item, input_buffer))
+        if (!parse_key(current_item, input_buffer))
         {
             goto fail; /* failed to parse name */
         }
         buffer_skip_whitespace(input_buffer);
 
-        /* swap valuestring and string, because we parsed the name */
-        current_item->string = current_item->valuestring;
-        current_item->valuestring = NULL;
-
         if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ':'))
         {
             goto fail; /* invalid object */
@@ -1704,7 +4464,13 @@ static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_bu
         /* parse the value */
         input_buffer->offset++;
         buffer_skip_whitespace(input_buffer);
-        if (!parse_value(current_item, input_buffer))
+        parsed = parse_value(current_item, input_buffer);
+        if (input_buffer->keys != NULL)
+        {
+            /* parse_value sets the type, the pooled key must not be freed with the item */
+            current_item->type |= cJSON_StringIsConst;
+        }
+        if (!parsed)
         {
             goto fail; /* failed to parse value */
         }
@@ -1726,6 +4492,7 @@ success:
 
     item->type = cJSON_Object;
     item->child = head;
+    index_consider(item, input_buffer->arena, &input_buffer->hooks);
 
     input_buffer->offset++;
     return true;
@@ -1733,7 +4500,7 @@ success:
 fail:
     if (head != NULL)
     {
-        cJSON_Delete(head);
+        parse_delete(input_buffer, head);
     }
 
     return false;
@@ -1854,6 +4621,21 @@ static cJSON_bool print_object(const cJSON * const item, printbuffer * const out
 }
 
 /* Get Array size/item / object item. */
+#if defined(__clang__) || (defined(__GNUC__)  && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ > 5))))
+    #pragma GCC diagnostic push
+#endif
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wcast-qual"
+#endif
+/* helper function to cast away const */
+static void* cast_away_const(const void* string)
+{
+    return (void*)string;
+}
+#if defined(__clang__) || (defined(__GNUC__)  && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ > 5))))
+    #pragma GCC diagnostic pop
+#endif
+
 CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array)
 {
     cJSON *child = NULL;
@@ -1864,6 +4646,11 @@ CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array)
         return 0;
     }
 
+    if (array->index != NULL)
+    {
+        return (int)array->index->count;
+    }
+
     child = array->child;
 
     while(child != NULL)
@@ -1886,6 +4673,19 @@ static cJSON* get_array_item(const cJSON *array, size_t index)
         return NULL;
     }
 
+    if ((array->index != NULL) && (array->index->items != NULL))
+    {
+        if (index >= array->index->count)
+        {
+            return NULL;
+        }
+        /* mutators keep the items current; a stale index is never written here, just skipped */
+        if (!array->index->stale)
+        {
+            return array->index->items[index];
+        }
+    }
+
     current_child = array->child;
     while ((current_child != NULL) && (index > 0))
     {
@@ -1915,17 +4715,48 @@ static cJSON *get_object_item(const cJSON * const object, const char * const nam
         return NULL;
     }
 
+    if ((object->index != NULL) && (object->index->entries != NULL))
+    {
+        const struct cJSON_Index *index = object->index;
+        uint32_t hash = object_key_hash((const unsigned char*)name);
+        size_t mask = index->capacity - 1;
+        size_t slot = hash & mask;
+        cJSON *found = NULL;
+
+        for (; index->entries[slot].item != NULL; slot = (slot + 1) & mask)
+        {
+            cJSON *candidate = index->entries[slot].item;
+            /* a key from the same pool is the same pointer */
+            if ((candidate->string != name) && ((index->entries[slot].hash != hash)
+                    || (case_sensitive ? (strcmp(name, candidate->string) != 0) : (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)candidate->string) != 0))))
+            {
+                continue;
+            }
+            if (found != NULL)
+            {
+                /* duplicate keys: the first one in the object wins, which only the list knows */
+                found = NULL;
+                break;
+            }
+            found = candidate;
+        }
+        if ((found != NULL) || (index->entries[slot].item == NULL))
+        {
+            return found;
+        }
+    }
+
     current_element = object->child;
     if (case_sensitive)
     {
-        while ((current_element != NULL) && (current_element->string != NULL) && (strcmp(name, current_element->string) != 0))
+        while ((current_element != NULL) && (current_element->string != NULL) && (current_element->string != name) && (strcmp(name, current_element->string) != 0))
         {
             current_element = current_element->next;
         }
     }
     else
     {
-        while ((current_element != NULL) && (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)(current_element->string)) != 0))
+        while ((current_element != NULL) && (current_element->string != name) && (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)(current_element->string)) != 0))
         {
             current_element = current_element->next;
         }
@@ -1979,6 +4810,8 @@ static cJSON *create_reference(const cJSON *item, const internal_hooks * const h
     reference->string = NULL;
     reference->type |= cJSON_IsReference;
     reference->next = reference->prev = NULL;
+    /* the index belongs to the referenced object and may be rebuilt under it */
+    reference->index = NULL;
     return reference;
 }
 
@@ -2011,6 +4844,7 @@ static cJSON_bool add_item_to_array(cJSON *array, cJSON *item)
             array->child->prev = item;
         }
     }
+    index_add(array, item);
 
     return true;
 }
@@ -2021,22 +4855,6 @@ CJSON_PUBLIC(cJSON_bool) cJSON_AddItemToArray(cJSON *array, cJSON *item)
     return add_item_to_array(array, item);
 }
 
-#if defined(__clang__) || (defined(__GNUC__)  && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ > 5))))
-    #pragma GCC diagnostic push
-#endif
-#ifdef __GNUC__
-#pragma GCC diagnostic ignored "-Wcast-qual"
-#endif
-/* helper function to cast away const */
-static void* cast_away_const(const void* string)
-{
-    return (void*)string;
-}
-#if defined(__clang__) || (defined(__GNUC__)  && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ > 5))))
-    #pragma GCC diagnostic pop
-#endif
-
-
 static cJSON_bool add_item_to_object(cJSON * const object, const char * const string, cJSON * const item, const internal_hooks * const hooks, const cJSON_bool constant_key)
 {
     char *new_key = NULL;
@@ -2165,6 +4983,30 @@ CJSON_PUBLIC(cJSON*) cJSON_AddNumberToObject(cJSON * const object, const char *
     return NULL;
 }
 
+CJSON_PUBLIC(cJSON*) cJSON_AddInt64ToObject(cJSON * const object, const char * const name, const int64_t number)
+{
+    cJSON *number_item = cJSON_CreateInt64(number);
+    if (add_item_to_object(object, name, number_item, &global_hooks, false))
+    {
+        return number_item;
+    }
+
+    cJSON_Delete(number_item);
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON*) cJSON_AddUint64ToObject(cJSON * const object, const char * const name, const uint64_t number)
+{
+    cJSON *number_item = cJSON_CreateUint64(number);
+    if (add_item_to_object(object, name, number_item, &global_hooks, false))
+    {
+        return number_item;
+    }
+
+    cJSON_Delete(number_item);
+    return NULL;
+}
+
 CJSON_PUBLIC(cJSON*) cJSON_AddStringToObject(cJSON * const object, const char * const name, const char * const string)
 {
     cJSON *string_item = cJSON_CreateString(string);
@@ -2220,6 +5062,7 @@ CJSON_PUBLIC(cJSON *) cJSON_DetachItemViaPointer(cJSON *parent, cJSON * const it
         return NULL;
     }
 
+    index_remove(parent, item);
     if (item != parent->child)
     {
         /* not the first element */
@@ -2245,6 +5088,7 @@ CJSON_PUBLIC(cJSON *) cJSON_DetachItemViaPointer(cJSON *parent, cJSON * const it
     /* make sure the detached item doesn't point anywhere anymore */
     item->prev = NULL;
     item->next = NULL;
+    index_sync(parent);
 
     return item;
 }
@@ -2320,6 +5164,7 @@ CJSON_PUBLIC(cJSON_bool) cJSON_InsertItemInArray(cJSON *array, int which, cJSON
     {
         newitem->prev->next = newitem;
     }
+    index_add(array, newitem);
     return true;
 }
 
@@ -2335,6 +5180,7 @@ CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON
         return true;
     }
 
+    index_remove(parent, item);
     replacement->next = item->next;
     replacement->prev = item->prev;
 
@@ -2365,6 +5211,8 @@ CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON
         }
     }
 
+    index_add(parent, replacement);
+
     item->next = NULL;
     item->prev = NULL;
     cJSON_Delete(item);
@@ -2486,6 +5334,30 @@ CJSON_PUBLIC(cJSON *) cJSON_CreateNumber(double num)
     return item;
 }
 
+CJSON_PUBLIC(cJSON *) cJSON_CreateInt64(int64_t num)
+{
+    cJSON *item = cJSON_CreateNumber((double)num);
+    if(item)
+    {
+        item->type |= cJSON_NumberIsInt64;
+        item->valueint64 = num;
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_CreateUint64(uint64_t num)
+{
+    cJSON *item = cJSON_CreateNumber((double)num);
+    if(item)
+    {
+        item->type |= (num <= (uint64_t)INT64_MAX) ? cJSON_NumberIsInt64 : cJSON_NumberIsUint64;
+        item->valueint64 = (num <= (uint64_t)INT64_MAX) ? (int64_t)num : int64_from_uint64(num);
+    }
+
+    return item;
+}
+
 CJSON_PUBLIC(cJSON *) cJSON_CreateString(const char *string)
 {
     cJSON *item = cJSON_New_Item(&global_hooks);
@@ -2611,6 +5483,7 @@ CJSON_PUBLIC(cJSON *) cJSON_CreateIntArray(const int *numbers, int count)
 
     if (a && a->child) {
         a->child->prev = n;
+        index_consider(a, NULL, &global_hooks);
     }
 
     return a;
@@ -2651,6 +5524,7 @@ CJSON_PUBLIC(cJSON *) cJSON_CreateFloatArray(const float *numbers, int count)
 
     if (a && a->child) {
         a->child->prev = n;
+        index_consider(a, NULL, &global_hooks);
     }
 
     return a;
@@ -2691,6 +5565,7 @@ CJSON_PUBLIC(cJSON *) cJSON_CreateDoubleArray(const double *numbers, int count)
 
     if (a && a->child) {
         a->child->prev = n;
+        index_consider(a, NULL, &global_hooks);
     }
 
     return a;
@@ -2731,6 +5606,7 @@ CJSON_PUBLIC(cJSON *) cJSON_CreateStringArray(const char *const *strings, int co
 
     if (a && a->child) {
         a->child->prev = n;
+        index_consider(a, NULL, &global_hooks);
     }
 
     return a;
@@ -2766,6 +5642,7 @@ cJSON * cJSON_Duplicate_rec(const cJSON *item, size_t depth, cJSON_bool recurse)
     newitem->type = item->type & (~cJSON_IsReference);
     newitem->valueint = item->valueint;
     newitem->valuedouble = item->valuedouble;
+    newitem->valueint64 = item->valueint64;
     if (item->valuestring)
     {
         newitem->valuestring = (char*)cJSON_strdup((unsigned char*)item->valuestring, &global_hooks);
@@ -2818,6 +5695,7 @@ cJSON * cJSON_Duplicate_rec(const cJSON *item, size_t depth, cJSON_bool recurse)
     {
         newitem->child->prev = newchild;
     }
+    index_consider(newitem, NULL, &global_hooks);
 
     return newitem;
 
@@ -2871,7 +5749,8 @@ static void minify_string(char **input, char **output) {
             *input += static_strlen("\"");
             *output += static_strlen("\"");
             return;
-        } else if (((*input)[0] == '\\') && ((*input)[1] == '\"')) {
+        } else if (((*input)[0] == '\\') && ((*input)[1] != '\0')) {
+            /* copy the escaped character as is, so "\\" does not escape the closing quote */
             (*output)[1] = (*input)[1];
             *input += static_strlen("\"");
             *output += static_strlen("\"");
@@ -3066,6 +5945,11 @@ CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * cons
             return true;
 
         case cJSON_Number:
+            /* exact integers are only equal to the same integer, the nearest doubles could match */
+            if ((number_is_int64(a) || number_is_uint64(a)) && (number_is_int64(b) || number_is_uint64(b)))
+            {
+                return ((a->type & cJSON_NumberIsInteger) == (b->type & cJSON_NumberIsInteger)) && (a->valueint64 == b->valueint64);
+            }
             if (compare_double(a->valuedouble, b->valuedouble))
             {
                 return true;
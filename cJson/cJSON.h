@@ -84,6 +84,7 @@ then using the CJSON_API_VISIBILITY flag to "export" the same symbols the way CJ
 #define CJSON_VERSION_PATCH 18
 
 #include <stddef.h>
+#include <stdint.h>
 
 /* cJSON Types: */
 #define cJSON_Invalid (0)
@@ -98,6 +99,9 @@ then using the CJSON_API_VISIBILITY flag to "export" the same symbols the way CJ
 
 #define cJSON_IsReference 256
 #define cJSON_StringIsConst 512
+/* Number flags: valueint64 holds the exact value, as an int64_t or as the bits of a uint64_t above INT64_MAX */
+#define cJSON_NumberIsInt64 1024
+#define cJSON_NumberIsUint64 2048
 
 /* The cJSON structure: */
 typedef struct cJSON
@@ -117,9 +121,15 @@ typedef struct cJSON
     int valueint;
     /* The item's number, if type==cJSON_Number */
     double valuedouble;
+    /* The exact integer if cJSON_NumberIsInt64 or cJSON_NumberIsUint64 is set, use cJSON_GetInt64Value/cJSON_GetUint64Value */
+    int64_t valueint64;
 
     /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
     char *string;
+
+    /* Private index of an array's or object's children once it has CJSON_INDEX_THRESHOLD of them. It is kept up to date by the
+     * cJSON_Add/Insert/Detach/Replace functions, so don't relink the children of such an item through next/prev/child. */
+    struct cJSON_Index *index;
 } cJSON;
 
 typedef struct cJSON_Hooks
@@ -129,6 +139,11 @@ typedef struct cJSON_Hooks
       void (CJSON_CDECL *free_fn)(void *ptr);
 } cJSON_Hooks;
 
+/* Region that cJSON_ParseInArena takes nodes and strings from, see below. */
+typedef struct cJSON_Arena cJSON_Arena;
+/* Shared object keys for cJSON_ParseWithKeyPool, see below. */
+typedef struct cJSON_KeyPool cJSON_KeyPool;
+
 typedef int cJSON_bool;
 
 /* Limits how deeply nested arrays/objects can be before cJSON rejects to parse them.
@@ -143,6 +158,13 @@ typedef int cJSON_bool;
 #define CJSON_CIRCULAR_LIMIT 10000
 #endif
 
+/* Arrays and objects with at least this many children get an index, built when they are parsed or grow to this size:
+ * a cached size and the children in order for arrays (cJSON_GetArraySize, cJSON_GetArrayItem), a hash table for
+ * objects (cJSON_GetObjectItem and friends). Below it walking the list is faster. */
+#ifndef CJSON_INDEX_THRESHOLD
+#define CJSON_INDEX_THRESHOLD 32
+#endif
+
 /* returns the version of cJSON as a string */
 CJSON_PUBLIC(const char*) cJSON_Version(void);
 
@@ -158,6 +180,26 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLength(const char *value, size_t buffer_len
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
 
+/* Arena parsing: all nodes and strings of the document are carved out of the arena instead of being allocated one by one.
+ * The document is released as a whole with cJSON_ResetArena (or cJSON_DeleteArena), which makes every document parsed into the arena invalid.
+ * Never pass such a document or any of its items to cJSON_Delete, or to functions that free parts of it (cJSON_DeleteItemFrom*, cJSON_Replace*, cJSON_SetValuestring).
+ * Reading, printing and cJSON_Duplicate (which allocates a regular tree) are fine. A failed parse gives its arena memory back. */
+/* Growable arena with a first block of initial_size bytes; further blocks come from the hooks and are kept for reuse across resets. */
+CJSON_PUBLIC(cJSON_Arena *) cJSON_CreateArena(size_t initial_size);
+/* Fixed arena that lives entirely in the caller's buffer, parsing fails once it is full. cJSON_DeleteArena frees nothing. */
+CJSON_PUBLIC(cJSON_Arena *) cJSON_CreateArenaInBuffer(void *buffer, size_t length);
+CJSON_PUBLIC(cJSON *) cJSON_ParseInArena(cJSON_Arena *arena, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena);
+CJSON_PUBLIC(void) cJSON_DeleteArena(cJSON_Arena *arena);
+
+/* Key interning: a regular parse, except that every object key is stored once in the pool and shared by all the items that use it,
+ * marked with cJSON_StringIsConst like cJSON_AddItemToObjectCS keys. Documents that repeat the same keys (arrays of records) save
+ * one allocation per key, and a key taken from one of these items is found by pointer in cJSON_GetObjectItem and friends.
+ * The pool only grows, it can be reused for any number of documents and has to outlive all of them, including their duplicates. */
+CJSON_PUBLIC(cJSON_KeyPool *) cJSON_CreateKeyPool(void);
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithKeyPool(cJSON_KeyPool *pool, const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
+CJSON_PUBLIC(void) cJSON_DeleteKeyPool(cJSON_KeyPool *pool);
+
 /* Render a cJSON entity to text for transfer/storage. */
 CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item);
 /* Render a cJSON entity to text for transfer/storage without any formatting. */
@@ -174,7 +216,7 @@ CJSON_PUBLIC(void) cJSON_Delete(cJSON *item);
 CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array);
 /* Retrieve item number "index" from array "array". Returns NULL if unsuccessful. */
 CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int index);
-/* Get item "string" from object. Case insensitive. */
+/* Get item "string" from object. Case insensitive (only ASCII letters are folded). */
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string);
@@ -184,6 +226,10 @@ CJSON_PUBLIC(const char *) cJSON_GetErrorPtr(void);
 /* Check item type and return its value */
 CJSON_PUBLIC(char *) cJSON_GetStringValue(const cJSON * const item);
 CJSON_PUBLIC(double) cJSON_GetNumberValue(const cJSON * const item);
+/* Exact integer value of a number: integer literals that fit 64 bits are kept exactly by the parser,
+ * other numbers have to be integral doubles in range. Returns false (and leaves value alone) otherwise. */
+CJSON_PUBLIC(cJSON_bool) cJSON_GetInt64Value(const cJSON * const item, int64_t * const value);
+CJSON_PUBLIC(cJSON_bool) cJSON_GetUint64Value(const cJSON * const item, uint64_t * const value);
 
 /* These functions check the type of an item */
 CJSON_PUBLIC(cJSON_bool) cJSON_IsInvalid(const cJSON * const item);
@@ -203,6 +249,9 @@ CJSON_PUBLIC(cJSON *) cJSON_CreateTrue(void);
 CJSON_PUBLIC(cJSON *) cJSON_CreateFalse(void);
 CJSON_PUBLIC(cJSON *) cJSON_CreateBool(cJSON_bool boolean);
 CJSON_PUBLIC(cJSON *) cJSON_CreateNumber(double num);
+/* integers that are printed exactly, valuedouble holds the nearest double */
+CJSON_PUBLIC(cJSON *) cJSON_CreateInt64(int64_t num);
+CJSON_PUBLIC(cJSON *) cJSON_CreateUint64(uint64_t num);
 CJSON_PUBLIC(cJSON *) cJSON_CreateString(const char *string);
 /* raw json */
 CJSON_PUBLIC(cJSON *) cJSON_CreateRaw(const char *raw);
@@ -272,6 +321,8 @@ CJSON_PUBLIC(cJSON*) cJSON_AddTrueToObject(cJSON * const object, const char * co
 CJSON_PUBLIC(cJSON*) cJSON_AddFalseToObject(cJSON * const object, const char * const name);
 CJSON_PUBLIC(cJSON*) cJSON_AddBoolToObject(cJSON * const object, const char * const name, const cJSON_bool boolean);
 CJSON_PUBLIC(cJSON*) cJSON_AddNumberToObject(cJSON * const object, const char * const name, const double number);
+CJSON_PUBLIC(cJSON*) cJSON_AddInt64ToObject(cJSON * const object, const char * const name, const int64_t number);
+CJSON_PUBLIC(cJSON*) cJSON_AddUint64ToObject(cJSON * const object, const char * const name, const uint64_t number);
 CJSON_PUBLIC(cJSON*) cJSON_AddStringToObject(cJSON * const object, const char * const name, const char * const string);
 CJSON_PUBLIC(cJSON*) cJSON_AddRawToObject(cJSON * const object, const char * const name, const char * const raw);
 CJSON_PUBLIC(cJSON*) cJSON_AddObjectToObject(cJSON * const object, const char * const name);
@@ -0,0 +1,458 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/*
+ * Parse/print throughput benchmark for cJSON.
+ *
+ * Builds synthetic documents, renders them with cJSON_Print (indented) and
+ * cJSON_PrintUnformatted, and times parsing and printing them back.
+ * Compare a build with and without -DCJSON_DISABLE_SIMD to see what the
+ * vector kernels are worth:
+ *
+ *   cc -O2 cjson_bench.c cJSON.c -o cjson_bench
+ *   cc -O2 -DCJSON_DISABLE_SIMD cjson_bench.c cJSON.c -o cjson_bench_scalar
+ *   ./cjson_bench [seconds per case]
+ *
+ * "parse arena" parses the same text with cJSON_ParseInArena, without malloc/free,
+ * "parse keys" with cJSON_ParseWithKeyPool, which shares the object keys.
+ * "lookup" fetches every key of an object and "iterate" every element of an array by position,
+ * -DCJSON_INDEX_THRESHOLD=1000000 turns the indexes off.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cJSON.h"
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* records nested a few levels deep, so cJSON_Print emits several tabs of indentation per line */
+static cJSON *make_records(int count)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON *records = cJSON_AddArrayToObject(root, "records");
+    int i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        char name[32];
+        cJSON *record = cJSON_CreateObject();
+        cJSON *owner = cJSON_AddObjectToObject(record, "owner");
+        cJSON *address = cJSON_AddObjectToObject(owner, "address");
+        cJSON *tags = cJSON_AddArrayToObject(record, "tags");
+
+        sprintf(name, "record-%d", i);
+        cJSON_AddNumberToObject(record, "id", i);
+        cJSON_AddStringToObject(record, "name", name);
+        cJSON_AddBoolToObject(record, "active", i % 3 != 0);
+        cJSON_AddNumberToObject(record, "score", i * 0.25);
+        cJSON_AddStringToObject(owner, "login", "someone");
+        cJSON_AddNumberToObject(owner, "uid", 1000 + i);
+        cJSON_AddStringToObject(address, "city", "Belo Horizonte");
+        cJSON_AddStringToObject(address, "zip", "31270-901");
+        cJSON_AddItemToArray(tags, cJSON_CreateString("alpha"));
+        cJSON_AddItemToArray(tags, cJSON_CreateString("beta"));
+        cJSON_AddItemToArray(records, record);
+    }
+
+    return root;
+}
+
+/* best of a few runs, the first ones pay for page faults and frequency ramp-up */
+#define BENCH_RUNS 5
+
+static void report(const char *what, const char *label, size_t length, long rounds, double best)
+{
+    printf("%-12s %-20s %8lu bytes %9.1f us/doc %8.1f MB/s\n", what, label, (unsigned long)length, best * 1e6 / (double)rounds, (double)length * (double)rounds / best / 1e6);
+}
+
+static void bench_parse(const char *label, const char *text, double seconds)
+{
+    size_t length = strlen(text);
+    long rounds = 0;
+    long round = 0;
+    int run = 0;
+    double best = 0;
+    double start = now();
+    cJSON_Arena *arena = cJSON_CreateArena(length * 4);
+    cJSON_KeyPool *keys = cJSON_CreateKeyPool();
+
+    /* calibrate the rounds per run on the heap parser */
+    do
+    {
+        cJSON *json = cJSON_ParseWithLength(text, length);
+        if (json == NULL)
+        {
+            fprintf(stderr, "%s: parse failed\n", label);
+            exit(EXIT_FAILURE);
+        }
+        cJSON_Delete(json);
+        rounds++;
+    } while ((now() - start) < (seconds / BENCH_RUNS));
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        double elapsed = 0;
+        start = now();
+        for (round = 0; round < rounds; round++)
+        {
+            cJSON_Delete(cJSON_ParseWithLength(text, length));
+        }
+        elapsed = now() - start;
+        if ((run == 0) || (elapsed < best))
+        {
+            best = elapsed;
+        }
+    }
+    report("parse", label, length, rounds, best);
+
+    /* the arena takes malloc/free out, which leaves the scanning loops */
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        double elapsed = 0;
+        start = now();
+        for (round = 0; round < rounds; round++)
+        {
+            cJSON_ResetArena(arena);
+            if (cJSON_ParseInArena(arena, text, length, NULL, 0) == NULL)
+            {
+                fprintf(stderr, "%s: arena parse failed\n", label);
+                exit(EXIT_FAILURE);
+            }
+        }
+        elapsed = now() - start;
+        if ((run == 0) || (elapsed < best))
+        {
+            best = elapsed;
+        }
+    }
+    report("parse arena", label, length, rounds, best);
+
+    /* interned keys save the allocation of every repeated key, the pool is warm after the first document */
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        double elapsed = 0;
+        start = now();
+        for (round = 0; round < rounds; round++)
+        {
+            cJSON_Delete(cJSON_ParseWithKeyPool(keys, text, length, NULL, 0));
+        }
+        elapsed = now() - start;
+        if ((run == 0) || (elapsed < best))
+        {
+            best = elapsed;
+        }
+    }
+    report("parse keys", label, length, rounds, best);
+
+    cJSON_DeleteArena(arena);
+    cJSON_DeleteKeyPool(keys);
+}
+
+static void bench_print(const char *label, const cJSON *json, cJSON_bool format, double seconds)
+{
+    char *text = format ? cJSON_Print(json) : cJSON_PrintUnformatted(json);
+    size_t length = strlen(text);
+    long rounds = 0;
+    long round = 0;
+    int run = 0;
+    double best = 0;
+    double start = now();
+
+    cJSON_free(text);
+    do
+    {
+        cJSON_free(format ? cJSON_Print(json) : cJSON_PrintUnformatted(json));
+        rounds++;
+    } while ((now() - start) < (seconds / BENCH_RUNS));
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        double elapsed = 0;
+        start = now();
+        for (round = 0; round < rounds; round++)
+        {
+            cJSON_free(format ? cJSON_Print(json) : cJSON_PrintUnformatted(json));
+        }
+        elapsed = now() - start;
+        if ((run == 0) || (elapsed < best))
+        {
+            best = elapsed;
+        }
+    }
+    report("print", label, length, rounds, best);
+}
+
+/* look up every key of a wide object, with and without case sensitivity */
+static void bench_lookup(const char *label, const cJSON *object, double seconds)
+{
+    size_t count = (size_t)cJSON_GetArraySize(object);
+    const char **keys = (const char**)malloc(count * sizeof(char*));
+    const cJSON *child = NULL;
+    long rounds = 0;
+    long round = 0;
+    int run = 0;
+    double best = 0;
+    double start = 0;
+    size_t i = 0;
+    int sensitive = 0;
+
+    if (keys == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+    for (child = object->child; child != NULL; child = child->next)
+    {
+        keys[i++] = child->string;
+    }
+
+    for (sensitive = 1; sensitive >= 0; sensitive--)
+    {
+        rounds = 0;
+        start = now();
+        do
+        {
+            for (i = 0; i < count; i++)
+            {
+                if ((sensitive ? cJSON_GetObjectItemCaseSensitive(object, keys[i]) : cJSON_GetObjectItem(object, keys[i])) == NULL)
+                {
+                    fprintf(stderr, "%s: key %s not found\n", label, keys[i]);
+                    exit(EXIT_FAILURE);
+                }
+            }
+            rounds++;
+        } while ((now() - start) < (seconds / BENCH_RUNS));
+
+        for (run = 0; run < BENCH_RUNS; run++)
+        {
+            double elapsed = 0;
+            start = now();
+            for (round = 0; round < rounds; round++)
+            {
+                for (i = 0; i < count; i++)
+                {
+                    if (sensitive)
+                    {
+                        cJSON_GetObjectItemCaseSensitive(object, keys[i]);
+                    }
+                    else
+                    {
+                        cJSON_GetObjectItem(object, keys[i]);
+                    }
+                }
+            }
+            elapsed = now() - start;
+            if ((run == 0) || (elapsed < best))
+            {
+                best = elapsed;
+            }
+        }
+        printf("%-12s %-20s %8lu keys  %9.1f ns/lookup\n", sensitive ? "lookup" : "lookup icase", label, (unsigned long)count, best * 1e9 / (double)rounds / (double)count);
+    }
+
+    free(keys);
+}
+
+/* the for (i = 0; i < cJSON_GetArraySize(array); i++) cJSON_GetArrayItem(array, i) loop */
+static void bench_iterate(const char *label, const cJSON *array, double seconds)
+{
+    long rounds = 0;
+    long round = 0;
+    int run = 0;
+    int i = 0;
+    double best = 0;
+    double sum = 0;
+    double start = now();
+
+    do
+    {
+        for (i = 0; i < cJSON_GetArraySize(array); i++)
+        {
+            sum += cJSON_GetArrayItem(array, i)->valuedouble;
+        }
+        rounds++;
+    } while ((now() - start) < (seconds / BENCH_RUNS));
+
+    for (run = 0; run < BENCH_RUNS; run++)
+    {
+        double elapsed = 0;
+        start = now();
+        for (round = 0; round < rounds; round++)
+        {
+            for (i = 0; i < cJSON_GetArraySize(array); i++)
+            {
+                sum += cJSON_GetArrayItem(array, i)->valuedouble;
+            }
+        }
+        elapsed = now() - start;
+        if ((run == 0) || (elapsed < best))
+        {
+            best = elapsed;
+        }
+    }
+    printf("%-12s %-20s %8d items %9.1f ns/item (%g)\n", "iterate", label, cJSON_GetArraySize(array), best * 1e9 / (double)rounds / (double)cJSON_GetArraySize(array), sum > 0 ? 1.0 : 0.0);
+}
+
+/* a chain of objects depth levels deep, the indentation grows by one tab per level */
+static cJSON *make_nested(int depth, int width)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON *level = root;
+    int i = 0;
+    int j = 0;
+
+    for (i = 0; i < depth; i++)
+    {
+        for (j = 0; j < width; j++)
+        {
+            char key[16];
+            sprintf(key, "k%d", j);
+            cJSON_AddNumberToObject(level, key, j);
+        }
+        level = cJSON_AddObjectToObject(level, "next");
+    }
+
+    return root;
+}
+
+/* an array of longer texts, one in eight with escapes (quotes, newlines, non-ASCII) */
+static cJSON *make_texts(int count)
+{
+    static const char clean[] = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation.";
+    static const char escaped[] = "He said \"ok\"\nthen left\tfor S\xc3\xa3o Paulo; Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor.";
+    cJSON *root = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        cJSON_AddItemToArray(root, cJSON_CreateString(((i % 8) == 7) ? escaped : clean));
+    }
+
+    return root;
+}
+
+/* GeoJSON-like coordinate pairs with seven decimals */
+static cJSON *make_coordinates(int count)
+{
+    cJSON *root = cJSON_CreateArray();
+    int i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        double pair[2];
+        pair[0] = -122.4194155 + (double)(i % 1000) * 0.0001237;
+        pair[1] = 37.7749295 - (double)(i % 777) * 0.0000913;
+        cJSON_AddItemToArray(root, cJSON_CreateDoubleArray(pair, 2));
+    }
+
+    return root;
+}
+
+/* 64-bit identifiers as in snowflake/database ids, beyond what a double holds exactly */
+static cJSON *make_ids(int count)
+{
+    cJSON *root = cJSON_CreateArray();
+    uint64_t id = UINT64_C(1450000000000000000);
+    int i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        cJSON *entry = cJSON_CreateObject();
+        id += (uint64_t)(i % 97) * UINT64_C(4194304) + 1;
+        cJSON_AddUint64ToObject(entry, "id", id);
+        cJSON_AddUint64ToObject(entry, "parent", id - UINT64_C(12345678901));
+        cJSON_AddInt64ToObject(entry, "offset", (int64_t)(i * 7919) - 5000000);
+        cJSON_AddItemToArray(root, entry);
+    }
+
+    return root;
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = (argc > 1) ? atof(argv[1]) : 1.0;
+    cJSON *records = make_records(2000);
+    cJSON *nested = make_nested(64, 40);
+    cJSON *texts = make_texts(4000);
+    cJSON *coordinates = make_coordinates(20000);
+    cJSON *ids = make_ids(10000);
+    cJSON *wide = make_nested(1, 5000);
+    cJSON *small = make_nested(1, 16);
+    cJSON *values = cJSON_CreateArray();
+    int i = 0;
+    char *indented = cJSON_Print(records);
+    char *compact = cJSON_PrintUnformatted(records);
+    char *deep = cJSON_Print(nested);
+    char *strings = cJSON_PrintUnformatted(texts);
+    char *numbers = cJSON_PrintUnformatted(coordinates);
+    char *identifiers = cJSON_PrintUnformatted(ids);
+
+    for (i = 0; i < 20000; i++)
+    {
+        cJSON_AddItemToArray(values, cJSON_CreateNumber(i));
+    }
+
+    if ((indented == NULL) || (compact == NULL) || (deep == NULL) || (strings == NULL) || (numbers == NULL) || (identifiers == NULL))
+    {
+        return EXIT_FAILURE;
+    }
+
+    bench_parse("records indented", indented, seconds);
+    bench_parse("records compact", compact, seconds);
+    bench_parse("nested indented", deep, seconds);
+    bench_parse("texts", strings, seconds);
+    bench_parse("coordinates", numbers, seconds);
+    bench_parse("ids", identifiers, seconds);
+    bench_print("records indented", records, 1, seconds);
+    bench_print("records compact", records, 0, seconds);
+    bench_print("texts", texts, 0, seconds);
+    bench_print("coordinates", coordinates, 0, seconds);
+    bench_print("ids", ids, 0, seconds);
+    bench_lookup("wide object", wide, seconds);
+    bench_lookup("small object", small, seconds);
+    bench_iterate("array", values, seconds);
+
+    cJSON_free(indented);
+    cJSON_free(compact);
+    cJSON_free(deep);
+    cJSON_free(strings);
+    cJSON_free(numbers);
+    cJSON_free(identifiers);
+    cJSON_Delete(records);
+    cJSON_Delete(nested);
+    cJSON_Delete(texts);
+    cJSON_Delete(coordinates);
+    cJSON_Delete(ids);
+    cJSON_Delete(wide);
+    cJSON_Delete(small);
+    cJSON_Delete(values);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,426 @@
+/*
+  Copyright (c) 2009-2017 Dave Gamble and cJSON contributors
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/*
+ * Round-trip fuzzer for cJSON.
+ *
+ * Every input is parsed with cJSON_ParseWithLengthOpts and, if it parses, printed
+ * (allocated and preallocated, formatted and unformatted), parsed again into a
+ * cJSON_Arena and with a cJSON_KeyPool, duplicated, compared against the duplicate,
+ * printed again after a reparse and minified. The first byte selects the options, the rest is the JSON text.
+ *
+ * All allocations go through cJSON_InitHooks into a bump arena that is reset
+ * before every input, so malloc/free do not dominate the execution time. When
+ * built with AddressSanitizer, the arena poisons everything that is not a live
+ * allocation, so overflows and use-after-free inside cJSON are still reported.
+ *
+ * libFuzzer / OSS-Fuzz:
+ *   $CC $CFLAGS cjson_fuzzer.c cJSON.c $LIB_FUZZING_ENGINE -o cjson_fuzzer
+ * AFL++ persistent mode:
+ *   afl-clang-fast -DCJSON_FUZZ_STANDALONE cjson_fuzzer.c cJSON.c -o cjson_fuzzer
+ * Standalone (replays files, reports exec/s):
+ *   cc -O1 -g -fsanitize=address,undefined -DCJSON_FUZZ_STANDALONE cjson_fuzzer.c cJSON.c -o cjson_fuzzer
+ *   ./cjson_fuzzer [-iterations N] corpus_file...
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "cJSON.h"
+
+#if defined(__SANITIZE_ADDRESS__)
+#define ARENA_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ARENA_ASAN 1
+#endif
+#endif
+
+#ifdef ARENA_ASAN
+#include <sanitizer/asan_interface.h>
+#define ARENA_POISON(pointer, size) ASAN_POISON_MEMORY_REGION((pointer), (size))
+#define ARENA_UNPOISON(pointer, size) ASAN_UNPOISON_MEMORY_REGION((pointer), (size))
+#else
+#define ARENA_POISON(pointer, size) ((void)0)
+#define ARENA_UNPOISON(pointer, size) ((void)0)
+#endif
+
+#define ARENA_SIZE (64 * 1024 * 1024)
+#define ARENA_ALIGNMENT 16
+/* every block is preceded by a header holding its size; it doubles as a redzone */
+#define ARENA_HEADER ARENA_ALIGNMENT
+
+/* option bits taken from the first input byte */
+#define OPTION_NULL_TERMINATED 0x01
+#define OPTION_FORMAT 0x02
+
+static unsigned char *arena = NULL;
+static size_t arena_used = 0;
+
+static void arena_reset(void)
+{
+    if (arena == NULL)
+    {
+        arena = (unsigned char*)malloc(ARENA_SIZE);
+        if (arena == NULL)
+        {
+            abort();
+        }
+        ARENA_POISON(arena, ARENA_SIZE);
+    }
+    /* only the part handed out since the last reset can be unpoisoned */
+    ARENA_POISON(arena, arena_used);
+    arena_used = 0;
+}
+
+static void *arena_malloc(size_t size)
+{
+    size_t rounded = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    unsigned char *block = NULL;
+
+    if ((rounded < size) || (rounded > (ARENA_SIZE - arena_used - ARENA_HEADER)))
+    {
+        return NULL;
+    }
+    block = arena + arena_used + ARENA_HEADER;
+    arena_used += ARENA_HEADER + rounded;
+
+    ARENA_UNPOISON(block - ARENA_HEADER, sizeof(size_t));
+    memcpy(block - ARENA_HEADER, &size, sizeof(size_t));
+    ARENA_POISON(block - ARENA_HEADER, sizeof(size_t));
+    ARENA_UNPOISON(block, size);
+
+    return block;
+}
+
+static void arena_free(void *pointer)
+{
+    /* memory is only reclaimed by arena_reset, freed blocks just become poisoned */
+#ifdef ARENA_ASAN
+    unsigned char *block = (unsigned char*)pointer;
+    size_t size = 0;
+
+    if (block == NULL)
+    {
+        return;
+    }
+    ARENA_UNPOISON(block - ARENA_HEADER, sizeof(size_t));
+    memcpy(&size, block - ARENA_HEADER, sizeof(size_t));
+    ARENA_POISON(block - ARENA_HEADER, sizeof(size_t));
+    ARENA_POISON(block, size);
+#else
+    (void)pointer;
+#endif
+}
+
+static void check(int condition)
+{
+    if (!condition)
+    {
+        abort();
+    }
+}
+
+/* print item into an exactly sized heap buffer, so ASan sees overflows past the advertised length */
+static void check_preallocated(cJSON *item, const char *expected, cJSON_bool format)
+{
+    size_t length = strlen(expected);
+    /* cJSON_PrintPreallocated wants 5 bytes of slack over the printed length */
+    char *buffer = (char*)malloc(length + 5);
+    check(buffer != NULL);
+    check(cJSON_PrintPreallocated(item, buffer, (int)length + 5, format));
+    check(strcmp(buffer, expected) == 0);
+    free(buffer);
+
+    /* a buffer that is too small has to be rejected without writing past its end */
+    if (length > 1)
+    {
+        buffer = (char*)malloc(length / 2);
+        check(buffer != NULL);
+        check(!cJSON_PrintPreallocated(item, buffer, (int)(length / 2), format));
+        free(buffer);
+    }
+}
+
+/* whether any object in the tree has two members with the same name */
+static cJSON_bool has_duplicate_keys(const cJSON *item)
+{
+    const cJSON *child = NULL;
+    const cJSON *other = NULL;
+
+    for (child = (item != NULL) ? item->child : NULL; child != NULL; child = child->next)
+    {
+        if (cJSON_IsObject(item) && (child->string != NULL))
+        {
+            for (other = child->next; other != NULL; other = other->next)
+            {
+                if ((other->string != NULL) && (strcmp(child->string, other->string) == 0))
+                {
+                    return 1;
+                }
+            }
+        }
+        if (has_duplicate_keys(child))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size); /* required by C89 */
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static int hooks_installed = 0;
+    cJSON *json = NULL;
+    cJSON *copy = NULL;
+    cJSON *reparsed = NULL;
+    cJSON_Arena *arena_parse = NULL;
+    cJSON_KeyPool *key_pool = NULL;
+    const char *parse_end = NULL;
+    char *text = NULL;
+    char *printed = NULL;
+    char *reprinted = NULL;
+    unsigned char options = 0;
+    size_t length = 0;
+
+    if (!hooks_installed)
+    {
+        cJSON_Hooks hooks;
+        hooks.malloc_fn = arena_malloc;
+        hooks.free_fn = arena_free;
+        cJSON_InitHooks(&hooks);
+        hooks_installed = 1;
+    }
+    if (size < 1)
+    {
+        return 0;
+    }
+    arena_reset();
+
+    options = data[0];
+    length = size - 1;
+    if ((length == 0) && !(options & OPTION_NULL_TERMINATED))
+    {
+        /* nothing to parse, and a zero sized block would have no readable byte to hand out */
+        return 0;
+    }
+    /*
+     * an exact copy, so a read one byte past the given length lands in poisoned memory;
+     * only require_null_terminated gets the extra byte, holding the terminator it needs to see
+     */
+    text = (char*)arena_malloc((options & OPTION_NULL_TERMINATED) ? length + 1 : length);
+    if (text == NULL)
+    {
+        return 0;
+    }
+    memcpy(text, data + 1, length);
+    if (options & OPTION_NULL_TERMINATED)
+    {
+        text[length] = '\0';
+        length++;
+    }
+
+    json = cJSON_ParseWithLengthOpts(text, length, &parse_end, (options & OPTION_NULL_TERMINATED) != 0);
+    if (json == NULL)
+    {
+        return 0;
+    }
+    check((parse_end >= text) && (parse_end <= text + length));
+
+    printed = (options & OPTION_FORMAT) ? cJSON_Print(json) : cJSON_PrintUnformatted(json);
+    if (printed == NULL)
+    {
+        /* only possible when the arena is exhausted */
+        return 0;
+    }
+    check_preallocated(json, printed, (options & OPTION_FORMAT) != 0);
+
+    /* a document parsed into a cJSON arena has to be the same as the regular one */
+    arena_parse = cJSON_CreateArena(64);
+    if (arena_parse != NULL)
+    {
+        cJSON *arena_json = cJSON_ParseInArena(arena_parse, text, length, NULL, (options & OPTION_NULL_TERMINATED) != 0);
+        if (arena_json != NULL)
+        {
+            reprinted = (options & OPTION_FORMAT) ? cJSON_Print(arena_json) : cJSON_PrintUnformatted(arena_json);
+            check((reprinted == NULL) || (strcmp(printed, reprinted) == 0));
+        }
+        cJSON_DeleteArena(arena_parse);
+    }
+
+    /* and so does one with interned keys */
+    key_pool = cJSON_CreateKeyPool();
+    if (key_pool != NULL)
+    {
+        cJSON *pooled_json = cJSON_ParseWithKeyPool(key_pool, text, length, NULL, (options & OPTION_NULL_TERMINATED) != 0);
+        if (pooled_json != NULL)
+        {
+            reprinted = (options & OPTION_FORMAT) ? cJSON_Print(pooled_json) : cJSON_PrintUnformatted(pooled_json);
+            check((reprinted == NULL) || (strcmp(printed, reprinted) == 0));
+            cJSON_Delete(pooled_json);
+        }
+        cJSON_DeleteKeyPool(key_pool);
+    }
+
+    /* the duplicate has to print exactly like the original */
+    copy = cJSON_Duplicate(json, 1);
+    if (copy != NULL)
+    {
+        reprinted = (options & OPTION_FORMAT) ? cJSON_Print(copy) : cJSON_PrintUnformatted(copy);
+        check((reprinted == NULL) || (strcmp(printed, reprinted) == 0));
+    }
+
+    /* printing is idempotent after one round trip (non-finite numbers become null on the first print) */
+    reparsed = cJSON_Parse(printed);
+    check(reparsed != NULL);
+    reprinted = (options & OPTION_FORMAT) ? cJSON_Print(reparsed) : cJSON_PrintUnformatted(reparsed);
+    if (reprinted != NULL)
+    {
+        check(strcmp(printed, reprinted) == 0);
+    }
+    /*
+     * cJSON_Compare is only an equivalence on the reparsed tree: NaN and infinities never
+     * compare equal, and case insensitive lookups mix up keys like "a" and "A".
+     * It looks members up by name, so an object with a repeated name ({"k":1,"k":2})
+     * never equals itself and is left out.
+     */
+    cJSON_Delete(copy);
+    copy = cJSON_Duplicate(reparsed, 1);
+    if ((copy != NULL) && !has_duplicate_keys(reparsed))
+    {
+        check(cJSON_Compare(reparsed, copy, 1));
+        check(cJSON_Compare(copy, reparsed, 1));
+    }
+
+    /* minify works in place on a terminated string; the minified text must parse to the same tree */
+    cJSON_Minify(printed);
+    cJSON_Delete(reparsed);
+    reparsed = cJSON_Parse(printed);
+    check(reparsed != NULL);
+    reprinted = cJSON_PrintUnformatted(reparsed);
+    if (reprinted != NULL)
+    {
+        check(strcmp(printed, reprinted) == 0);
+    }
+
+    cJSON_Delete(reparsed);
+    cJSON_Delete(copy);
+    cJSON_Delete(json);
+    return 0;
+}
+
+#ifdef CJSON_FUZZ_STANDALONE
+#include <time.h>
+
+#ifdef __AFL_FUZZ_TESTCASE_LEN
+__AFL_FUZZ_INIT();
+#endif
+
+int main(int argc, char **argv)
+{
+    long iterations = 1;
+    long execs = 0;
+    long round = 0;
+    int first_file = 1;
+    int i = 0;
+    uint8_t **inputs = NULL;
+    size_t *sizes = NULL;
+    clock_t start;
+    double seconds = 0;
+
+#ifdef __AFL_FUZZ_TESTCASE_LEN
+    /* AFL++ persistent mode: many inputs per process, no fork per execution */
+    __AFL_INIT();
+    {
+        unsigned char *afl_data = __AFL_FUZZ_TESTCASE_BUF;
+        while (__AFL_LOOP(100000))
+        {
+            LLVMFuzzerTestOneInput(afl_data, (size_t)__AFL_FUZZ_TESTCASE_LEN);
+        }
+    }
+    return 0;
+#endif
+
+    if ((argc > 2) && (strcmp(argv[1], "-iterations") == 0))
+    {
+        iterations = atol(argv[2]);
+        first_file = 3;
+    }
+    if (first_file >= argc)
+    {
+        fprintf(stderr, "usage: %s [-iterations N] file...\n", argv[0]);
+        return 1;
+    }
+
+    /* load every input up front, so only the target itself is timed */
+    inputs = (uint8_t**)calloc((size_t)argc, sizeof(uint8_t*));
+    sizes = (size_t*)calloc((size_t)argc, sizeof(size_t));
+    if ((inputs == NULL) || (sizes == NULL))
+    {
+        return 1;
+    }
+    for (i = first_file; i < argc; i++)
+    {
+        long size = 0;
+        FILE *file = fopen(argv[i], "rb");
+        if ((file == NULL) || (fseek(file, 0, SEEK_END) != 0) || ((size = ftell(file)) < 0))
+        {
+            perror(argv[i]);
+            return 1;
+        }
+        rewind(file);
+        inputs[i] = (uint8_t*)malloc((size_t)size + 1);
+        if ((inputs[i] == NULL) || (fread(inputs[i], 1, (size_t)size, file) != (size_t)size))
+        {
+            perror(argv[i]);
+            return 1;
+        }
+        sizes[i] = (size_t)size;
+        fclose(file);
+    }
+
+    start = clock();
+    for (round = 0; round < iterations; round++)
+    {
+        for (i = first_file; i < argc; i++)
+        {
+            LLVMFuzzerTestOneInput(inputs[i], sizes[i]);
+            execs++;
+        }
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%ld execs in %.2f s (%.0f exec/s)\n", execs, seconds, (seconds > 0) ? (double)execs / seconds : 0.0);
+
+    for (i = first_file; i < argc; i++)
+    {
+        free(inputs[i]);
+    }
+    free(inputs);
+    free(sizes);
+    return 0;
+}
+#endif